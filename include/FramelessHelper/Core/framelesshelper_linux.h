@@ -120,6 +120,27 @@ using xcb_button_press_event_t = struct xcb_button_press_event_t
 };
 using xcb_button_release_event_t = xcb_button_press_event_t;
 
+using xcb_generic_event_t = struct xcb_generic_event_t
+{
+    uint8_t response_type;
+    uint8_t pad0;
+    uint16_t sequence;
+    uint32_t pad[7];
+    uint32_t full_sequence;
+};
+
+using xcb_property_notify_event_t = struct xcb_property_notify_event_t
+{
+    uint8_t response_type;
+    uint8_t pad0;
+    uint16_t sequence;
+    xcb_window_t window;
+    xcb_atom_t atom;
+    xcb_timestamp_t time;
+    uint8_t state;
+    uint8_t pad1[3];
+};
+
 using xcb_void_cookie_t = struct xcb_void_cookie_t
 {
     unsigned int sequence;
@@ -193,6 +214,9 @@ using xcb_list_properties_reply_t = struct xcb_list_properties_reply_t
 [[maybe_unused]] inline constexpr const auto XCB_BUTTON_INDEX_2 = 2;
 [[maybe_unused]] inline constexpr const auto XCB_BUTTON_INDEX_3 = 3;
 [[maybe_unused]] inline constexpr const auto XCB_BUTTON_RELEASE = 5;
+[[maybe_unused]] inline constexpr const auto XCB_PROPERTY_NEW_VALUE = 0;
+[[maybe_unused]] inline constexpr const auto XCB_PROPERTY_DELETE = 1;
+[[maybe_unused]] inline constexpr const auto XCB_PROPERTY_NOTIFY = 28;
 [[maybe_unused]] inline constexpr const auto XCB_CLIENT_MESSAGE = 33;
 [[maybe_unused]] inline constexpr const auto XCB_EVENT_MASK_STRUCTURE_NOTIFY = 131072;
 [[maybe_unused]] inline constexpr const auto XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT = 1048576;
@@ -215,6 +239,7 @@ using xcb_list_properties_reply_t = struct xcb_list_properties_reply_t
 [[maybe_unused]] inline constexpr const char ATOM_NET_SUPPORTED[] = "_NET_SUPPORTED";
 [[maybe_unused]] inline constexpr const char ATOM_NET_WM_NAME[] = "_NET_WM_NAME";
 [[maybe_unused]] inline constexpr const char ATOM_NET_WM_MOVERESIZE[] = "_NET_WM_MOVERESIZE";
+[[maybe_unused]] inline constexpr const char ATOM_GTK_FRAME_EXTENTS[] = "_GTK_FRAME_EXTENTS";
 [[maybe_unused]] inline constexpr const char ATOM_NET_SUPPORTING_WM_CHECK[] = "_NET_SUPPORTING_WM_CHECK";
 [[maybe_unused]] inline constexpr const char ATOM_NET_KDE_COMPOSITE_TOGGLING[] = "_NET_KDE_COMPOSITE_TOGGLING";
 [[maybe_unused]] inline constexpr const char ATOM_KDE_NET_WM_BLUR_BEHIND_REGION[] = "_KDE_NET_WM_BLUR_BEHIND_REGION";
@@ -224,6 +249,12 @@ using xcb_list_properties_reply_t = struct xcb_list_properties_reply_t
 [[maybe_unused]] inline constexpr const char ATOM_NET_WM_DEEPIN_BLUR_REGION_MASK[] = "_NET_WM_DEEPIN_BLUR_REGION_MASK";
 [[maybe_unused]] inline constexpr const char ATOM_NET_WM_DEEPIN_BLUR_REGION_ROUNDED[] = "_NET_WM_DEEPIN_BLUR_REGION_ROUNDED";
 [[maybe_unused]] inline constexpr const char ATOM_UTF8_STRING[] = "UTF8_STRING";
+[[maybe_unused]] inline constexpr const char ATOM_NET_WM_STATE[] = "_NET_WM_STATE";
+[[maybe_unused]] inline constexpr const char ATOM_NET_WM_STATE_MAXIMIZED_VERT[] = "_NET_WM_STATE_MAXIMIZED_VERT";
+[[maybe_unused]] inline constexpr const char ATOM_NET_WM_STATE_MAXIMIZED_HORZ[] = "_NET_WM_STATE_MAXIMIZED_HORZ";
+[[maybe_unused]] inline constexpr const char ATOM_NET_WM_STATE_FULLSCREEN[] = "_NET_WM_STATE_FULLSCREEN";
+[[maybe_unused]] inline constexpr const char ATOM_NET_WM_STATE_HIDDEN[] = "_NET_WM_STATE_HIDDEN";
+[[maybe_unused]] inline constexpr const char ATOM_NET_FRAME_EXTENTS[] = "_NET_FRAME_EXTENTS";
 
 #ifndef FRAMELESSHELPER_HAS_XCB
 extern "C"
@@ -34,6 +34,7 @@
 #include <QtCore/qpointer.h>
 #include <QtGui/qcolor.h>
 #include <QtGui/qwindowdefs.h>
+#include <functional>
 
 QT_BEGIN_NAMESPACE
 class QEvent;
@@ -362,6 +363,9 @@ Q_NAMESPACE_EXPORT(FRAMELESSHELPER_CORE_API)
 [[maybe_unused]] inline constexpr const int kDefaultTitleBarHeight = 32;
 [[maybe_unused]] inline constexpr const int kDefaultExtendedTitleBarHeight = 48;
 [[maybe_unused]] inline constexpr const int kDefaultWindowFrameBorderThickness = 1;
+[[maybe_unused]] inline constexpr const int kDefaultWindowCornerRadius = 8;
+[[maybe_unused]] inline constexpr const int kDefaultWindowShadowBlurRadius = 16;
+[[maybe_unused]] inline constexpr const QPoint kDefaultWindowShadowOffset = {0, 4};
 [[maybe_unused]] inline constexpr const int kDefaultTitleBarFontPointSize = 11;
 [[maybe_unused]] inline constexpr const int kDefaultTitleBarContentsMargin = 10;
 [[maybe_unused]] inline constexpr const int kMacOSChromeButtonAreaWidth = 60;
@@ -423,7 +427,10 @@ enum class Option : quint8
     DisableLazyInitializationForMicaMaterial,
     ForceNativeBackgroundBlur,
     WindowUseSquareCorners,
-    Last = WindowUseSquareCorners
+    EnableClientSideShadow,
+    EnableMouseMoveCompression,
+    EnablePerformanceOverlay,
+    Last = EnablePerformanceOverlay
 };
 Q_ENUM_NS(Option)
 
@@ -531,6 +538,25 @@ enum class WallpaperAspectStyle : quint8
 };
 Q_ENUM_NS(WallpaperAspectStyle)
 
+// How the blurred wallpaper of the mica material is kept in memory.
+enum class WallpaperStorageFormat : quint8
+{
+    Argb32, // 4 bytes per pixel, the fastest to paint.
+    Rgb888, // 3 bytes per pixel.
+    Rgb16, // 2 bytes per pixel, ordered dithering hides the banding.
+    YCbCr420 // 1.5 bytes per pixel, planar luma plus 2x2 subsampled chroma, expanded on paint.
+};
+Q_ENUM_NS(WallpaperStorageFormat)
+
+enum class MicaQuality : quint8
+{
+    Full, // Blurred wallpaper, tint and noise.
+    NoNoise, // Blurred wallpaper and tint.
+    Reduced, // Low resolution blurred wallpaper and tint.
+    Solid // The fallback color only.
+};
+Q_ENUM_NS(MicaQuality)
+
 #ifdef Q_OS_WINDOWS
 enum class RegistryRootKey : quint8
 {
@@ -645,6 +671,11 @@ struct Dpi
     }
 };
 
+using BackgroundTask = std::function<void()>;
+// Receives the background work of FramelessHelper (eg, the wallpaper processing of the
+// mica material). The runner must run each task exactly once, on any non-GUI thread.
+using BackgroundTaskRunner = std::function<void(BackgroundTask)>;
+
 } // namespace Global
 
 FRAMELESSHELPER_CORE_API void FramelessHelperCoreInitialize();
@@ -652,6 +683,8 @@ FRAMELESSHELPER_CORE_API void FramelessHelperCoreUninitialize();
 [[nodiscard]] FRAMELESSHELPER_CORE_API Global::VersionInfo FramelessHelperVersion();
 FRAMELESSHELPER_CORE_API void FramelessHelperEnableThemeAware();
 FRAMELESSHELPER_CORE_API void FramelessHelperPrintLogo();
+// Pass an empty runner to go back to the built-in low priority thread pool.
+FRAMELESSHELPER_CORE_API void FramelessHelperSetBackgroundTaskRunner(const Global::BackgroundTaskRunner &runner);
 
 namespace FramelessHelper::Core
 {
@@ -660,6 +693,7 @@ inline void uninitialize() { FramelessHelperCoreUninitialize(); }
 [[nodiscard]] inline Global::VersionInfo version() { return FramelessHelperVersion(); }
 inline void setApplicationOSThemeAware() { FramelessHelperEnableThemeAware(); }
 inline void outputLogo() { FramelessHelperPrintLogo(); }
+inline void setBackgroundTaskRunner(const Global::BackgroundTaskRunner &runner) { FramelessHelperSetBackgroundTaskRunner(runner); }
 } // namespace FramelessHelper::Core
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtGui/qregion.h>
 #include <memory>
 
 #if FRAMELESSHELPER_CONFIG(mica_material)
@@ -41,6 +42,10 @@ class FRAMELESSHELPER_CORE_API MicaMaterial : public QObject
     Q_PROPERTY(QColor fallbackColor READ fallbackColor WRITE setFallbackColor NOTIFY fallbackColorChanged FINAL)
     Q_PROPERTY(qreal noiseOpacity READ noiseOpacity WRITE setNoiseOpacity NOTIFY noiseOpacityChanged FINAL)
     Q_PROPERTY(bool fallbackEnabled READ isFallbackEnabled WRITE setFallbackEnabled NOTIFY fallbackEnabledChanged FINAL)
+    Q_PROPERTY(Global::MicaQuality quality READ quality NOTIFY qualityChanged FINAL)
+    Q_PROPERTY(bool adaptiveQualityEnabled READ isAdaptiveQualityEnabled WRITE setAdaptiveQualityEnabled NOTIFY adaptiveQualityEnabledChanged FINAL)
+    Q_PROPERTY(qreal frameBudget READ frameBudget WRITE setFrameBudget NOTIFY frameBudgetChanged FINAL)
+    Q_PROPERTY(int qualityRecoveryInterval READ qualityRecoveryInterval WRITE setQualityRecoveryInterval NOTIFY qualityRecoveryIntervalChanged FINAL)
 
 public:
     explicit MicaMaterial(QObject *parent = nullptr);
@@ -61,8 +66,30 @@ public:
     Q_NODISCARD bool isFallbackEnabled() const;
     void setFallbackEnabled(const bool value);
 
+    // The blurred wallpaper is shared by all mica materials, so is its storage format.
+    Q_NODISCARD static Global::WallpaperStorageFormat wallpaperStorageFormat();
+    static void setWallpaperStorageFormat(const Global::WallpaperStorageFormat value);
+
+    // The quality tier the next paint will use. It's lowered whenever painting keeps exceeding
+    // the frame budget, and raised again once the window has been idle for the recovery interval.
+    Q_NODISCARD Global::MicaQuality quality() const;
+
+    Q_NODISCARD bool isAdaptiveQualityEnabled() const;
+    void setAdaptiveQualityEnabled(const bool value);
+
+    // In milliseconds.
+    Q_NODISCARD qreal frameBudget() const;
+    void setFrameBudget(const qreal value);
+
+    // In milliseconds.
+    Q_NODISCARD int qualityRecoveryInterval() const;
+    void setQualityRecoveryInterval(const int value);
+
 public Q_SLOTS:
     void paint(QPainter *painter, const QRect &rect, const bool active = true);
+    // Only the pixels inside the clip region (in the painter coordinates) are composited,
+    // an empty region means nothing is visible at all.
+    void paint(QPainter *painter, const QRect &rect, const QRegion &clip, const bool active = true);
 
     [[deprecated("Use another overload instead.")]]
     void paint(QPainter *painter, const QSize &size, const QPoint &pos, const bool active = true)
@@ -76,6 +103,10 @@ Q_SIGNALS:
     void fallbackColorChanged();
     void noiseOpacityChanged();
     void fallbackEnabledChanged();
+    void qualityChanged();
+    void adaptiveQualityEnabledChanged();
+    void frameBudgetChanged();
+    void qualityRecoveryIntervalChanged();
     void shouldRedraw();
 };
 
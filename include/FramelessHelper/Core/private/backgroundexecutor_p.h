@@ -0,0 +1,53 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Runs the work which is not latency sensitive (eg, the wallpaper decoding and blurring
+// of the mica material) away from the GUI and render threads. The built-in pool has at
+// most two threads, and each of them runs with the lowest CPU and I/O priority the
+// system offers, so the background work only gets the resources nobody else wants.
+// Hosts which have their own thread pool can take over through a BackgroundTaskRunner.
+namespace BackgroundExecutor
+{
+
+// Without thread support the task is run immediately on the calling thread.
+FRAMELESSHELPER_CORE_API void post(Global::BackgroundTask task);
+FRAMELESSHELPER_CORE_API void setTaskRunner(const Global::BackgroundTaskRunner &runner);
+[[nodiscard]] FRAMELESSHELPER_CORE_API bool hasCustomTaskRunner();
+// Only waits for the tasks of the built-in pool.
+FRAMELESSHELPER_CORE_API void waitForDone();
+[[nodiscard]] FRAMELESSHELPER_CORE_API int maxThreadCount();
+// Moves the calling thread to the idle CPU and I/O scheduling classes where available,
+// custom runners may call it from their worker threads too.
+FRAMELESSHELPER_CORE_API void lowerCurrentThreadPriority();
+
+} // namespace BackgroundExecutor
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qtimer.h>
+#include <functional>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Tells a single click apart from the first half of a double click. Instead of delaying
+// every click by a fixed amount of time, the single click action is only delayed until
+// the double click interval (measured from the press, using the event timestamps) has
+// elapsed, and it's carried out right away when a double click is no longer possible.
+class FRAMELESSHELPER_CORE_API ClickDisambiguator : public QObject
+{
+    FRAMELESSHELPER_QT_CLASS(ClickDisambiguator)
+
+public:
+    using Callback = std::function<void()>;
+
+    explicit ClickDisambiguator(QObject *parent = nullptr);
+    ~ClickDisambiguator() override;
+
+    Q_NODISCARD bool isPending() const;
+
+    void press(const Qt::MouseButton button, const quint64 timestamp);
+    // The callback is either called immediately, or once it's clear that no double
+    // click is going to follow. A new click replaces the action still pending.
+    void release(const Qt::MouseButton button, const quint64 timestamp, const Callback &callback);
+    // Cancels the pending single click action, and ignores the release that follows.
+    void doubleClick();
+    void cancel();
+
+    // How long the single click action has to wait, in milliseconds. Zero means a
+    // double click is impossible and the action should be carried out immediately.
+    // Pure calculation, exposed separately so that it can be verified with
+    // synthesised timestamps.
+    Q_NODISCARD static int calculateDelay(const Qt::MouseButton button, const quint64 pressTimestamp,
+        const quint64 releaseTimestamp, const int doubleClickInterval);
+
+private:
+    void fire();
+
+private:
+    QTimer m_timer;
+    Callback m_callback = nullptr;
+    Qt::MouseButton m_pressButton = Qt::NoButton;
+    quint64 m_pressTimestamp = 0;
+    bool m_ignoreNextRelease = false;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+#if FRAMELESSHELPER_CONFIG(diagnostics_log)
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+enum class DiagnosticsEvent : quint16
+{
+    None = 0,
+    WindowAdded,
+    WindowRemoved,
+    HitTest, // arg0: result (Qt::Edges or HT*), arg1: x, arg2: y
+    SystemMoveStarted, // arg0: x, arg1: y
+    SystemResizeStarted, // arg0: Qt::Edges, arg1: x, arg2: y
+    SoftwareMoveResizeStarted, // arg0: Qt::Edges, arg1: x, arg2: y
+    ThemeChanged, // arg0: system theme, arg1: theme generation
+    WallpaperChanged, // arg0: aspect style
+    WallpaperGenerationStarted,
+    WallpaperGenerationFinished, // arg0: width, arg1: height, arg2: elapsed microseconds
+    Last = WallpaperGenerationFinished
+};
+
+// A fixed-size binary record, nothing is formatted until the log is dumped.
+struct DiagnosticsRecord
+{
+    quint64 sequence = 0; // Zero means the slot is empty or being written.
+    quint64 timestamp = 0; // Nanoseconds, steady clock.
+    quint64 windowId = 0;
+    quintptr arguments[3] = { 0, 0, 0 };
+    DiagnosticsEvent event = DiagnosticsEvent::None;
+};
+
+namespace DiagnosticsLog
+{
+
+// Recording is lock free and allocation free, it's cheap enough to keep it enabled all the time.
+FRAMELESSHELPER_CORE_API void record(const DiagnosticsEvent event, const quint64 windowId = 0,
+    const quintptr arg0 = 0, const quintptr arg1 = 0, const quintptr arg2 = 0) noexcept;
+
+FRAMELESSHELPER_CORE_API void setEnabled(const bool value) noexcept;
+[[nodiscard]] FRAMELESSHELPER_CORE_API bool isEnabled() noexcept;
+FRAMELESSHELPER_CORE_API void clear() noexcept;
+[[nodiscard]] FRAMELESSHELPER_CORE_API int capacity() noexcept;
+[[nodiscard]] FRAMELESSHELPER_CORE_API const char *eventName(const DiagnosticsEvent event) noexcept;
+
+// Returns the recorded events, oldest first.
+[[nodiscard]] FRAMELESSHELPER_CORE_API QList<DiagnosticsRecord> snapshot();
+[[nodiscard]] FRAMELESSHELPER_CORE_API QString dump();
+// Only uses async-signal-safe functions, can be called from a crash handler.
+FRAMELESSHELPER_CORE_API void dumpToFileDescriptor(const int fd) noexcept;
+
+} // namespace DiagnosticsLog
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#  define FRAMELESSHELPER_DIAGNOSTICS_RECORD(...) \
+     FRAMELESSHELPER_PREPEND_NAMESPACE(DiagnosticsLog)::record(__VA_ARGS__)
+#else // !FRAMELESSHELPER_CONFIG(diagnostics_log)
+#  define FRAMELESSHELPER_DIAGNOSTICS_RECORD(...) static_cast<void>(0)
+#endif // FRAMELESSHELPER_CONFIG(diagnostics_log)
@@ -26,6 +26,7 @@
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qmargins.h>
 #include <QtGui/qwindowdefs.h>
 #include <functional>
 #include <memory>
@@ -136,6 +137,52 @@ using FramelessExtraDataPtr = FramelessExtraData::PtrType;
 using FramelessExtraDataPtrs = QList<FramelessExtraDataPtr>;
 using FramelessExtraDataHash = QHash<ExtraDataType, FramelessExtraDataPtr>;
 
+// The derived window states which the frameless windows expose as properties, only used
+// to find out which of the change signals have to be emitted.
+enum class WindowStateFlag : quint8
+{
+    Hidden     = 1 << 0,
+    Normal     = 1 << 1,
+    Minimized  = 1 << 2,
+    Maximized  = 1 << 3,
+    Zoomed     = 1 << 4,
+    FullScreen = 1 << 5
+};
+Q_DECLARE_FLAGS(WindowStateFlags, WindowStateFlag)
+Q_DECLARE_OPERATORS_FOR_FLAGS(WindowStateFlags)
+
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+// The window manager's view of an X11 window, mirrored from the PropertyNotify events of
+// _NET_WM_STATE and _NET_FRAME_EXTENTS, so that reading it never goes to the X server.
+// Qt's own view of the window state may lag behind it. See X11WindowStateMirror.
+struct X11WindowState
+{
+    bool valid = false;
+    bool maximizedVertically = false;
+    bool maximizedHorizontally = false;
+    bool fullScreen = false;
+    bool hidden = false;
+    // The frame the window manager adds around the window, in device pixels. Stale
+    // unless frameExtentsValid is set, see X11WindowStateMirror::frameExtents().
+    bool frameExtentsValid = false;
+    QMargins frameExtents = {};
+
+    [[nodiscard]] Qt::WindowState windowState() const
+    {
+        if (hidden) {
+            return Qt::WindowMinimized;
+        }
+        if (fullScreen) {
+            return Qt::WindowFullScreen;
+        }
+        if (maximizedVertically && maximizedHorizontally) {
+            return Qt::WindowMaximized;
+        }
+        return Qt::WindowNoState;
+    }
+};
+#endif // (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+
 struct FRAMELESSHELPER_CORE_API FramelessData
 {
     QObject *window = nullptr;
@@ -144,6 +191,9 @@ struct FRAMELESSHELPER_CORE_API FramelessData
     bool frameless = false;
     FramelessCallbacksPtr callbacks = nullptr;
     FramelessExtraDataHash extraData = {};
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    X11WindowState x11WindowState = {};
+#endif // (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
 
     FramelessData();
     virtual ~FramelessData();
@@ -27,6 +27,7 @@
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <QtCore/qtimer.h>
 #include <optional>
+#include <functional>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -60,6 +61,21 @@ public:
     Q_NODISCARD static WId getWindowId(const QObject *window);
     Q_NODISCARD static QObject *getWindow(const WId windowId);
     static void updateWindowId(const QObject *window, const WId newWindowId);
+    // The window manager's view of the window state, where we mirror it from the native
+    // events (X11 only for now). Qt's own view may lag behind the window manager, which
+    // leads to decorations painted for the wrong state. Doesn't query the system.
+    Q_NODISCARD static std::optional<Qt::WindowState> mirroredWindowState(const QObject *window);
+
+    // Theme aware objects register themselves here instead of connecting to the
+    // systemThemeChanged() signal, so that a theme change is applied to all of them
+    // in one pass and the shared resources are only computed once per change.
+    using ThemeSubscriber = std::function<void()>;
+    static void addThemeSubscriber(const QObject *object, const ThemeSubscriber &callback);
+    static void removeThemeSubscriber(const QObject *object);
+    // Increased by one for every theme change, can be used as the cache key of the
+    // resources derived from the system theme.
+    Q_NODISCARD static quint64 themeGeneration();
+    void commitThemeChange();
 
     Global::SystemTheme systemTheme = Global::SystemTheme::Unknown;
     std::optional<Global::SystemTheme> overrideTheme = std::nullopt;
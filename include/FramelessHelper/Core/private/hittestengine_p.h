@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qmargins.h>
+#include <array>
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// A platform independent hit test engine for the window resize area. The window is
+// split into a 3x3 grid of zones (four corners, four edges and the client area),
+// the zone boundaries are only re-calculated when the window geometry changes, and
+// every hit test after that is just a few comparisons and a table lookup.
+class FRAMELESSHELPER_CORE_API HitTestEngine
+{
+    FRAMELESSHELPER_CLASS(HitTestEngine)
+
+public:
+    struct Geometry
+    {
+        QSize windowSize = {};
+        // The width of the left and right resize zones.
+        int horizontalBorderThickness = 0;
+        // The height of the top and bottom resize zones.
+        int verticalBorderThickness = 0;
+        // The width of the left and right resize zones inside the top and bottom rows,
+        // this is used to make the corners easier to grab. Zero means the same with
+        // the horizontal border thickness.
+        int cornerExtent = 0;
+        // False if the window is fixed size, maximized, fullscreen or minimized.
+        bool resizable = false;
+
+        [[nodiscard]] friend constexpr bool operator==(const Geometry &lhs, const Geometry &rhs) noexcept
+        {
+            return ((lhs.windowSize == rhs.windowSize)
+                && (lhs.horizontalBorderThickness == rhs.horizontalBorderThickness)
+                && (lhs.verticalBorderThickness == rhs.verticalBorderThickness)
+                && (lhs.cornerExtent == rhs.cornerExtent) && (lhs.resizable == rhs.resizable));
+        }
+
+        [[nodiscard]] friend constexpr bool operator!=(const Geometry &lhs, const Geometry &rhs) noexcept
+        {
+            return !operator==(lhs, rhs);
+        }
+    };
+
+    HitTestEngine();
+    ~HitTestEngine();
+
+    Q_NODISCARD Geometry geometry() const;
+    // Returns true if the zone table has been rebuilt.
+    bool setGeometry(const Geometry &value);
+    // Convenience overload which uses the Qt geometry (device independent pixels) and
+    // the default resize border thickness of the given window. The extra margins are
+    // added to the resize border thickness, for example the client side shadow area.
+    bool setGeometry(const QWindow *window, const bool fixedSize = false, const QMargins &extraMargins = {});
+
+    Q_NODISCARD Qt::Edges edgesAt(const QPoint &pos) const;
+    Q_NODISCARD Qt::CursorShape cursorShapeAt(const QPoint &pos) const;
+
+    Q_NODISCARD static Qt::CursorShape cursorShapeForEdges(const Qt::Edges edges);
+
+private:
+    void rebuild();
+    Q_NODISCARD int zoneIndexAt(const QPoint &pos) const;
+
+private:
+    Geometry m_geometry = {};
+    std::array<int, 2> m_rowBounds = {};
+    std::array<std::array<int, 2>, 3> m_columnBounds = {};
+    std::array<Qt::Edges, 9> m_zoneEdges = {};
+    std::array<Qt::CursorShape, 9> m_zoneCursors = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -25,26 +25,64 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtGui/qbrush.h>
+#include <QtGui/qpixmap.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 #ifdef FRAMELESSHELPER_HAS_THREAD
 #  undef FRAMELESSHELPER_HAS_THREAD
 #endif
 #if QT_CONFIG(thread)
 #  define FRAMELESSHELPER_HAS_THREAD 1
-#  include <QtCore/qthread.h>
 #else // !QT_CONFIG(thread)
 #  define FRAMELESSHELPER_HAS_THREAD 0
 #endif // QT_CONFIG(thread)
 
 #if FRAMELESSHELPER_CONFIG(mica_material)
 
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
-#if FRAMELESSHELPER_HAS_THREAD
-using FramelessHelperThreadClass = QThread;
-#else
-using FramelessHelperThreadClass = QObject;
-#endif
+// The blurred wallpaper is opaque and has almost no high frequency detail left, so it
+// can be kept in a much more compact format than what QPainter draws fastest.
+class FRAMELESSHELPER_CORE_API WallpaperStorage
+{
+public:
+    Q_NODISCARD bool isNull() const;
+    Q_NODISCARD QSize size() const;
+    Q_NODISCARD Global::WallpaperStorageFormat format() const;
+
+    // Expects an opaque premultiplied ARGB32 image.
+    Q_NODISCARD static WallpaperStorage pack(const QImage &image, const Global::WallpaperStorageFormat format);
+
+    // Not thread safe, the planar format reuses a scratch buffer to expand the pixels.
+    void draw(QPainter *painter, const QPoint &target, const QRect &source) const;
+    // For the renderers which upload the whole wallpaper at once.
+    Q_NODISCARD QImage toImage() const;
+    Q_NODISCARD qsizetype byteCount() const;
+
+private:
+    Q_NODISCARD static QImage packRgb16(const QImage &image);
+    void packYCbCr420(const QImage &image);
+    // The destination must be an RGB32 image at least as large as the rectangle.
+    void unpackYCbCr420(const QRect &rect, QImage *destination) const;
+
+private:
+    QSize m_size = {};
+    Global::WallpaperStorageFormat m_format = Global::WallpaperStorageFormat::Argb32;
+    QPixmap m_pixmap = {};
+    QImage m_image = {};
+    std::vector<quint8> m_luma = {};
+    std::vector<quint8> m_blueChroma = {};
+    std::vector<quint8> m_redChroma = {};
+    mutable QImage m_scratch = {};
+};
 
 class MicaMaterial;
 class FRAMELESSHELPER_CORE_API MicaMaterialPrivate : public QObject
@@ -52,6 +90,24 @@ class FRAMELESSHELPER_CORE_API MicaMaterialPrivate : public QObject
     FRAMELESSHELPER_PRIVATE_QT_CLASS(MicaMaterial)
 
 public:
+    struct BrushCacheStatistics
+    {
+        // How many material textures have been generated.
+        quint64 builds = 0;
+        // How many times an existing texture has been reused.
+        quint64 hits = 0;
+        // How many textures are cached right now.
+        int textures = 0;
+    };
+
+    struct WallpaperDecodePlan
+    {
+        // The size the picture will cover on the screen, before the blur.
+        QSize displaySize = {};
+        // The size we ask the image decoder for.
+        QSize decodeSize = {};
+    };
+
     explicit MicaMaterialPrivate(MicaMaterial *q);
     ~MicaMaterialPrivate() override;
 
@@ -61,9 +117,33 @@ public:
     Q_NODISCARD QSize mapToWallpaper(const QSize &size) const;
     Q_NODISCARD QRect mapToWallpaper(const QRect &rect) const;
 
+    // For the renderers which upload the wallpaper as a whole instead of painting
+    // it piece by piece, such as the Qt Quick scene graph. The key is zero if there's
+    // no wallpaper yet, and it changes whenever the content does.
+    Q_NODISCARD static quint64 wallpaperKey(const Global::MicaQuality quality);
+    Q_NODISCARD static QImage wallpaperImage(const Global::MicaQuality quality);
+    // What covers the wallpaper, or the solid fallback color.
+    Q_NODISCARD QBrush materialBrush(const bool active, const Global::MicaQuality quality) const;
+    // The material textures are shared by all the materials with the same parameters.
+    Q_NODISCARD static BrushCacheStatistics brushCacheStatistics();
+
+    Q_NODISCARD static WallpaperDecodePlan planWallpaperDecode(const QSize &pictureSize,
+        const QByteArray &format, const Global::WallpaperAspectStyle aspectStyle, const QSize &screenSize);
+    // Decodes the wallpaper picture at the planned resolution and scales it to the size
+    // it covers on the screen. Thread safe, it's called from the background executor.
+    Q_NODISCARD static QImage decodeWallpaper(const QString &filePath,
+        const Global::WallpaperAspectStyle aspectStyle, const QSize &screenSize);
+
     Q_SLOT void maybeGenerateBlurredWallpaper(const bool force = false);
     Q_SLOT void updateMaterialBrush();
     Q_SLOT void forceRebuildWallpaper();
+    // Paints may happen on the render thread, the cost is always processed on our own thread.
+    Q_SLOT void updateQuality(const qint64 paintCost);
+    // Thread safe, hands the cost over to updateQuality().
+    void reportPaintCost(const qint64 paintCost);
+    Q_SLOT void maybeRecoverQuality();
+
+    void setQuality(const Global::MicaQuality value);
 
     void initialize();
     void prepareGraphicsResources();
@@ -74,28 +154,47 @@ public:
     qreal noiseOpacity = qreal(0);
     bool fallbackEnabled = true;
     QBrush micaBrush = {};
+    QBrush micaBrushWithoutNoise = {};
     bool initialized = false;
     QSize wallpaperSize = {};
+
+    std::atomic<Global::MicaQuality> quality = Global::MicaQuality::Full;
+    bool adaptiveQualityEnabled = true;
+    qreal frameBudget = qreal(0);
+    int qualityRecoveryInterval = 0;
+    qreal averagePaintCost = qreal(-1);
+    int overBudgetPaints = 0;
+    int recoveryBackoff = 1;
+    QElapsedTimer lastPaintTimer{};
+    QTimer qualityRecoveryTimer{};
 };
 
-class WallpaperThread : public FramelessHelperThreadClass
+// Generates the blurred wallpaper on the background executor, see BackgroundExecutor.
+class WallpaperGenerator : public QObject
 {
-    FRAMELESSHELPER_QT_CLASS(WallpaperThread)
+    FRAMELESSHELPER_QT_CLASS(WallpaperGenerator)
 
 public:
-    explicit WallpaperThread(QObject *parent = nullptr);
-    ~WallpaperThread() override;
+    explicit WallpaperGenerator(QObject *parent = nullptr);
+    ~WallpaperGenerator() override;
+
+    // Supersedes all the pending and running generations.
+    void start();
+    void cancel();
 
 Q_SIGNALS:
+    // Emitted from the background thread.
     void imageUpdated();
 
-#if FRAMELESSHELPER_HAS_THREAD
-protected:
-    void run() override;
-#else
-public:
-    void start();
-#endif
+private:
+    struct Context;
+    // Static on purpose: the jobs only hold the shared context, never the generator
+    // itself, since a custom task runner may run them after we have been destroyed.
+    static void generate(const std::shared_ptr<Context> &context, const quint64 generation);
+    Q_NODISCARD static bool isSuperseded(const Context &context, const quint64 generation);
+
+private:
+    std::shared_ptr<Context> m_context = nullptr;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qtimer.h>
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// An in-process replacement of the system move/resize operation. It's used when the
+// window manager (or the QPA) can't move or resize the window for us, for example
+// window managers without _NET_WM_MOVERESIZE support, nested compositors and the
+// offscreen platform. The geometry is only applied once per display frame no matter
+// how many mouse move events we received during that period.
+class FRAMELESSHELPER_CORE_API MoveResizeEngine : public QObject
+{
+    FRAMELESSHELPER_QT_CLASS(MoveResizeEngine)
+
+public:
+    struct Constraints
+    {
+        QSize minimumSize = {};
+        QSize maximumSize = {};
+        // Window edges closer than the snap distance to the available geometry edges
+        // will be snapped to them. An empty rectangle disables snapping.
+        QRect availableGeometry = {};
+        int snapDistance = 0;
+    };
+
+    explicit MoveResizeEngine(QObject *parent = nullptr);
+    ~MoveResizeEngine() override;
+
+    Q_NODISCARD bool isActive() const;
+    Q_NODISCARD QWindow *window() const;
+    Q_NODISCARD Qt::Edges edges() const;
+
+    // Empty edges means a move operation.
+    bool start(QWindow *window, const Qt::Edges edges, const QPoint &globalPos);
+    void update(const QPoint &globalPos);
+    void finish(const QPoint &globalPos);
+    void cancel();
+
+    // Pure geometry calculation, exposed separately so that it can be verified without
+    // any window or display.
+    Q_NODISCARD static QRect calculateGeometry(const QRect &startGeometry, const Qt::Edges edges,
+        const QPoint &delta, const Constraints &constraints);
+
+private:
+    void flush();
+    void stop();
+    Q_NODISCARD Constraints constraints() const;
+
+private:
+    QPointer<QWindow> m_window = nullptr;
+    Qt::Edges m_edges = {};
+    QRect m_startGeometry = {};
+    QPoint m_startPos = {};
+    QPoint m_pendingPos = {};
+    bool m_active = false;
+    bool m_dirty = false;
+    QTimer m_frameTimer;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qelapsedtimer.h>
+#include <array>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+enum class PerformanceComponent : quint8
+{
+    MicaMaterial,
+    WindowBorder,
+    TitleBar,
+    Last = TitleBar
+};
+
+struct PerformanceSnapshot
+{
+    // The intervals between the recent frames, in microseconds, oldest first.
+    QList<qint64> frameTimes = {};
+    // The cost of the last paint, in microseconds. Negative if never painted.
+    std::array<qint64, static_cast<int>(PerformanceComponent::Last) + 1> paintCosts = {};
+    // The time spent in our event filters during the last whole second, in microseconds.
+    qint64 eventFilterCost = 0;
+};
+
+// Collects the numbers shown by the performance overlay, which tells the cost of the window
+// decorations apart from the cost of the window contents. See Option::EnablePerformanceOverlay.
+namespace PerformanceMonitor
+{
+
+// Nothing is measured or recorded if the option is not set.
+[[nodiscard]] FRAMELESSHELPER_CORE_API bool isEnabled();
+
+// Thread safe, the Qt Quick items are painted on the render thread.
+FRAMELESSHELPER_CORE_API void recordFrame(const QObject *window);
+FRAMELESSHELPER_CORE_API void recordPaintCost(const QObject *window, const PerformanceComponent component, const qint64 nsecs);
+FRAMELESSHELPER_CORE_API void recordEventFilterCost(const QObject *window, const qint64 nsecs);
+FRAMELESSHELPER_CORE_API void removeWindow(const QObject *window);
+[[nodiscard]] FRAMELESSHELPER_CORE_API PerformanceSnapshot snapshot(const QObject *window);
+
+// Shared by the Qt Widgets and the Qt Quick overlays, so that they look the same. It's
+// painted with QPainter only, which also works on the offscreen platform.
+[[nodiscard]] FRAMELESSHELPER_CORE_API QSize overlaySize();
+// In milliseconds.
+[[nodiscard]] FRAMELESSHELPER_CORE_API int overlayRefreshInterval();
+FRAMELESSHELPER_CORE_API void paintOverlay(QPainter *painter, const QRect &rect, const PerformanceSnapshot &snapshot);
+
+} // namespace PerformanceMonitor
+
+// Measures the enclosing scope. The clock is not even read if the overlay is disabled.
+class FRAMELESSHELPER_CORE_API PerformanceScope
+{
+    FRAMELESSHELPER_CLASS(PerformanceScope)
+
+public:
+    // Measures a paint of the given decoration component.
+    explicit PerformanceScope(const QObject *window, const PerformanceComponent component);
+    // Measures the event filtering.
+    explicit PerformanceScope(const QObject *window);
+    ~PerformanceScope();
+
+private:
+    const QObject *m_window = nullptr;
+    int m_component = -1;
+    QElapsedTimer m_timer = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#  define FRAMELESSHELPER_PERFORMANCE_SCOPE(...) \
+     const FRAMELESSHELPER_PREPEND_NAMESPACE(PerformanceScope) framelessHelperPerformanceScope(__VA_ARGS__)
+#else // !FRAMELESSHELPER_CONFIG(performance_overlay)
+#  define FRAMELESSHELPER_PERFORMANCE_SCOPE(...) static_cast<void>(0)
+#endif // FRAMELESSHELPER_CONFIG(performance_overlay)
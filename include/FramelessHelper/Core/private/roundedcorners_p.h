@@ -0,0 +1,69 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qregion.h>
+#include <array>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+class QWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+namespace RoundedCorners
+{
+
+enum class Corner : quint8
+{
+    TopLeft = 0,
+    TopRight,
+    BottomLeft,
+    BottomRight
+};
+using CornerMasks = std::array<QImage, 4>;
+
+// Only implemented for the Qt backend on Linux currently, see Option::WindowUseRoundCorners.
+[[nodiscard]] FRAMELESSHELPER_CORE_API bool isEnabled();
+// Zero if the rounded corners are not enabled.
+[[nodiscard]] FRAMELESSHELPER_CORE_API int radius();
+
+// Pre-rendered antialiased alpha masks of the area outside of the corner arcs, indexed
+// by Corner. The masks are cached per radius and device pixel ratio.
+[[nodiscard]] FRAMELESSHELPER_CORE_API CornerMasks cornerMasks(const int radius, const qreal devicePixelRatio);
+// Cuts the corners out of what has been painted already, only the four corner rectangles
+// are touched. The paint device must have an alpha channel.
+FRAMELESSHELPER_CORE_API void eraseCorners(QPainter *painter, const QSize &size, const int radius);
+// Aliased window shape, used as the X Shape bounding region when we can't rely on
+// the alpha channel (no compositing manager or an opaque window surface).
+[[nodiscard]] FRAMELESSHELPER_CORE_API QRegion shapeRegion(const QSize &size, const int radius);
+
+} // namespace RoundedCorners
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qmargins.h>
+#include <QtGui/qimage.h>
+#include <array>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Client side drop shadow for the frameless windows on Linux. The shadow is pre-rendered
+// once into a small nine-slice texture (cached per blur radius, corner radius, color and
+// device pixel ratio), painting it is just eight blits no matter how large the window is.
+// The shadow lives in a transparent margin around the window contents, the margin is also
+// reported to the window manager through _GTK_FRAME_EXTENTS.
+namespace WindowShadow
+{
+
+struct Parameters
+{
+    int blurRadius = 0;
+    QPoint offset = {};
+    QColor color = {};
+    int cornerRadius = 0;
+    qreal devicePixelRatio = 1;
+};
+
+enum class Slice : quint8
+{
+    TopLeft = 0,
+    Top,
+    TopRight,
+    Left,
+    Right,
+    BottomLeft,
+    Bottom,
+    BottomRight
+};
+
+struct SliceRect
+{
+    // In image pixels.
+    QRect source = {};
+    // In device independent pixels, relative to the window.
+    QRectF target = {};
+};
+using Slices = std::array<SliceRect, 8>;
+
+// Only implemented for the Qt backend on Linux currently, see Option::EnableClientSideShadow.
+// The shadow needs an alpha channel so it's also disabled when there's no compositing manager.
+[[nodiscard]] FRAMELESSHELPER_CORE_API bool isEnabled();
+[[nodiscard]] FRAMELESSHELPER_CORE_API Parameters defaultParameters(const bool active, const qreal devicePixelRatio);
+
+// The space between the window edges and the window contents, in device independent pixels.
+[[nodiscard]] FRAMELESSHELPER_CORE_API QMargins margins(const Parameters &params);
+// Thread safe, the Qt Quick render threads paint the shadow as well.
+[[nodiscard]] FRAMELESSHELPER_CORE_API QImage texture(const Parameters &params);
+// The source and target rectangles of the eight border slices, the center slice is always
+// covered by the window contents so it's never painted.
+[[nodiscard]] FRAMELESSHELPER_CORE_API Slices slices(const Parameters &params, const QSize &windowSize);
+FRAMELESSHELPER_CORE_API void paint(QPainter *painter, const QSize &windowSize, const Parameters &params);
+
+} // namespace WindowShadow
+
+FRAMELESSHELPER_END_NAMESPACE
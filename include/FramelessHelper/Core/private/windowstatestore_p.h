@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtCore/qrect.h>
+#include <optional>
+#include <memory>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+struct WindowStateRecord
+{
+    // Only updated while the window is in the normal state, so un-maximizing a restored
+    // window brings it back to where the user left it.
+    QRect normalGeometry = {};
+    Qt::WindowState state = Qt::WindowNoState;
+    QString screenName = {};
+    QRect screenGeometry = {};
+};
+using WindowStateRecords = QHash<QString, WindowStateRecord>;
+
+// Shared with the background tasks, which may outlive the store.
+struct WindowStateWriter;
+using WindowStateWriterPtr = std::shared_ptr<WindowStateWriter>;
+
+class WindowStateStore;
+class FRAMELESSHELPER_CORE_API WindowStateStorePrivate : public QObject
+{
+    FRAMELESSHELPER_PRIVATE_QT_CLASS(WindowStateStore)
+
+public:
+    explicit WindowStateStorePrivate(WindowStateStore *q);
+    ~WindowStateStorePrivate() override;
+
+    Q_NODISCARD static QString defaultFilePath();
+    Q_NODISCARD static QByteArray serialize(const WindowStateRecords &records);
+    Q_NODISCARD static std::optional<WindowStateRecords> deserialize(const QByteArray &data);
+    // Fits the saved geometry into the screens we have now.
+    Q_NODISCARD static QRect validateGeometry(const WindowStateRecord &record);
+
+    void load();
+    void capture(const QObject *window);
+    void scheduleCapture(const QObject *window);
+    void captureChangedWindows();
+    Q_SLOT void save();
+    // Also waits for the write in progress.
+    Q_SLOT void flush();
+    void untrack(const QObject *window, const bool destroyed);
+
+protected:
+    Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
+
+public:
+    QString filePath = {};
+    bool loaded = false;
+    bool dirty = false;
+    WindowStateRecords records = {};
+    QHash<const QObject *, QString> trackedWindows = {};
+    QSet<const QObject *> changedWindows = {};
+    QTimer saveTimer{};
+    WindowStateWriterPtr writer = nullptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qabstractnativeeventfilter.h>
+#include <QtCore/qmargins.h>
+
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Keeps the X11WindowState of the frameless windows up to date from the PropertyNotify
+// events, the X server only sends them when the window manager changes something, so
+// the decorations never need to ask it for the current state.
+class X11WindowStateMirror : public QAbstractNativeEventFilter
+{
+    FRAMELESSHELPER_CLASS(X11WindowStateMirror)
+
+public:
+    explicit X11WindowStateMirror();
+    ~X11WindowStateMirror() override;
+
+    // Seeds the mirror with the current window state, it's the only time we read it
+    // without being told it changed. Does nothing if we are not running on X11.
+    static void addWindow(const QObject *window);
+    // _NET_FRAME_EXTENTS in device pixels. Only asks the X server when the window manager
+    // changed them since the last call, empty if the window is not mirrored.
+    Q_NODISCARD static QMargins frameExtents(const QObject *window);
+
+    Q_NODISCARD bool nativeEventFilter(const QByteArray &eventType, void *message, QT_NATIVE_EVENT_RESULT_TYPE *result) override;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
@@ -32,6 +32,7 @@
 #if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
 QT_BEGIN_NAMESPACE
 class QScreen;
+class QRegion;
 QT_END_NAMESPACE
 #endif // Q_OS_LINUX
 
@@ -82,6 +83,7 @@ namespace Utils
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isWindowAccelerated(const QWindow *window);
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isWindowTransparent(const QWindow *window);
 [[nodiscard]] FRAMELESSHELPER_CORE_API QColor calculateForegroundColor(const QColor &backgroundColor);
+[[nodiscard]] FRAMELESSHELPER_CORE_API bool shouldApplyFramelessWindowHint();
 
 #ifdef Q_OS_WINDOWS
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isWindowsVersionOrGreater(const Global::WindowsVersion version);
@@ -148,6 +150,7 @@ FRAMELESSHELPER_CORE_API void printWin32Message(void *msg);
 [[nodiscard]] FRAMELESSHELPER_CORE_API QByteArray x11_nextStartupId();
 [[nodiscard]] FRAMELESSHELPER_CORE_API Display *x11_display();
 [[nodiscard]] FRAMELESSHELPER_CORE_API xcb_connection_t *x11_connection();
+[[nodiscard]] FRAMELESSHELPER_CORE_API bool x11_isCompositingManagerRunning();
 [[nodiscard]] FRAMELESSHELPER_CORE_API QByteArray getWindowProperty(const WId windowId, const xcb_atom_t prop, const xcb_atom_t type, const quint32 data_len);
 FRAMELESSHELPER_CORE_API void setWindowProperty(const WId windowId, const xcb_atom_t prop, const xcb_atom_t type, const void *data, const quint32 data_len, const uint8_t format);
 FRAMELESSHELPER_CORE_API void clearWindowProperty(const WId windowId, const xcb_atom_t prop);
@@ -161,6 +164,12 @@ FRAMELESSHELPER_CORE_API void openSystemMenu(const WId windowId, const QPoint &g
 [[nodiscard]] FRAMELESSHELPER_CORE_API QColor getAccentColor_linux();
 FRAMELESSHELPER_CORE_API void sendMoveResizeMessage(const WId windowId, const uint32_t action, const QPoint &globalPos, const Qt::MouseButton button = Qt::LeftButton);
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isCustomDecorationSupported();
+// Tells the window manager the size of the client side decoration (the shadow) in device pixels.
+FRAMELESSHELPER_CORE_API void setFrameExtents(const WId windowId, const QMargins &extents);
+// X Shape extension, the region is in device pixels. An empty region restores the default shape.
+// Pointer events outside of the input shape are delivered to the windows below by the X server.
+// The bounding shape is set by QWindow::setMask() already.
+FRAMELESSHELPER_CORE_API void setWindowInputShape(const WId windowId, const QRegion &region);
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool setPlatformPropertiesForWindow(QWindow *window, const QVariantHash &props);
 #endif // Q_OS_LINUX
 
@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class WindowStateStorePrivate;
+class FRAMELESSHELPER_CORE_API WindowStateStore : public QObject
+{
+    FRAMELESSHELPER_PUBLIC_QT_CLASS(WindowStateStore)
+
+    Q_PROPERTY(QString filePath READ filePath WRITE setFilePath NOTIFY filePathChanged FINAL)
+    Q_PROPERTY(int saveDelay READ saveDelay WRITE setSaveDelay NOTIFY saveDelayChanged FINAL)
+
+public:
+    explicit WindowStateStore(QObject *parent = nullptr);
+    ~WindowStateStore() override;
+
+    // Defaults to a file inside the config location of the application.
+    Q_NODISCARD QString filePath() const;
+    void setFilePath(const QString &value);
+
+    // In milliseconds. All the changes made within this period are written to the disk at once,
+    // so moving or resizing a window doesn't cause any disk I/O until the user stops.
+    Q_NODISCARD int saveDelay() const;
+    void setSaveDelay(const int value);
+
+    Q_NODISCARD bool contains(const QString &id) const;
+
+public Q_SLOTS:
+    // The window must have been attached to a frameless helper already, and it should not have
+    // been shown yet, otherwise it will be moved after it appears. The saved geometry is fitted
+    // into the current screens. Returns false (and leaves the window untouched) if there's nothing
+    // saved under this identifier.
+    bool restore(const QObject *window, const QString &id);
+    // Saves the geometry, the window state and the screen of the window whenever they change,
+    // until the window is destroyed or untracked.
+    void track(const QObject *window, const QString &id);
+    void untrack(const QObject *window);
+    void remove(const QString &id);
+    // Writes all the pending changes synchronously.
+    void flush();
+
+Q_SIGNALS:
+    void filePathChanged();
+    void saveDelayChanged();
+};
+
+FRAMELESSHELPER_END_NAMESPACE
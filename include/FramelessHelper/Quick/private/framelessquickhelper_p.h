@@ -41,6 +41,8 @@ class QuickMicaMaterial;
 class QuickWindowBorder;
 #endif
 
+class QuickWindowShadow;
+
 class FramelessQuickHelper;
 class FRAMELESSHELPER_QUICK_API FramelessQuickHelperPrivate : public QObject
 {
@@ -63,7 +65,10 @@ public:
 #endif
 #if FRAMELESSHELPER_CONFIG(border_painter)
     Q_NODISCARD QuickWindowBorder *findOrCreateWindowBorder() const;
+    // Creates the default window border, but only once it has something to draw.
+    void maybeCreateWindowBorder();
 #endif
+    Q_NODISCARD QuickWindowShadow *findOrCreateWindowShadow() const;
 
     Q_NODISCARD static FramelessQuickHelper *findOrCreateFramelessHelper(QObject *object);
 
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
 
 #if (FRAMELESSHELPER_CONFIG(private_qt) && FRAMELESSHELPER_CONFIG(window))
 
@@ -32,10 +33,6 @@
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
-#if FRAMELESSHELPER_CONFIG(border_painter)
-class QuickWindowBorder;
-#endif
-
 class FramelessQuickWindow;
 class FRAMELESSHELPER_QUICK_API FramelessQuickWindowPrivate : public QObject
 {
@@ -45,10 +42,12 @@ public:
     explicit FramelessQuickWindowPrivate(FramelessQuickWindow *q);
     ~FramelessQuickWindowPrivate() override;
 
+    Q_NODISCARD WindowStateFlags currentWindowStateFlags() const;
+    void emitWindowStateSignals();
+
     QQuickWindow::Visibility savedVisibility = QQuickWindow::Windowed;
-#if FRAMELESSHELPER_CONFIG(border_painter)
-    QuickWindowBorder *windowBorder = nullptr;
-#endif
+    // The states we notified last time, so that only the really changed ones get notified.
+    WindowStateFlags windowStateFlags = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
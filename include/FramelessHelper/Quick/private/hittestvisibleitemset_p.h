@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <QtCore/qset.h>
+
+QT_BEGIN_NAMESPACE
+class QQuickItem;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The hit test only looks at the visible and enabled items, which are tracked through
+// their change notifications instead of asking every registered item on each mouse
+// event. Destroyed items are dropped immediately.
+class FRAMELESSHELPER_QUICK_API HitTestVisibleItemSet : public QObject
+{
+    FRAMELESSHELPER_QT_CLASS(HitTestVisibleItemSet)
+
+public:
+    explicit HitTestVisibleItemSet(QObject *parent = nullptr);
+    ~HitTestVisibleItemSet() override;
+
+    void insert(QQuickItem *item);
+    void remove(QQuickItem *item);
+
+    Q_NODISCARD const QSet<QQuickItem *> &activeItems() const;
+
+private:
+    void updateActiveState(QQuickItem *item);
+
+private:
+    QSet<const QObject *> m_items = {};
+    QSet<QQuickItem *> m_activeItems = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,168 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Quick/framelesshelperquick_global.h>
+
+#if FRAMELESSHELPER_CONFIG(titlebar)
+
+#include <FramelessHelper/Quick/quickchromepalette.h>
+#include <QtGui/qcolor.h>
+#include <QtGui/qimage.h>
+#include <QtQuick/qquickitem.h>
+#include <array>
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class ClickDisambiguator;
+
+// A lightweight alternative to QuickStandardTitleBar. The whole title bar is a single item
+// which builds one small scene graph subtree in updatePaintNode(): no child items, no
+// bindings, no anchors. The title and the button glyphs are rasterized once into textures
+// and only rasterized again when they really change, hover and press feedback is driven
+// by an internal state machine.
+class FRAMELESSHELPER_QUICK_API QuickCompactTitleBar : public QQuickItem
+{
+    FRAMELESSHELPER_QT_CLASS(QuickCompactTitleBar)
+#ifdef QML_NAMED_ELEMENT
+    QML_NAMED_ELEMENT(CompactTitleBar)
+#endif // QML_NAMED_ELEMENT
+    Q_PROPERTY(Qt::Alignment titleLabelAlignment READ titleLabelAlignment WRITE setTitleLabelAlignment NOTIFY titleLabelAlignmentChanged FINAL)
+    Q_PROPERTY(bool extended READ isExtended WRITE setExtended NOTIFY extendedChanged FINAL)
+    Q_PROPERTY(bool hideWhenClose READ isHideWhenClose WRITE setHideWhenClose NOTIFY hideWhenCloseChanged FINAL)
+    Q_PROPERTY(QuickChromePalette* chromePalette READ chromePalette CONSTANT FINAL)
+    Q_PROPERTY(bool windowIconVisible READ windowIconVisible WRITE setWindowIconVisible NOTIFY windowIconVisibleChanged FINAL)
+
+public:
+    enum class ButtonState : quint8
+    {
+        Normal,
+        Hovered,
+        Pressed
+    };
+    Q_ENUM(ButtonState)
+
+    explicit QuickCompactTitleBar(QQuickItem *parent = nullptr);
+    ~QuickCompactTitleBar() override;
+
+    Q_NODISCARD Qt::Alignment titleLabelAlignment() const;
+    void setTitleLabelAlignment(const Qt::Alignment value);
+
+    Q_NODISCARD bool isExtended() const;
+    void setExtended(const bool value);
+
+    Q_NODISCARD bool isHideWhenClose() const;
+    void setHideWhenClose(const bool value);
+
+    Q_NODISCARD QuickChromePalette *chromePalette() const;
+
+    Q_NODISCARD bool windowIconVisible() const;
+    void setWindowIconVisible(const bool value);
+
+protected:
+    Q_NODISCARD QSGNode *updatePaintNode(QSGNode *old, UpdatePaintNodeData *data) override;
+    void updatePolish() override;
+    void itemChange(const ItemChange change, const ItemChangeData &value) override;
+    void hoverEnterEvent(QHoverEvent *event) override;
+    void hoverMoveEvent(QHoverEvent *event) override;
+    void hoverLeaveEvent(QHoverEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void mouseUngrabEvent() override;
+
+Q_SIGNALS:
+    void titleLabelAlignmentChanged();
+    void extendedChanged();
+    void hideWhenCloseChanged();
+    void windowIconVisibleChanged();
+
+private:
+    struct Button
+    {
+        Global::SystemButtonType type = Global::SystemButtonType::Unknown;
+        ButtonState state = ButtonState::Normal;
+        QRectF rect = {};
+        QImage glyph = {};
+        Global::SystemButtonType glyphType = Global::SystemButtonType::Unknown;
+        QColor glyphColor = {};
+        qreal glyphDevicePixelRatio = 0;
+    };
+
+    void initialize();
+    void rebindWindow();
+    void updateLayout();
+    void updateHitTestRects();
+    void setHoveredButton(const int index);
+    void setPressedButton(const int index);
+    void updateButtonStates();
+    void triggerButton(const Global::SystemButtonType type);
+    Q_NODISCARD int buttonAt(const QPointF &pos) const;
+    Q_NODISCARD bool isInWindowIconArea(const QPointF &pos) const;
+    Q_NODISCARD bool isWindowActive() const;
+    Q_NODISCARD QColor buttonBackgroundColor(const Button &button) const;
+    Q_NODISCARD QColor buttonForegroundColor(const Button &button) const;
+    Q_NODISCARD QImage renderText(const QString &text, const QFont &font, const QColor &color,
+        const QSizeF &size, const Qt::Alignment alignment) const;
+
+private:
+    Qt::Alignment m_labelAlignment = {};
+    bool m_extended = false;
+    bool m_hideWhenClose = false;
+    bool m_windowIconVisible = false;
+    QuickChromePalette *m_chromePalette = nullptr;
+    ClickDisambiguator *m_iconClickHandler = nullptr;
+    QPointer<QQuickWindow> m_window = nullptr;
+    QList<QMetaObject::Connection> m_connections = {};
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    std::array<Button, 3> m_buttons = {};
+#else
+    std::array<Button, 0> m_buttons = {};
+#endif
+    int m_hoveredButton = -1;
+    int m_pressedButton = -1;
+    QRectF m_iconRect = {};
+    QRectF m_titleRect = {};
+    QImage m_iconImage = {};
+    QImage m_titleImage = {};
+    qint64 m_iconKey = 0;
+    QSize m_iconPixelSize = {};
+    QString m_titleText = {};
+    QColor m_titleColor = {};
+    QSizeF m_titleSize = {};
+    qreal m_titleDevicePixelRatio = 0;
+    Qt::Alignment m_titleAlignment = {};
+    QList<QRect> m_hitTestRects = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif
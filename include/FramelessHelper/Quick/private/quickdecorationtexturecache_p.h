@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QImage;
+class QQuickWindow;
+class QSGTexture;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Shares the scene graph textures of the window decorations, so that a texture is
+// only uploaded once per content and render context, no matter how many windows and
+// items use it. All the software renderers share the same textures, because their
+// textures are plain pixmaps which don't belong to any context.
+class FRAMELESSHELPER_QUICK_API QuickDecorationTextureCache
+{
+    FRAMELESSHELPER_CLASS(QuickDecorationTextureCache)
+
+public:
+    enum class Content : quint8
+    {
+        MicaWallpaper,
+        MicaTile
+    };
+
+    struct Statistics
+    {
+        // How many textures have been created.
+        quint64 uploads = 0;
+        // How many times an existing texture has been handed out again.
+        quint64 hits = 0;
+        // How many textures are alive right now.
+        int textures = 0;
+    };
+
+    using ImageProvider = std::function<QImage()>;
+
+    // Must be called on the render thread of the given window. The provider is only
+    // invoked if there's no such texture yet. Returns nullptr if the texture can't
+    // be created, the caller should skip drawing it in that case.
+    Q_NODISCARD static QSGTexture *acquire(QQuickWindow *window, const Content content,
+        const quint64 key, const ImageProvider &provider);
+    // Deletes the texture once it's no longer used by anyone, on the calling thread.
+    static void release(QSGTexture *texture);
+
+    Q_NODISCARD static Statistics statistics();
+    static void resetStatistics();
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -42,13 +42,16 @@ public:
     ~QuickMicaMaterialPrivate() override;
 
     Q_SLOT void rebindWindow();
+    Q_SLOT void updateResources();
 
     void initialize();
 
     QMetaObject::Connection rootWindowXChangedConnection = {};
     QMetaObject::Connection rootWindowYChangedConnection = {};
     QMetaObject::Connection rootWindowActiveChangedConnection = {};
+    QMetaObject::Connection rootWindowVisibilityChangedConnection = {};
     MicaMaterial *micaMaterial = nullptr;
+    bool resourcesReleased = false;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
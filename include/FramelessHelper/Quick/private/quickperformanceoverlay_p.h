@@ -0,0 +1,70 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <QtCore/qtimer.h>
+#include <QtQuick/qquickitem.h>
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Scene graph counterpart of the performance overlay of the Qt Widgets module. It sits in
+// the bottom right corner of the window content, above all the other items, and it's
+// rendered into one image node, so it also shows up on the offscreen platform.
+class FRAMELESSHELPER_QUICK_API QuickPerformanceOverlay : public QQuickItem
+{
+    FRAMELESSHELPER_QT_CLASS(QuickPerformanceOverlay)
+
+public:
+    explicit QuickPerformanceOverlay(QQuickItem *parent = nullptr);
+    ~QuickPerformanceOverlay() override;
+
+protected:
+    Q_NODISCARD QSGNode *updatePaintNode(QSGNode *old, UpdatePaintNodeData *data) override;
+    void itemChange(const ItemChange change, const ItemChangeData &value) override;
+
+private Q_SLOTS:
+    void updateLayout();
+
+private:
+    void rebindWindow();
+
+private:
+    QPointer<QQuickWindow> m_window = nullptr;
+    // Only used as the key of the recorded numbers, never dereferenced.
+    const QObject *m_recordedWindow = nullptr;
+    QList<QMetaObject::Connection> m_connections = {};
+    QTimer m_refreshTimer{};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(performance_overlay)
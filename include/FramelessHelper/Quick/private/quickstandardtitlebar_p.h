@@ -42,6 +42,7 @@ QT_END_NAMESPACE
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
 class QuickImageItem;
+class ClickDisambiguator;
 
 class FRAMELESSHELPER_QUICK_API QuickStandardTitleBar : public QQuickRectangle
 {
@@ -121,6 +122,11 @@ Q_SIGNALS:
 
 private:
     void initialize();
+    void initializeWindowIcon();
+    void initializeTitleLabel();
+    void initializeSystemButtons();
+    void initializeChildrenIfVisible();
+    void updateTitleLabelAnchors();
     void updateAll();
     Q_NODISCARD bool mouseEventHandler(QMouseEvent *event);
     Q_NODISCARD QRect windowIconRect() const;
@@ -140,10 +146,12 @@ private:
     QMetaObject::Connection m_windowStateChangeConnection = {};
     QMetaObject::Connection m_windowActiveChangeConnection = {};
     QMetaObject::Connection m_windowTitleChangeConnection = {};
+    QMetaObject::Connection m_windowVisibleChangeConnection = {};
+    QSizeF m_windowIconSize = {};
     bool m_extended = false;
     bool m_hideWhenClose = false;
     QuickChromePalette *m_chromePalette = nullptr;
-    bool m_closeTriggered = false;
+    ClickDisambiguator *m_iconClickHandler = nullptr;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -45,8 +45,10 @@ public:
 
     void initialize();
     void rebindWindow();
+    void setResourcesReleased(const bool value);
 
     WindowBorderPainter *borderPainter = nullptr;
+    bool resourcesReleased = false;
     QMetaObject::Connection activeChangeConnection = {};
     QMetaObject::Connection visibilityChangeConnection = {};
 };
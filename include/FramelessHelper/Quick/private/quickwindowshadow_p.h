@@ -0,0 +1,64 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <QtQuick/qquickitem.h>
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Scene graph counterpart of the client side shadow painted by the Qt Widgets module.
+// The item covers the whole window and moves the window content item inwards, so that
+// the user interface stays out of the shadow area. The shadow is made of eight image
+// nodes which share one small texture, see WindowShadow.
+class FRAMELESSHELPER_QUICK_API QuickWindowShadow : public QQuickItem
+{
+    FRAMELESSHELPER_QT_CLASS(QuickWindowShadow)
+
+public:
+    explicit QuickWindowShadow(QQuickItem *parent = nullptr);
+    ~QuickWindowShadow() override;
+
+protected:
+    Q_NODISCARD QSGNode *updatePaintNode(QSGNode *old, UpdatePaintNodeData *data) override;
+    void itemChange(const ItemChange change, const ItemChangeData &value) override;
+
+private Q_SLOTS:
+    void updateLayout();
+
+private:
+    void rebindWindow();
+
+private:
+    QPointer<QQuickWindow> m_window = nullptr;
+    QList<QMetaObject::Connection> m_connections = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -75,6 +75,7 @@ Q_SIGNALS:
     void fallbackEnabledChanged();
 
 protected:
+    Q_NODISCARD QSGNode *updatePaintNode(QSGNode *old, UpdatePaintNodeData *data) override;
     void itemChange(const ItemChange change, const ItemChangeData &value) override;
     void classBegin() override;
     void componentComplete() override;
@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
+#include <memory>
+
+#if FRAMELESSHELPER_CONFIG(window)
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class FramelessDialog;
+
+class FramelessDialogPoolPrivate;
+class FRAMELESSHELPER_WIDGETS_API FramelessDialogPool : public QObject
+{
+    FRAMELESSHELPER_PUBLIC_QT_CLASS(FramelessDialogPool)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged FINAL)
+    Q_PROPERTY(qint64 memoryLimit READ memoryLimit WRITE setMemoryLimit NOTIFY memoryLimitChanged FINAL)
+    Q_PROPERTY(int availableCount READ availableCount NOTIFY availableCountChanged FINAL)
+
+public:
+    explicit FramelessDialogPool(QObject *parent = nullptr);
+    ~FramelessDialogPool() override;
+
+    // How many idle dialogs are kept ready to be handed out.
+    Q_NODISCARD int capacity() const;
+    void setCapacity(const int value);
+
+    // In bytes. Estimated from the size of the backing store of each idle dialog.
+    Q_NODISCARD qint64 memoryLimit() const;
+    void setMemoryLimit(const qint64 value);
+
+    Q_NODISCARD int availableCount() const;
+
+    // Hands out a dialog which has already been created and attached. The content widget
+    // is owned by the dialog and will be destroyed once the dialog returns to the pool,
+    // which happens automatically when it gets hidden. Widgets added to the dialog by any
+    // other means are left alone. A new dialog is created on the spot when the pool is empty.
+    // The dialog is centered over the window of the parent widget, which only becomes its
+    // transient parent: unlike a QDialog constructed with a parent, it is NOT destroyed
+    // together with the parent and has to be hidden (or released) to go back to the pool.
+    Q_NODISCARD FramelessDialog *acquire(QWidget *content = nullptr, QWidget *parent = nullptr);
+
+public Q_SLOTS:
+    void release(FramelessDialog *dialog);
+    void warmUp();
+    // Destroys all the idle dialogs. The ones in use are destroyed when they come back.
+    void clear();
+
+Q_SIGNALS:
+    void capacityChanged();
+    void memoryLimitChanged();
+    void availableCountChanged();
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif
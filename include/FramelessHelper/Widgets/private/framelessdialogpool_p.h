@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
+
+#if FRAMELESSHELPER_CONFIG(window)
+
+#include <QtCore/qtimer.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class FramelessDialog;
+
+class FramelessDialogPool;
+class FRAMELESSHELPER_WIDGETS_API FramelessDialogPoolPrivate : public QObject
+{
+    FRAMELESSHELPER_PRIVATE_QT_CLASS(FramelessDialogPool)
+
+public:
+    struct Entry
+    {
+        QPointer<FramelessDialog> dialog = nullptr;
+        // Dialogs created before the last theme or screen change are not reused.
+        quint64 generation = 0;
+        // The widget acquire() put into the dialog, the only child we destroy on recycling.
+        // Everything else belongs to the dialog itself, e.g. the performance overlay.
+        QPointer<QWidget> content; // Initializing it with nullptr causes compilation errors on old Qt versions (< 5.15).
+        // The window of the parent widget passed to acquire(), the dialog is centered over it.
+        QPointer<QWidget> parentWindow; // Initializing it with nullptr causes compilation errors on old Qt versions (< 5.15).
+    };
+
+    explicit FramelessDialogPoolPrivate(FramelessDialogPool *q);
+    ~FramelessDialogPoolPrivate() override;
+
+    Q_NODISCARD FramelessDialog *createDialog();
+    Q_NODISCARD FramelessDialog *takeIdleDialog();
+    Q_NODISCARD qint64 idleMemoryCost() const;
+    Q_NODISCARD static qint64 estimateMemoryCost(const QWidget *widget);
+    void scheduleWarmUp();
+    void recycle(FramelessDialog *dialog);
+    void dropIdleDialogs();
+    void purgeDeadEntries();
+
+protected:
+    Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
+
+private Q_SLOTS:
+    void warmUpOne();
+    void handleDialogReady();
+    void invalidate();
+
+public:
+    int capacity = 2;
+    qint64 memoryLimit = (qint64(32) * 1024 * 1024);
+    quint64 generation = 0;
+    QList<Entry> warmingDialogs = {};
+    QList<Entry> idleDialogs = {};
+    QList<Entry> loanedDialogs = {};
+    QTimer warmUpTimer{};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif
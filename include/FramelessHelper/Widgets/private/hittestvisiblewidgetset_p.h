@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
+#include <QtCore/qset.h>
+
+QT_BEGIN_NAMESPACE
+class QWidget;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The hit test only looks at the visible and enabled widgets, which are tracked through
+// their events instead of asking every registered widget on each mouse event. Destroyed
+// widgets are dropped immediately.
+class FRAMELESSHELPER_WIDGETS_API HitTestVisibleWidgetSet : public QObject
+{
+    FRAMELESSHELPER_QT_CLASS(HitTestVisibleWidgetSet)
+
+public:
+    explicit HitTestVisibleWidgetSet(QObject *parent = nullptr);
+    ~HitTestVisibleWidgetSet() override;
+
+    void insert(QWidget *widget);
+    void remove(QWidget *widget);
+
+    Q_NODISCARD const QSet<QWidget *> &activeWidgets() const;
+
+protected:
+    Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
+
+private:
+    void updateActiveState(QWidget *widget, const bool visible);
+
+private:
+    QSet<const QObject *> m_widgets = {};
+    QSet<QWidget *> m_activeWidgets = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
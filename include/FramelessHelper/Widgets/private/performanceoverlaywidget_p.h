@@ -0,0 +1,55 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
+#include <QtCore/qtimer.h>
+#include <QtWidgets/qwidget.h>
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Shows the numbers collected by PerformanceMonitor on top of all the other children of
+// the window. It never takes the mouse or the keyboard focus, see WidgetsSharedHelper.
+class FRAMELESSHELPER_WIDGETS_API PerformanceOverlayWidget : public QWidget
+{
+    FRAMELESSHELPER_QT_CLASS(PerformanceOverlayWidget)
+
+public:
+    explicit PerformanceOverlayWidget(QWidget *window);
+    ~PerformanceOverlayWidget() override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    const QObject *m_window = nullptr;
+    QTimer m_refreshTimer{};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(performance_overlay)
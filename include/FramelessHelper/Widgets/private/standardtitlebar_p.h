@@ -40,6 +40,7 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 class StandardSystemButton;
 #endif
 class ChromePalette;
+class ClickDisambiguator;
 
 class StandardTitleBar;
 class FRAMELESSHELPER_WIDGETS_API StandardTitleBarPrivate : public QObject
@@ -73,6 +74,7 @@ public:
     Q_NODISCARD bool mouseEventHandler(QMouseEvent *event);
 
     void initialize();
+    void initializeChildren();
 
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
     StandardSystemButton *minimizeButton = nullptr;
@@ -88,7 +90,8 @@ public:
     std::optional<QSize> windowIconSize = std::nullopt;
     bool windowIconVisible = false;
     std::optional<QFont> titleFont = std::nullopt;
-    bool closeTriggered = false;
+    ClickDisambiguator *iconClickHandler = nullptr;
+    bool childrenInitialized = false;
 
 protected:
     bool eventFilter(QObject *object, QEvent *event) override;
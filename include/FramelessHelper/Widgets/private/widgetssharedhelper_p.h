@@ -25,7 +25,15 @@
 #pragma once
 
 #include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
+#include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <QtCore/qmargins.h>
 #include <QtGui/qscreen.h>
+#include <QtGui/qregion.h>
+#include <array>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -35,6 +43,9 @@ class MicaMaterial;
 #if FRAMELESSHELPER_CONFIG(border_painter)
 class WindowBorderPainter;
 #endif
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+class PerformanceOverlayWidget;
+#endif
 
 class FRAMELESSHELPER_WIDGETS_API WidgetsSharedHelper : public QObject
 {
@@ -67,12 +78,23 @@ private Q_SLOTS:
 
 private:
 #if FRAMELESSHELPER_CONFIG(mica_material)
-    void repaintMica();
+    void repaintMica(const QRegion &exposedRegion);
+    void updateMicaRegion();
 #endif
 #if FRAMELESSHELPER_CONFIG(border_painter)
     void repaintBorder();
 #endif
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+    void updatePerformanceOverlay();
+#endif
+    Q_NODISCARD WindowStateFlags currentWindowStateFlags() const;
     void emitCustomWindowStateSignals();
+    Q_NODISCARD bool shouldEraseCorners() const;
+    Q_NODISCARD bool shouldPaintShadow() const;
+    Q_NODISCARD QMargins shadowMargins() const;
+    Q_NODISCARD std::array<QRect, 4> cornerRects() const;
+    void paintShadow(QPainter *painter) const;
+    void eraseCorners();
 
 Q_SIGNALS:
 #if FRAMELESSHELPER_CONFIG(mica_material)
@@ -89,11 +111,26 @@ private:
     bool m_micaEnabled = false;
     MicaMaterial *m_micaMaterial = nullptr;
     QMetaObject::Connection m_micaRedrawConnection = {};
+    // The part of the window which is not covered by opaque child widgets, in the
+    // coordinates of the target widget.
+    QRegion m_micaRegion = {};
+    QList<QPointer<QWidget>> m_opaqueWidgets = {};
+    // All the child widgets of the window, their events tell us when the region above
+    // becomes outdated, so we never need to walk through the whole widget tree to find out.
+    QList<QPointer<QWidget>> m_watchedWidgets = {};
+    bool m_micaRegionDirty = true;
 #endif
 #if FRAMELESSHELPER_CONFIG(border_painter)
     WindowBorderPainter *m_borderPainter = nullptr;
     QMetaObject::Connection m_borderRepaintConnection = {};
 #endif
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+    // Only created if Option::EnablePerformanceOverlay is set.
+    // A child of the target widget, so anyone deleting the children may take it away.
+    QPointer<PerformanceOverlayWidget> m_performanceOverlay; // Initializing it with nullptr causes compilation errors on old Qt versions (< 5.15).
+#endif
+    // The states we notified last time, so that only the really changed ones get notified.
+    WindowStateFlags m_windowStateFlags = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -31,6 +31,7 @@ HEADERS += \
     $$CORE_PUB_INC_DIR/micamaterial.h \
     $$CORE_PUB_INC_DIR/utils.h \
     $$CORE_PUB_INC_DIR/windowborderpainter.h \
+    $$CORE_PUB_INC_DIR/windowstatestore.h \
     $$CORE_PRIV_INC_DIR/chromepalette_p.h \
     $$CORE_PRIV_INC_DIR/framelessconfig_p.h \
     $$CORE_PRIV_INC_DIR/framelessmanager_p.h \
@@ -39,18 +40,36 @@ HEADERS += \
     $$CORE_PRIV_INC_DIR/windowborderpainter_p.h \
     $$CORE_PRIV_INC_DIR/framelesshelpercore_global_p.h \
     $$CORE_PRIV_INC_DIR/versionnumber_p.h \
-    $$CORE_PRIV_INC_DIR/scopeguard_p.h
+    $$CORE_PRIV_INC_DIR/scopeguard_p.h \
+    $$CORE_PRIV_INC_DIR/hittestengine_p.h \
+    $$CORE_PRIV_INC_DIR/moveresizeengine_p.h \
+    $$CORE_PRIV_INC_DIR/clickdisambiguator_p.h \
+    $$CORE_PRIV_INC_DIR/diagnosticslog_p.h \
+    $$CORE_PRIV_INC_DIR/roundedcorners_p.h \
+    $$CORE_PRIV_INC_DIR/windowshadow_p.h \
+    $$CORE_PRIV_INC_DIR/backgroundexecutor_p.h \
+    $$CORE_PRIV_INC_DIR/windowstatestore_p.h \
+    $$CORE_PRIV_INC_DIR/performancemonitor_p.h
 
 SOURCES += \
+    $$CORE_SRC_DIR/backgroundexecutor.cpp \
     $$CORE_SRC_DIR/chromepalette.cpp \
+    $$CORE_SRC_DIR/diagnosticslog.cpp \
     $$CORE_SRC_DIR/framelessconfig.cpp \
     $$CORE_SRC_DIR/framelesshelper_qt.cpp \
     $$CORE_SRC_DIR/framelessmanager.cpp \
     $$CORE_SRC_DIR/framelesshelpercore_global.cpp \
+    $$CORE_SRC_DIR/hittestengine.cpp \
     $$CORE_SRC_DIR/micamaterial.cpp \
+    $$CORE_SRC_DIR/moveresizeengine.cpp \
+    $$CORE_SRC_DIR/clickdisambiguator.cpp \
+    $$CORE_SRC_DIR/roundedcorners.cpp \
     $$CORE_SRC_DIR/sysapiloader.cpp \
     $$CORE_SRC_DIR/utils.cpp \
-    $$CORE_SRC_DIR/windowborderpainter.cpp
+    $$CORE_SRC_DIR/windowborderpainter.cpp \
+    $$CORE_SRC_DIR/windowshadow.cpp \
+    $$CORE_SRC_DIR/windowstatestore.cpp \
+    $$CORE_SRC_DIR/performancemonitor.cpp
 
 RESOURCES += \
     $$CORE_SRC_DIR/framelesshelpercore.qrc
@@ -75,10 +94,12 @@ unix:!macx {
     PKGCONFIG += xcb gtk+-3.0
     DEFINES += GDK_VERSION_MIN_REQUIRED=GDK_VERSION_3_6
     HEADERS += \
-        $$CORE_PUB_INC_DIR/framelesshelper_linux.h
+        $$CORE_PUB_INC_DIR/framelesshelper_linux.h \
+        $$CORE_PRIV_INC_DIR/x11windowstatemirror_p.h
     SOURCES += \
         $$CORE_SRC_DIR/utils_linux.cpp \
-        $$CORE_SRC_DIR/platformsupport_linux.cpp
+        $$CORE_SRC_DIR/platformsupport_linux.cpp \
+        $$CORE_SRC_DIR/x11windowstatemirror.cpp
 }
 
 macx {
@@ -32,6 +32,7 @@ HEADERS += \
     $$QUICK_PUB_INC_DIR/quickwindowborder.h \
     $$QUICK_PRIV_INC_DIR/quickstandardsystembutton_p.h \
     $$QUICK_PRIV_INC_DIR/quickstandardtitlebar_p.h \
+    $$QUICK_PRIV_INC_DIR/quickcompacttitlebar_p.h \
     $$QUICK_PRIV_INC_DIR/framelessquickhelper_p.h \
     $$QUICK_PRIV_INC_DIR/framelessquickwindow_p.h \
     $$QUICK_PRIV_INC_DIR/framelessquickwindow_p_p.h \
@@ -39,11 +40,16 @@ HEADERS += \
     $$QUICK_PRIV_INC_DIR/framelessquickapplicationwindow_p_p.h \
     $$QUICK_PRIV_INC_DIR/quickmicamaterial_p.h \
     $$QUICK_PRIV_INC_DIR/quickimageitem_p.h \
-    $$QUICK_PRIV_INC_DIR/quickwindowborder_p.h
+    $$QUICK_PRIV_INC_DIR/quickwindowborder_p.h \
+    $$QUICK_PRIV_INC_DIR/quickwindowshadow_p.h \
+    $$QUICK_PRIV_INC_DIR/quickperformanceoverlay_p.h \
+    $$QUICK_PRIV_INC_DIR/quickdecorationtexturecache_p.h \
+    $$QUICK_PRIV_INC_DIR/hittestvisibleitemset_p.h
 
 SOURCES += \
     $$QUICK_SRC_DIR/quickstandardsystembutton.cpp \
     $$QUICK_SRC_DIR/quickstandardtitlebar.cpp \
+    $$QUICK_SRC_DIR/quickcompacttitlebar.cpp \
     $$QUICK_SRC_DIR/framelessquickutils.cpp \
     $$QUICK_SRC_DIR/framelessquickmodule.cpp \
     $$QUICK_SRC_DIR/framelessquickwindow.cpp \
@@ -53,4 +59,8 @@ SOURCES += \
     $$QUICK_SRC_DIR/framelesshelperquick_global.cpp \
     $$QUICK_SRC_DIR/quickmicamaterial.cpp \
     $$QUICK_SRC_DIR/quickimageitem.cpp \
-    $$QUICK_SRC_DIR/quickwindowborder.cpp
+    $$QUICK_SRC_DIR/quickwindowborder.cpp \
+    $$QUICK_SRC_DIR/quickwindowshadow.cpp \
+    $$QUICK_SRC_DIR/quickperformanceoverlay.cpp \
+    $$QUICK_SRC_DIR/quickdecorationtexturecache.cpp \
+    $$QUICK_SRC_DIR/hittestvisibleitemset.cpp
@@ -0,0 +1,201 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "backgroundexecutor_p.h"
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#if QT_CONFIG(thread)
+#  include <QtCore/qrunnable.h>
+#  include <QtCore/qthread.h>
+#  include <QtCore/qthreadpool.h>
+#  include <QtCore/qthreadstorage.h>
+#endif // QT_CONFIG(thread)
+#ifdef Q_OS_WINDOWS
+#  include "framelesshelper_windows.h"
+#elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+#  include <sched.h>
+#  include <sys/resource.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#elif defined(Q_OS_MACOS)
+#  include <pthread.h>
+#  include <sys/qos.h>
+#endif
+#include <algorithm>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcBackgroundExecutor, "wangwenx190.framelesshelper.core.backgroundexecutor")
+#  define INFO qCInfo(lcBackgroundExecutor)
+#  define DEBUG qCDebug(lcBackgroundExecutor)
+#  define WARNING qCWarning(lcBackgroundExecutor)
+#  define CRITICAL qCCritical(lcBackgroundExecutor)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+// From linux/ioprio.h, which is not shipped by all distributions.
+[[maybe_unused]] static constexpr const int kIoPrioWhoProcess = 1;
+[[maybe_unused]] static constexpr const int kIoPrioClassIdle = 3;
+[[maybe_unused]] static constexpr const int kIoPrioClassShift = 13;
+#endif
+
+struct ExecutorData
+{
+    QMutex mutex{};
+    BackgroundTaskRunner runner = nullptr;
+#if QT_CONFIG(thread)
+    QThreadPool pool{};
+
+    ExecutorData()
+    {
+        pool.setMaxThreadCount(BackgroundExecutor::maxThreadCount());
+    }
+#endif
+};
+Q_GLOBAL_STATIC(ExecutorData, g_executorData)
+
+#if QT_CONFIG(thread)
+class BackgroundRunnable : public QRunnable
+{
+public:
+    explicit BackgroundRunnable(BackgroundTask &&task) : m_task(std::move(task))
+    {
+        setAutoDelete(true);
+    }
+    ~BackgroundRunnable() override = default;
+
+    void run() override
+    {
+        // The pool threads are never handed out to anyone else, so lowering the priority
+        // once per thread is enough.
+        static QThreadStorage<bool> lowered = {};
+        if (!lowered.hasLocalData()) {
+            lowered.setLocalData(true);
+            BackgroundExecutor::lowerCurrentThreadPriority();
+        }
+        m_task();
+    }
+
+private:
+    BackgroundTask m_task = nullptr;
+};
+#endif // QT_CONFIG(thread)
+
+void BackgroundExecutor::post(BackgroundTask task)
+{
+    Q_ASSERT(task);
+    if (!task) {
+        return;
+    }
+    BackgroundTaskRunner runner = nullptr;
+    {
+        const QMutexLocker locker(&g_executorData()->mutex);
+        runner = g_executorData()->runner;
+    }
+    if (runner) {
+        runner(std::move(task));
+        return;
+    }
+#if QT_CONFIG(thread)
+    g_executorData()->pool.start(new BackgroundRunnable(std::move(task)));
+#else // !QT_CONFIG(thread)
+    task();
+#endif // QT_CONFIG(thread)
+}
+
+void BackgroundExecutor::setTaskRunner(const BackgroundTaskRunner &runner)
+{
+    const QMutexLocker locker(&g_executorData()->mutex);
+    g_executorData()->runner = runner;
+}
+
+bool BackgroundExecutor::hasCustomTaskRunner()
+{
+    const QMutexLocker locker(&g_executorData()->mutex);
+    return bool(g_executorData()->runner);
+}
+
+void BackgroundExecutor::waitForDone()
+{
+#if QT_CONFIG(thread)
+    if (g_executorData.isDestroyed()) {
+        return;
+    }
+    g_executorData()->pool.waitForDone();
+#endif // QT_CONFIG(thread)
+}
+
+int BackgroundExecutor::maxThreadCount()
+{
+#if QT_CONFIG(thread)
+    // Leave most of the cores to the application, the background work is never urgent.
+    static const int result = std::clamp((QThread::idealThreadCount() / 4), 1, 2);
+    return result;
+#else // !QT_CONFIG(thread)
+    return 1;
+#endif // QT_CONFIG(thread)
+}
+
+void BackgroundExecutor::lowerCurrentThreadPriority()
+{
+#ifdef Q_OS_WINDOWS
+    // Lowers both the CPU and the I/O (and memory) priority of the calling thread.
+    if (::SetThreadPriority(::GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN) == FALSE) {
+        WARNING << "Failed to switch the background thread to the background mode.";
+    }
+#elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    // On Linux the scheduling attributes are per thread, zero means the calling thread.
+    const sched_param param = {};
+    if (::sched_setscheduler(0, SCHED_IDLE, &param) != 0) {
+        // SCHED_IDLE may be forbidden by the security policy, the lowest nice value is
+        // the next best thing.
+        if (::setpriority(PRIO_PROCESS, pid_t(::syscall(SYS_gettid)), 19) != 0) {
+            WARNING << "Failed to lower the CPU priority of the background thread.";
+        }
+    }
+#  ifdef SYS_ioprio_set
+    if (::syscall(SYS_ioprio_set, kIoPrioWhoProcess, 0, (kIoPrioClassIdle << kIoPrioClassShift)) != 0) {
+        WARNING << "Failed to lower the I/O priority of the background thread.";
+    }
+#  endif // SYS_ioprio_set
+#elif defined(Q_OS_MACOS)
+    // The background QoS class also throttles the disk and network I/O.
+    if (::pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0) != 0) {
+        WARNING << "Failed to switch the background thread to the background QoS class.";
+    }
+#elif QT_CONFIG(thread)
+    QThread::currentThread()->setPriority(QThread::IdlePriority);
+#endif
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/backgroundexecutor_p.h"
@@ -28,6 +28,7 @@
 #if FRAMELESSHELPER_CONFIG(titlebar)
 
 #include "framelessmanager.h"
+#include "framelessmanager_p.h"
 #include "utils.h"
 #include <QtCore/qloggingcategory.h>
 
@@ -48,6 +49,60 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+struct SystemChromeColors
+{
+    QColor titleBarActiveBackgroundColor = {};
+    QColor titleBarInactiveBackgroundColor = {};
+    QColor titleBarActiveForegroundColor = {};
+    QColor titleBarInactiveForegroundColor = {};
+    QColor chromeButtonNormalColor = {};
+    QColor chromeButtonHoverColor = {};
+    QColor chromeButtonPressColor = {};
+    QColor closeButtonNormalColor = {};
+    QColor closeButtonHoverColor = {};
+    QColor closeButtonPressColor = {};
+};
+
+// The system colors are the same for all palettes, only calculate them once per theme change.
+[[nodiscard]] static inline const SystemChromeColors &systemChromeColors()
+{
+    static SystemChromeColors colors = {};
+    static std::optional<quint64> generation = std::nullopt;
+    const quint64 currentGeneration = FramelessManagerPrivate::themeGeneration();
+    if (generation.has_value() && (generation.value() == currentGeneration)) {
+        return colors;
+    }
+    generation = currentGeneration;
+    const bool colorized = Utils::isTitleBarColorized();
+    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
+    colors.titleBarActiveBackgroundColor = [colorized, dark]() -> QColor {
+        if (colorized) {
+            return Utils::getAccentColor();
+        } else {
+            return (dark ? kDefaultBlackColor : kDefaultWhiteColor);
+        }
+    }();
+    colors.titleBarInactiveBackgroundColor = (dark ? kDefaultSystemDarkColor : kDefaultWhiteColor);
+    colors.titleBarActiveForegroundColor = [dark, colorized]() -> QColor {
+        if (dark || colorized) {
+            return Utils::calculateForegroundColor(colors.titleBarActiveBackgroundColor);
+        }
+        return kDefaultBlackColor;
+    }();
+    colors.titleBarInactiveForegroundColor = kDefaultDarkGrayColor;
+    colors.chromeButtonNormalColor = kDefaultTransparentColor;
+    colors.chromeButtonHoverColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Hovered);
+    colors.chromeButtonPressColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Pressed);
+    colors.closeButtonNormalColor = kDefaultTransparentColor;
+    colors.closeButtonHoverColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Hovered);
+    colors.closeButtonPressColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Pressed);
+    return colors;
+}
+
 ChromePalettePrivate::ChromePalettePrivate(ChromePalette *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -55,11 +110,14 @@ ChromePalettePrivate::ChromePalettePrivate(ChromePalette *q) : QObject(q)
         return;
     }
     q_ptr = q;
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged, this, &ChromePalettePrivate::refresh);
+    FramelessManagerPrivate::addThemeSubscriber(this, [this](){ refresh(); });
     refresh();
 }
 
-ChromePalettePrivate::~ChromePalettePrivate() = default;
+ChromePalettePrivate::~ChromePalettePrivate()
+{
+    FramelessManagerPrivate::removeThemeSubscriber(this);
+}
 
 ChromePalettePrivate *ChromePalettePrivate::get(ChromePalette *q)
 {
@@ -81,33 +139,17 @@ const ChromePalettePrivate *ChromePalettePrivate::get(const ChromePalette *q)
 
 void ChromePalettePrivate::refresh()
 {
-    const bool colorized = Utils::isTitleBarColorized();
-    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
-    titleBarActiveBackgroundColor_sys = [colorized, dark]() -> QColor {
-        if (colorized) {
-            return Utils::getAccentColor();
-        } else {
-            return (dark ? kDefaultBlackColor : kDefaultWhiteColor);
-        }
-    }();
-    titleBarInactiveBackgroundColor_sys = (dark ? kDefaultSystemDarkColor : kDefaultWhiteColor);
-    titleBarActiveForegroundColor_sys = [this, dark, colorized]() -> QColor {
-        if (dark || colorized) {
-            return Utils::calculateForegroundColor(titleBarActiveBackgroundColor_sys);
-        }
-        return kDefaultBlackColor;
-    }();
-    titleBarInactiveForegroundColor_sys = kDefaultDarkGrayColor;
-    chromeButtonNormalColor_sys = kDefaultTransparentColor;
-    chromeButtonHoverColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Hovered);
-    chromeButtonPressColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Pressed);
-    closeButtonNormalColor_sys = kDefaultTransparentColor;
-    closeButtonHoverColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Hovered);
-    closeButtonPressColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Pressed);
+    const SystemChromeColors &colors = systemChromeColors();
+    titleBarActiveBackgroundColor_sys = colors.titleBarActiveBackgroundColor;
+    titleBarInactiveBackgroundColor_sys = colors.titleBarInactiveBackgroundColor;
+    titleBarActiveForegroundColor_sys = colors.titleBarActiveForegroundColor;
+    titleBarInactiveForegroundColor_sys = colors.titleBarInactiveForegroundColor;
+    chromeButtonNormalColor_sys = colors.chromeButtonNormalColor;
+    chromeButtonHoverColor_sys = colors.chromeButtonHoverColor;
+    chromeButtonPressColor_sys = colors.chromeButtonPressColor;
+    closeButtonNormalColor_sys = colors.closeButtonNormalColor;
+    closeButtonHoverColor_sys = colors.closeButtonHoverColor;
+    closeButtonPressColor_sys = colors.closeButtonPressColor;
     Q_Q(ChromePalette);
     Q_EMIT q->titleBarActiveBackgroundColorChanged();
     Q_EMIT q->titleBarInactiveBackgroundColorChanged();
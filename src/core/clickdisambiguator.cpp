@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "clickdisambiguator_p.h"
+#include <QtCore/qloggingcategory.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qstylehints.h>
+#include <utility>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcClickDisambiguator, "wangwenx190.framelesshelper.core.clickdisambiguator")
+#  define INFO qCInfo(lcClickDisambiguator)
+#  define DEBUG qCDebug(lcClickDisambiguator)
+#  define WARNING qCWarning(lcClickDisambiguator)
+#  define CRITICAL qCCritical(lcClickDisambiguator)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+ClickDisambiguator::ClickDisambiguator(QObject *parent) : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &ClickDisambiguator::fire);
+}
+
+ClickDisambiguator::~ClickDisambiguator() = default;
+
+bool ClickDisambiguator::isPending() const
+{
+    return m_timer.isActive();
+}
+
+void ClickDisambiguator::press(const Qt::MouseButton button, const quint64 timestamp)
+{
+    // Don't cancel anything here: QPA delivers the double click event right after
+    // the second press, so the timer can't fire in between.
+    m_pressButton = button;
+    m_pressTimestamp = timestamp;
+}
+
+void ClickDisambiguator::release(const Qt::MouseButton button, const quint64 timestamp, const Callback &callback)
+{
+    Q_ASSERT(callback);
+    if (!callback) {
+        return;
+    }
+    if (m_ignoreNextRelease) {
+        // This is the second half of a double click, which has been handled already.
+        m_ignoreNextRelease = false;
+        return;
+    }
+    cancel();
+    // Fallback to the release time if we didn't see the press, the double click
+    // interval is measured from the first press so this only makes us wait longer.
+    const bool pressKnown = ((m_pressButton == button) && (m_pressTimestamp > 0) && (m_pressTimestamp <= timestamp));
+    const quint64 pressTimestamp = (pressKnown ? m_pressTimestamp : timestamp);
+    m_pressButton = Qt::NoButton;
+    m_pressTimestamp = 0;
+    const int interval = QGuiApplication::styleHints()->mouseDoubleClickInterval();
+    const int delay = calculateDelay(button, pressTimestamp, timestamp, interval);
+    if (delay <= 0) {
+        callback();
+        return;
+    }
+    DEBUG << "Delaying the single click action for" << delay << "milliseconds.";
+    m_callback = callback;
+    m_timer.start(delay);
+}
+
+void ClickDisambiguator::doubleClick()
+{
+    cancel();
+    m_ignoreNextRelease = true;
+}
+
+void ClickDisambiguator::cancel()
+{
+    m_timer.stop();
+    m_callback = nullptr;
+}
+
+int ClickDisambiguator::calculateDelay(const Qt::MouseButton button, const quint64 pressTimestamp,
+    const quint64 releaseTimestamp, const int doubleClickInterval)
+{
+    // Only the left button double clicks mean anything to us.
+    if ((button != Qt::LeftButton) || (doubleClickInterval <= 0)) {
+        return 0;
+    }
+    const quint64 deadline = (pressTimestamp + quint64(doubleClickInterval));
+    // The button was held down longer than the double click interval, the next
+    // press can't be recognized as a double click anymore.
+    if (releaseTimestamp >= deadline) {
+        return 0;
+    }
+    return int(deadline - releaseTimestamp);
+}
+
+void ClickDisambiguator::fire()
+{
+    // Reset the state first, the callback may start a nested event loop (the system menu).
+    const Callback callback = std::exchange(m_callback, nullptr);
+    if (callback) {
+        callback();
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/clickdisambiguator_p.h"
@@ -0,0 +1,248 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "diagnosticslog_p.h"
+
+#if FRAMELESSHELPER_CONFIG(diagnostics_log)
+
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#ifdef Q_OS_WINDOWS
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Must be a power of two.
+static constexpr const quint64 kRingBufferSize = 4096;
+static_assert((kRingBufferSize & (kRingBufferSize - 1)) == 0);
+
+static constexpr const std::array<const char *, int(DiagnosticsEvent::Last) + 1> g_eventNames =
+{
+    "None",
+    "WindowAdded",
+    "WindowRemoved",
+    "HitTest",
+    "SystemMoveStarted",
+    "SystemResizeStarted",
+    "SoftwareMoveResizeStarted",
+    "ThemeChanged",
+    "WallpaperChanged",
+    "WallpaperGenerationStarted",
+    "WallpaperGenerationFinished"
+};
+
+struct DiagnosticsSlot
+{
+    // A tiny seqlock: zero while the payload is being written, the global
+    // sequence number of the record (starting from one) after that.
+    std::atomic<quint64> sequence = 0;
+    quint64 timestamp = 0;
+    quint64 windowId = 0;
+    quintptr arguments[3] = { 0, 0, 0 };
+    DiagnosticsEvent event = DiagnosticsEvent::None;
+};
+
+struct DiagnosticsRingBuffer
+{
+    std::atomic<quint64> cursor = 0;
+    std::atomic_bool enabled = true;
+    std::array<DiagnosticsSlot, kRingBufferSize> slots = {};
+};
+
+// Plain static storage instead of Q_GLOBAL_STATIC: the buffer must stay usable
+// from signal handlers and during application exit.
+static DiagnosticsRingBuffer g_ringBuffer = {};
+
+[[nodiscard]] static inline quint64 currentTimestamp() noexcept
+{
+    using namespace std::chrono;
+    return quint64(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+[[nodiscard]] static inline bool readSlot(const DiagnosticsSlot &slot, DiagnosticsRecord *record) noexcept
+{
+    const quint64 before = slot.sequence.load(std::memory_order_acquire);
+    if (before == 0) {
+        return false;
+    }
+    record->sequence = before;
+    record->timestamp = slot.timestamp;
+    record->windowId = slot.windowId;
+    std::memcpy(record->arguments, slot.arguments, sizeof(record->arguments));
+    record->event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The slot has been overwritten while we were reading it, drop it.
+    return (slot.sequence.load(std::memory_order_relaxed) == before);
+}
+
+// Formats the record into the given buffer without any heap allocation.
+static inline int formatRecord(const DiagnosticsRecord &record, char *buffer, const int size) noexcept
+{
+    int length = 0;
+    const auto append = [buffer, size, &length](const char *str) noexcept {
+        while (*str && (length < (size - 1))) {
+            buffer[length++] = *str++;
+        }
+    };
+    const auto appendNumber = [&append](quint64 value, const int base) noexcept {
+        static constexpr const char digits[] = "0123456789abcdef";
+        char text[24] = {};
+        int pos = int(sizeof(text)) - 1;
+        do {
+            text[--pos] = digits[value % quint64(base)];
+            value /= quint64(base);
+        } while (value && (pos > 0));
+        if (base == 16) {
+            text[--pos] = 'x';
+            text[--pos] = '0';
+        }
+        append(text + pos);
+    };
+    append("#");
+    appendNumber(record.sequence, 10);
+    append(" t=");
+    appendNumber(record.timestamp / 1000, 10);
+    append("us ");
+    append(DiagnosticsLog::eventName(record.event));
+    append(" window=");
+    appendNumber(record.windowId, 16);
+    for (auto &&argument : record.arguments) {
+        append(" ");
+        appendNumber(argument, 16);
+    }
+    append("\n");
+    buffer[length] = '\0';
+    return length;
+}
+
+void DiagnosticsLog::record(const DiagnosticsEvent event, const quint64 windowId,
+    const quintptr arg0, const quintptr arg1, const quintptr arg2) noexcept
+{
+    if (!g_ringBuffer.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const quint64 index = g_ringBuffer.cursor.fetch_add(1, std::memory_order_relaxed);
+    DiagnosticsSlot &slot = g_ringBuffer.slots[index & (kRingBufferSize - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp = currentTimestamp();
+    slot.windowId = windowId;
+    slot.arguments[0] = arg0;
+    slot.arguments[1] = arg1;
+    slot.arguments[2] = arg2;
+    slot.event = event;
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void DiagnosticsLog::setEnabled(const bool value) noexcept
+{
+    g_ringBuffer.enabled.store(value, std::memory_order_relaxed);
+}
+
+bool DiagnosticsLog::isEnabled() noexcept
+{
+    return g_ringBuffer.enabled.load(std::memory_order_relaxed);
+}
+
+void DiagnosticsLog::clear() noexcept
+{
+    for (auto &&slot : g_ringBuffer.slots) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+int DiagnosticsLog::capacity() noexcept
+{
+    return int(kRingBufferSize);
+}
+
+const char *DiagnosticsLog::eventName(const DiagnosticsEvent event) noexcept
+{
+    const auto index = quint64(event);
+    if (index >= g_eventNames.size()) {
+        return "Unknown";
+    }
+    return g_eventNames[index];
+}
+
+QList<DiagnosticsRecord> DiagnosticsLog::snapshot()
+{
+    const quint64 end = g_ringBuffer.cursor.load(std::memory_order_acquire);
+    const quint64 begin = ((end > kRingBufferSize) ? (end - kRingBufferSize) : 0);
+    QList<DiagnosticsRecord> records = {};
+    records.reserve(int(end - begin));
+    for (quint64 index = begin; index != end; ++index) {
+        DiagnosticsRecord record = {};
+        if (readSlot(g_ringBuffer.slots[index & (kRingBufferSize - 1)], &record) && (record.sequence == (index + 1))) {
+            records.append(record);
+        }
+    }
+    return records;
+}
+
+QString DiagnosticsLog::dump()
+{
+    const QList<DiagnosticsRecord> records = snapshot();
+    QString result = {};
+    char buffer[256] = {};
+    for (auto &&record : std::as_const(records)) {
+        const int length = formatRecord(record, buffer, int(sizeof(buffer)));
+        result.append(QString::fromLatin1(buffer, length));
+    }
+    return result;
+}
+
+void DiagnosticsLog::dumpToFileDescriptor(const int fd) noexcept
+{
+    if (fd < 0) {
+        return;
+    }
+    const quint64 end = g_ringBuffer.cursor.load(std::memory_order_acquire);
+    const quint64 begin = ((end > kRingBufferSize) ? (end - kRingBufferSize) : 0);
+    char buffer[256] = {};
+    for (quint64 index = begin; index != end; ++index) {
+        DiagnosticsRecord record = {};
+        if (!readSlot(g_ringBuffer.slots[index & (kRingBufferSize - 1)], &record) || (record.sequence != (index + 1))) {
+            continue;
+        }
+        const int length = formatRecord(record, buffer, int(sizeof(buffer)));
+#ifdef Q_OS_WINDOWS
+        std::ignore = _write(fd, buffer, unsigned(length));
+#else
+        std::ignore = ::write(fd, buffer, size_t(length));
+#endif
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(diagnostics_log)
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/diagnosticslog_p.h"
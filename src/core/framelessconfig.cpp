@@ -66,7 +66,10 @@ static constexpr const std::array<FramelessConfigEntry, static_cast<int>(Option:
     FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_NON_NATIVE_BACKGROUND_BLUR", "Options/ForceNonNativeBackgroundBlur" },
     FramelessConfigEntry{ "FRAMELESSHELPER_DISABLE_LAZY_INITIALIZATION_FOR_MICA_MATERIAL", "Options/DisableLazyInitializationForMicaMaterial" },
     FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_NATIVE_BACKGROUND_BLUR", "Options/ForceNativeBackgroundBlur" },
-    FramelessConfigEntry{ "FRAMELESSHELPER_WINDOW_USE_SQUARE_CORNERS", "Options/WindowUseSquareCorners" }
+    FramelessConfigEntry{ "FRAMELESSHELPER_WINDOW_USE_SQUARE_CORNERS", "Options/WindowUseSquareCorners" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_ENABLE_CLIENT_SIDE_SHADOW", "Options/EnableClientSideShadow" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_ENABLE_MOUSE_MOVE_COMPRESSION", "Options/EnableMouseMoveCompression" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_ENABLE_PERFORMANCE_OVERLAY", "Options/EnablePerformanceOverlay" }
 };
 
 static constexpr const auto OptionCount = std::size(FramelessOptionsTable);
@@ -109,8 +112,26 @@ static inline void warnInappropriateOptions()
     if (cfg->isSet(Option::ForceNonNativeBackgroundBlur) && cfg->isSet(Option::ForceNativeBackgroundBlur)) {
         WARNING << "Option::ForceNonNativeBackgroundBlur and Option::ForceNativeBackgroundBlur can't be both enabled.";
     }
+#if (!(defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)) || FRAMELESSHELPER_CONFIG(native_impl))
     if (cfg->isSet(Option::WindowUseRoundCorners)) {
-        WARNING << "Option::WindowUseRoundCorners has not been implemented yet.";
+        WARNING << "Option::WindowUseRoundCorners is only implemented for the Qt backend on Linux currently.";
+    }
+    if (cfg->isSet(Option::EnableClientSideShadow)) {
+        WARNING << "Option::EnableClientSideShadow is only implemented for the Qt backend on Linux currently.";
+    }
+#endif
+#if FRAMELESSHELPER_CONFIG(native_impl)
+    if (cfg->isSet(Option::EnableMouseMoveCompression)) {
+        WARNING << "Option::EnableMouseMoveCompression is only implemented for the Qt backend currently.";
+    }
+#endif
+#if !FRAMELESSHELPER_CONFIG(performance_overlay)
+    if (cfg->isSet(Option::EnablePerformanceOverlay)) {
+        WARNING << "Option::EnablePerformanceOverlay has no effect because the performance overlay has been disabled at compile time.";
+    }
+#endif
+    if (cfg->isSet(Option::WindowUseRoundCorners) && cfg->isSet(Option::WindowUseSquareCorners)) {
+        WARNING << "Option::WindowUseRoundCorners and Option::WindowUseSquareCorners can't be both enabled.";
     }
 }
 #endif
@@ -30,10 +30,20 @@
 #include "framelessmanager_p.h"
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
+#include "hittestengine_p.h"
+#include "moveresizeengine_p.h"
+#include "diagnosticslog_p.h"
+#include "performancemonitor_p.h"
+#include "roundedcorners_p.h"
+#include "windowshadow_p.h"
+#include "x11windowstatemirror_p.h"
 #include "utils.h"
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
+#include <QtGui/qscreen.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -52,11 +62,20 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+[[maybe_unused]] static constexpr const qreal kDefaultRefreshRate = 60.0;
+
 struct FramelessDataQt : public FramelessData
 {
     FramelessHelperQt *framelessHelperImpl = nullptr;
     bool cursorShapeChanged = false;
     bool leftButtonPressed = false;
+    HitTestEngine hitTestEngine = {};
+    // Only created when the system can't move or resize the window for us.
+    MoveResizeEngine *moveResizeEngine = nullptr;
+    // The client side shadow area which has been reported to the window manager.
+    QMargins frameExtents = {};
+    // The X Shape input region which has been sent to the X server, in device pixels.
+    QRegion inputRegion = {};
 
     FramelessDataQt();
     ~FramelessDataQt() override;
@@ -76,6 +95,152 @@ using FramelessDataQtPtr = std::shared_ptr<FramelessDataQt>;
     return std::dynamic_pointer_cast<FramelessDataQt>(data);
 }
 
+[[nodiscard]] static inline bool startSoftwareMoveResize(const FramelessDataQtPtr &data,
+    QWindow *window, const Qt::Edges edges, const QPoint &globalPos)
+{
+    Q_ASSERT(data);
+    Q_ASSERT(window);
+    if (!data || !window || !data->framelessHelperImpl) {
+        return false;
+    }
+    if (!data->moveResizeEngine) {
+        data->moveResizeEngine = new MoveResizeEngine(data->framelessHelperImpl);
+    }
+    FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::SoftwareMoveResizeStarted, quint64(data->windowId),
+        quintptr(int(edges)), quintptr(globalPos.x()), quintptr(globalPos.y()));
+    return data->moveResizeEngine->start(window, edges, globalPos);
+}
+
+[[nodiscard]] static inline QMargins shadowMargins(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window || !WindowShadow::isEnabled() || (window->visibility() != QWindow::Windowed)) {
+        return {};
+    }
+    return WindowShadow::margins(WindowShadow::defaultParameters(true, window->devicePixelRatio()));
+}
+
+[[nodiscard]] static inline QRegion scaleRegion(const QRegion &region, const qreal factor)
+{
+    if (region.isEmpty() || qFuzzyCompare(factor, qreal(1))) {
+        return region;
+    }
+    QRegion result = {};
+    for (auto &&rect : region) {
+        result += QRectF(QPointF(rect.topLeft()) * factor, QSizeF(rect.size()) * factor).toAlignedRect();
+    }
+    return result;
+}
+
+// Only the window contents and the resize zones around them should receive the pointer
+// events, the X server lets the events over the rest of the shadow click through.
+[[nodiscard]] static inline QRegion calculateInputRegion(const FramelessDataQtPtr &data, const QWindow *window)
+{
+    Q_ASSERT(data);
+    Q_ASSERT(window);
+    if (!data || !window || !data->callbacks) {
+        return {};
+    }
+    const QMargins margins = shadowMargins(window);
+    if (margins.isNull()) {
+        return {};
+    }
+    const QRect windowRect = { QPoint(0, 0), window->size() };
+    const QRect contentRect = windowRect.marginsRemoved(margins);
+    if (!data->callbacks->isWindowFixedSize()) {
+        static constexpr const auto k = kDefaultResizeBorderThickness;
+        return windowRect.intersected(contentRect.adjusted(-k, -k, k, k));
+    }
+    const int radius = RoundedCorners::radius();
+    if (radius <= 0) {
+        return contentRect;
+    }
+    return RoundedCorners::shapeRegion(contentRect.size(), radius).translated(contentRect.topLeft());
+}
+
+// Aliased X Shape bounding region which cuts the rounded corners out of the window contents,
+// including everything the helpers can't paint over, such as the child widgets. Only the
+// corners are cut, the shadow around the contents is kept.
+[[nodiscard]] static inline QRegion calculateWindowShape(const QWindow *window, const int radius)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(radius > 0);
+    if (!window || (radius <= 0)) {
+        return {};
+    }
+    const QRect windowRect = { QPoint(0, 0), window->size() };
+    const QRect contentRect = windowRect.marginsRemoved(shadowMargins(window));
+    const QRegion contentShape = RoundedCorners::shapeRegion(contentRect.size(), radius).translated(contentRect.topLeft());
+    return (QRegion(windowRect) - (QRegion(contentRect) - contentShape));
+}
+
+static inline void updateWindowShape(const FramelessDataQtPtr &data, QWindow *window)
+{
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    Q_ASSERT(data);
+    Q_ASSERT(window);
+    if (!data || !window) {
+        return;
+    }
+    if (WindowShadow::isEnabled()) {
+        // Let the window manager know which part of the window is the shadow, so that
+        // it can be excluded from snapping and tiling.
+        const QMargins margins = shadowMargins(window);
+        if (margins != data->frameExtents) {
+            data->frameExtents = margins;
+            const qreal dpr = window->devicePixelRatio();
+            Utils::setFrameExtents(window->winId(), QMargins(qRound(margins.left() * dpr),
+                qRound(margins.top() * dpr), qRound(margins.right() * dpr), qRound(margins.bottom() * dpr)));
+        }
+        const QRegion inputRegion = scaleRegion(calculateInputRegion(data, window), window->devicePixelRatio());
+        if (inputRegion != data->inputRegion) {
+            data->inputRegion = inputRegion;
+            Utils::setWindowInputShape(window->winId(), inputRegion);
+        }
+    }
+    // The Qt Widgets module additionally erases the antialiased corners of the window
+    // itself when it has both the alpha channel and a running compositing manager.
+    const int radius = RoundedCorners::radius();
+    const QRegion shape = (((radius > 0) && (window->visibility() == QWindow::Windowed))
+        ? calculateWindowShape(window, radius) : QRegion{});
+    if (window->mask() != shape) {
+        window->setMask(shape);
+    }
+#else // !Q_OS_LINUX
+    Q_UNUSED(data);
+    Q_UNUSED(window);
+#endif // Q_OS_LINUX
+}
+
+// The hover work of a mouse move: the cursor shape of the resize zones. The button
+// transitions and the drag initiation never go through here, they need exact positions.
+static inline void updateCursorShape(const FramelessDataQtPtr &data, QWindow *window, const QPoint &scenePos)
+{
+    Q_ASSERT(data);
+    Q_ASSERT(window);
+    if (!data || !window || !data->callbacks) {
+        return;
+    }
+    if (data->callbacks->getProperty(kDontOverrideCursorVar, false).toBool()) {
+        return;
+    }
+    const bool windowFixedSize = data->callbacks->isWindowFixedSize();
+    if (windowFixedSize) {
+        return;
+    }
+    std::ignore = data->hitTestEngine.setGeometry(window, windowFixedSize, shadowMargins(window));
+    const Qt::CursorShape cs = data->hitTestEngine.cursorShapeAt(scenePos);
+    if (cs == Qt::ArrowCursor) {
+        if (data->cursorShapeChanged) {
+            data->callbacks->unsetCursor();
+            data->cursorShapeChanged = false;
+        }
+    } else {
+        data->callbacks->setCursor(cs);
+        data->cursorShapeChanged = true;
+    }
+}
+
 class FramelessHelperQtPrivate
 {
     FRAMELESSHELPER_PRIVATE_CLASS(FramelessHelperQt)
@@ -84,7 +249,16 @@ public:
     explicit FramelessHelperQtPrivate(FramelessHelperQt *q);
     ~FramelessHelperQtPrivate();
 
+    void scheduleHoverUpdate(QWindow *qWindow, const QPoint &scenePos);
+    void flushHoverUpdate();
+
     const QObject *window = nullptr;
+    // High polling rate mice deliver far more moves than the display can show, only the
+    // newest position of each event loop iteration and display frame is processed.
+    QTimer hoverTimer{};
+    QElapsedTimer lastHoverUpdate{};
+    QPointer<QWindow> hoverWindow = nullptr;
+    QPoint pendingHoverPos = {};
 };
 
 FramelessDataQt::FramelessDataQt() = default;
@@ -103,8 +277,52 @@ FramelessHelperQtPrivate::FramelessHelperQtPrivate(FramelessHelperQt *q) : q_ptr
 
 FramelessHelperQtPrivate::~FramelessHelperQtPrivate() = default;
 
+void FramelessHelperQtPrivate::scheduleHoverUpdate(QWindow *qWindow, const QPoint &scenePos)
+{
+    Q_ASSERT(qWindow);
+    if (!qWindow) {
+        return;
+    }
+    hoverWindow = qWindow;
+    pendingHoverPos = scenePos;
+    // Already scheduled, the newest position simply replaces the older ones.
+    if (hoverTimer.isActive()) {
+        return;
+    }
+    int delay = 0; // Collapses the moves which are already queued in this event loop iteration.
+    if (lastHoverUpdate.isValid()) {
+        qreal refreshRate = kDefaultRefreshRate;
+        if (const QScreen * const screen = qWindow->screen()) {
+            if (screen->refreshRate() > qreal(1)) {
+                refreshRate = screen->refreshRate();
+            }
+        }
+        const int frameInterval = std::max(1, qRound(qreal(1000) / refreshRate));
+        delay = std::max(0, int(frameInterval - lastHoverUpdate.elapsed()));
+    }
+    hoverTimer.start(delay);
+}
+
+void FramelessHelperQtPrivate::flushHoverUpdate()
+{
+    hoverTimer.stop();
+    if (!hoverWindow || !window) {
+        return;
+    }
+    const FramelessDataQtPtr data = tryGetData(window);
+    if (!data || !data->frameless || !data->callbacks) {
+        return;
+    }
+    lastHoverUpdate.start();
+    updateCursorShape(data, hoverWindow, pendingHoverPos);
+}
+
 FramelessHelperQt::FramelessHelperQt(QObject *parent) : QObject(parent), d_ptr(std::make_unique<FramelessHelperQtPrivate>(this))
 {
+    Q_D(FramelessHelperQt);
+    d->hoverTimer.setSingleShot(true);
+    d->hoverTimer.setTimerType(Qt::PreciseTimer);
+    connect(&d->hoverTimer, &QTimer::timeout, this, [d](){ d->flushHoverUpdate(); });
 }
 
 FramelessHelperQt::~FramelessHelperQt() = default;
@@ -125,20 +343,17 @@ void FramelessHelperQt::addWindow(const QObject *window)
         return;
     }
     data->frameless = true;
-    static const auto shouldApplyFramelessFlag = []() -> bool {
-#ifdef Q_OS_MACOS
-        return false;
-#elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
-        return !Utils::isCustomDecorationSupported();
-#elif defined(Q_OS_WINDOWS)
-        return true;
-#endif // Q_OS_MACOS
-    }();
 #if (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(6, 0, 0)))
     qWindow->setProperty("_q_mac_wantsLayer", 1);
 #endif // (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(6, 0, 0)))
-    if (shouldApplyFramelessFlag) {
-        data->callbacks->setWindowFlags(data->callbacks->getWindowFlags() | Qt::FramelessWindowHint);
+    if (Utils::shouldApplyFramelessWindowHint()) {
+        // Windows attached before their creation already carry the flag. Changing
+        // the flags of a live window makes the platform plugin re-create it (and
+        // unmap/remap it on xcb), so only touch the windows which really need it.
+        const Qt::WindowFlags flags = data->callbacks->getWindowFlags();
+        if (!(flags & Qt::FramelessWindowHint)) {
+            data->callbacks->setWindowFlags(flags | Qt::FramelessWindowHint);
+        }
     } else {
 #if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
         std::ignore = Utils::tryHideSystemTitleBar(data->callbacks->getWindowId(), true);
@@ -151,6 +366,10 @@ void FramelessHelperQt::addWindow(const QObject *window)
         data->framelessHelperImpl->d_func()->window = window;
         qWindow->installEventFilter(data->framelessHelperImpl);
     }
+    updateWindowShape(data, qWindow);
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    X11WindowStateMirror::addWindow(window);
+#endif // (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
     FramelessHelperEnableThemeAware();
 }
 
@@ -169,6 +388,8 @@ void FramelessHelperQt::removeWindow(const QObject *window)
         Q_ASSERT(qWindow);
         if (qWindow) {
             qWindow->removeEventFilter(data->framelessHelperImpl);
+            // The software move/resize engine is a child of the helper.
+            data->moveResizeEngine = nullptr;
             delete data->framelessHelperImpl;
             data->framelessHelperImpl = nullptr;
         }
@@ -201,9 +422,11 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
         return false;
     }
     const QEvent::Type type = event->type();
-    // We are only interested in some specific mouse events (plus the DPR change event).
+    // We are only interested in some specific mouse events (plus the DPR change event
+    // and the events which change the window shape).
     if ((type != QEvent::MouseButtonPress) && (type != QEvent::MouseButtonRelease)
             && (type != QEvent::MouseButtonDblClick) && (type != QEvent::MouseMove)
+            && (type != QEvent::Resize) && (type != QEvent::WindowStateChange)
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
             && (type != QEvent::DevicePixelRatioChange)
 #else // QT_VERSION < QT_VERSION_CHECK(6, 6, 0)
@@ -216,16 +439,25 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
     if (!data || !data->frameless || !data->callbacks) {
         return false;
     }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(d->window);
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
     if (type == QEvent::DevicePixelRatioChange)
 #else // QT_VERSION < QT_VERSION_CHECK(6, 6, 0)
     if (type == QEvent::ScreenChangeInternal)
 #endif // (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
     {
+        // The frame extents and the input region are in device pixels.
+        data->frameExtents = {};
+        data->inputRegion = {};
+        updateWindowShape(data, qobject_cast<QWindow *>(object));
         data->callbacks->forceChildrenRepaint();
         return false;
     }
     const auto qWindow = qobject_cast<QWindow *>(object);
+    if ((type == QEvent::Resize) || (type == QEvent::WindowStateChange)) {
+        updateWindowShape(data, qWindow);
+        return false;
+    }
     const auto mouseEvent = static_cast<QMouseEvent *>(event);
     const Qt::MouseButton button = mouseEvent->button();
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
@@ -235,19 +467,52 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
     const QPoint scenePos = mouseEvent->windowPos().toPoint();
     const QPoint globalPos = mouseEvent->screenPos().toPoint();
 #endif
+    if (FramelessConfig::instance()->isSet(Option::EnableMouseMoveCompression)) {
+        if ((type == QEvent::MouseMove) && !data->leftButtonPressed
+            && !(data->moveResizeEngine && data->moveResizeEngine->isActive())) {
+            d->scheduleHoverUpdate(qWindow, scenePos);
+            return false;
+        }
+        // Keep the order: the pending hover work must not land after a button transition.
+        if (d->hoverTimer.isActive()) {
+            d->flushHoverUpdate();
+        }
+    }
+    if (data->moveResizeEngine && data->moveResizeEngine->isActive()) {
+        // We are moving or resizing the window ourself, the pointer events belong to us
+        // until the left button is released.
+        if (type == QEvent::MouseMove) {
+            data->moveResizeEngine->update(globalPos);
+            event->accept();
+            return true;
+        }
+        if ((type == QEvent::MouseButtonRelease) && (button == Qt::LeftButton)) {
+            data->leftButtonPressed = false;
+            data->moveResizeEngine->finish(globalPos);
+            event->accept();
+            return true;
+        }
+    }
     const bool windowFixedSize = data->callbacks->isWindowFixedSize();
+    // Only rebuilds the zone table when the window geometry or state has changed.
+    std::ignore = data->hitTestEngine.setGeometry(qWindow, windowFixedSize, shadowMargins(qWindow));
     const bool ignoreThisEvent = data->callbacks->shouldIgnoreMouseEvents(scenePos);
     const bool insideTitleBar = data->callbacks->isInsideTitleBarDraggableArea(scenePos);
-    const bool dontOverrideCursor = data->callbacks->getProperty(kDontOverrideCursorVar, false).toBool();
     const bool dontToggleMaximize = data->callbacks->getProperty(kDontToggleMaximizeVar, false).toBool();
     switch (type) {
     case QEvent::MouseButtonPress:
         if (button == Qt::LeftButton) {
             data->leftButtonPressed = true;
             if (!windowFixedSize) {
-                const Qt::Edges edges = Utils::calculateWindowEdges(qWindow, scenePos);
+                const Qt::Edges edges = data->hitTestEngine.edgesAt(scenePos);
+                FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::HitTest, quint64(data->windowId),
+                    quintptr(int(edges)), quintptr(scenePos.x()), quintptr(scenePos.y()));
                 if (edges != Qt::Edges{}) {
-                    std::ignore = Utils::startSystemResize(qWindow, edges, globalPos);
+                    FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::SystemResizeStarted, quint64(data->windowId),
+                        quintptr(int(edges)), quintptr(globalPos.x()), quintptr(globalPos.y()));
+                    if (!Utils::startSystemResize(qWindow, edges, globalPos)) {
+                        std::ignore = startSoftwareMoveResize(data, qWindow, edges, globalPos);
+                    }
                     event->accept();
                     return true;
                 }
@@ -277,21 +542,14 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
         }
         break;
     case QEvent::MouseMove: {
-        if (!dontOverrideCursor && !windowFixedSize) {
-            const Qt::CursorShape cs = Utils::calculateCursorShape(qWindow, scenePos);
-            if (cs == Qt::ArrowCursor) {
-                if (data->cursorShapeChanged) {
-                    data->callbacks->unsetCursor();
-                    data->cursorShapeChanged = false;
-                }
-            } else {
-                data->callbacks->setCursor(cs);
-                data->cursorShapeChanged = true;
-            }
-        }
+        updateCursorShape(data, qWindow, scenePos);
         if (data->leftButtonPressed) {
             if (!ignoreThisEvent && insideTitleBar) {
-                std::ignore = Utils::startSystemMove(qWindow, globalPos);
+                FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::SystemMoveStarted, quint64(data->windowId),
+                    quintptr(globalPos.x()), quintptr(globalPos.y()));
+                if (!Utils::startSystemMove(qWindow, globalPos)) {
+                    std::ignore = startSoftwareMoveResize(data, qWindow, {}, globalPos);
+                }
                 event->accept();
                 return true;
             }
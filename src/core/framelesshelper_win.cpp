@@ -36,8 +36,12 @@
 #include "framelesshelper_windows.h"
 #include "framelesshelpercore_global_p.h"
 #include "scopeguard_p.h"
+#include "hittestengine_p.h"
+#include "diagnosticslog_p.h"
+#include "performancemonitor_p.h"
 #include <optional>
 #include <memory>
+#include <array>
 #include <QtCore/qhash.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qcoreapplication.h>
@@ -111,6 +115,8 @@ struct FramelessDataWin : public FramelessData
     bool mouseLeaveBlocked = false;
     Dpi dpi = {};
     HMONITOR monitor = nullptr;
+    // The resize area zone table, in native pixels.
+    HitTestEngine hitTestEngine = {};
 #if (QT_VERSION < QT_VERSION_CHECK(6, 5, 1))
     QRect restoreGeometry = {};
 #endif // (QT_VERSION < QT_VERSION_CHECK(6, 5, 1))
@@ -156,6 +162,31 @@ Q_GLOBAL_STATIC(FramelessHelperWinInternal, g_internalData)
     return result;
 }
 
+[[nodiscard]] static inline LRESULT edgesToHitTestResult(const Qt::Edges edges)
+{
+    // Indexed by the raw value of Qt::Edges (Top = 1, Left = 2, Right = 4, Bottom = 8).
+    static constexpr const std::array<LRESULT, 16> table =
+    {
+        HTCLIENT,      // None
+        HTTOP,         // Top
+        HTLEFT,        // Left
+        HTTOPLEFT,     // Top | Left
+        HTRIGHT,       // Right
+        HTTOPRIGHT,    // Top | Right
+        HTLEFT,        // Left | Right
+        HTTOPLEFT,     // Top | Left | Right
+        HTBOTTOM,      // Bottom
+        HTTOP,         // Top | Bottom
+        HTBOTTOMLEFT,  // Left | Bottom
+        HTTOPLEFT,     // Top | Left | Bottom
+        HTBOTTOMRIGHT, // Right | Bottom
+        HTTOPRIGHT,    // Top | Right | Bottom
+        HTBOTTOMLEFT,  // Left | Right | Bottom
+        HTTOPLEFT      // All
+    };
+    return table.at(int(edges) & 0xF);
+}
+
 [[nodiscard]] static inline WindowPart getHittedWindowPart(const int hitTestResult)
 {
     switch (hitTestResult) {
@@ -351,6 +382,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
     if (!data || !data->frameless || !data->callbacks) {
         return false;
     }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(window);
 
     QWindow *qWindow = data->callbacks->getWindowHandle();
 
@@ -974,53 +1006,28 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
                 *result = (isTitleBar ? HTCAPTION : HTCLIENT);
                 return true;
             }
-            if (!isFixedSize) {
-                const bool isBottom = (nativeLocalPos.y >= (clientHeight - frameSizeY));
-                // Make the border a little wider to let the user easy to resize on corners.
-                const auto scaleFactor = ((isTop || isBottom) ? qreal(2) : qreal(1));
-                const int frameSizeX = Utils::getResizeBorderThickness(windowId, true, true);
-                const int scaledFrameSizeX = std::round(qreal(frameSizeX) * scaleFactor);
-                const bool isLeft = (nativeLocalPos.x < scaledFrameSizeX);
-                const bool isRight = (nativeLocalPos.x >= (clientWidth - scaledFrameSizeX));
-                if (dontOverrideCursor && (isTop || isBottom || isLeft || isRight)) {
+            const int frameSizeX = Utils::getResizeBorderThickness(windowId, true, true);
+            HitTestEngine::Geometry geometry = {};
+            geometry.windowSize = QSize(clientWidth, clientHeight);
+            geometry.horizontalBorderThickness = frameSizeX;
+            geometry.verticalBorderThickness = frameSizeY;
+            // Make the border a little wider to let the user easy to resize on corners.
+            geometry.cornerExtent = (frameSizeX * 2);
+            geometry.resizable = !isFixedSize;
+            std::ignore = data->hitTestEngine.setGeometry(geometry);
+            const Qt::Edges edges = data->hitTestEngine.edgesAt(QPoint(nativeLocalPos.x, nativeLocalPos.y));
+            FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::HitTest, quint64(windowId),
+                quintptr(int(edges)), quintptr(nativeLocalPos.x), quintptr(nativeLocalPos.y));
+            if (edges != Qt::Edges{}) {
+                if (dontOverrideCursor) {
                     // Return HTCLIENT instead of HTBORDER here, because the mouse is
                     // inside the window now, return HTCLIENT to let the controls
                     // inside our window can still capture mouse events.
                     *result = (isTitleBar ? HTCAPTION : HTCLIENT);
                     return true;
                 }
-                if (isTop) {
-                    if (isLeft) {
-                        *result = HTTOPLEFT;
-                        return true;
-                    }
-                    if (isRight) {
-                        *result = HTTOPRIGHT;
-                        return true;
-                    }
-                    *result = HTTOP;
-                    return true;
-                }
-                if (isBottom) {
-                    if (isLeft) {
-                        *result = HTBOTTOMLEFT;
-                        return true;
-                    }
-                    if (isRight) {
-                        *result = HTBOTTOMRIGHT;
-                        return true;
-                    }
-                    *result = HTBOTTOM;
-                    return true;
-                }
-                if (isLeft) {
-                    *result = HTLEFT;
-                    return true;
-                }
-                if (isRight) {
-                    *result = HTRIGHT;
-                    return true;
-                }
+                *result = edgesToHitTestResult(edges);
+                return true;
             }
             if (isTitleBar) {
                 *result = HTCAPTION;
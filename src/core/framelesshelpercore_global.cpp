@@ -25,6 +25,7 @@
 #include "framelesshelpercore_global.h"
 #include "framelesshelpercore_global_p.h"
 #include "versionnumber_p.h"
+#include "backgroundexecutor_p.h"
 #include "utils.h"
 #include <QtCore/qiodevice.h>
 #include <QtCore/qcoreapplication.h>
@@ -277,4 +278,9 @@ void FramelessHelperPrintLogo()
     INFO.nospace().noquote() << message;
 }
 
+void FramelessHelperSetBackgroundTaskRunner(const BackgroundTaskRunner &runner)
+{
+    BackgroundExecutor::setTaskRunner(runner);
+}
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -36,6 +36,7 @@
 #  include "framelesshelper_qt.h"
 #endif
 #include "framelessconfig_p.h"
+#include "diagnosticslog_p.h"
 #include "utils.h"
 #ifdef Q_OS_WINDOWS
 #  include "winverhelper_p.h"
@@ -73,6 +74,8 @@ struct InternalData
 {
     FramelessDataHash dataMap = {};
     QHash<WId, QObject *> windowMap = {};
+    QHash<const QObject *, FramelessManagerPrivate::ThemeSubscriber> themeSubscribers = {};
+    quint64 themeGeneration = 0;
 
     InternalData();
     ~InternalData();
@@ -237,8 +240,7 @@ void FramelessManagerPrivate::doNotifySystemThemeHasChangedOrNot()
 #endif
     // Don't emit the signal if the user has overrided the global theme.
     if (notify && !isThemeOverrided()) {
-        Q_Q(FramelessManager);
-        Q_EMIT q->systemThemeChanged();
+        commitThemeChange();
         DEBUG.nospace() << "System theme changed. Current theme: " << systemTheme
                         << ", accent color: " << accentColor.name(QColor::HexArgb).toUpper()
 #ifdef Q_OS_WINDOWS
@@ -262,6 +264,7 @@ void FramelessManagerPrivate::doNotifyWallpaperHasChangedOrNot()
         notify = true;
     }
     if (notify) {
+        FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::WallpaperChanged, 0, quintptr(wallpaperAspectStyle));
         Q_Q(FramelessManager);
         Q_EMIT q->wallpaperChanged();
         DEBUG.nospace() << "Wallpaper changed. Current wallpaper: " << wallpaper
@@ -340,9 +343,73 @@ void FramelessManagerPrivate::updateWindowId(const QObject *window, const WId ne
     g_internalData()->windowMap.remove(oldWindowId);
     g_internalData()->windowMap.insert(newWindowId, win);
     data->frameless = false;
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    // The new native window starts over, it will be seeded again once it's added.
+    data->x11WindowState = {};
+#endif // (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
     std::ignore = FramelessManager::instance()->addWindow(window, newWindowId);
 }
 
+std::optional<Qt::WindowState> FramelessManagerPrivate::mirroredWindowState(const QObject *window)
+{
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    const FramelessDataPtr data = getData(window);
+    if (data && data->x11WindowState.valid) {
+        return data->x11WindowState.windowState();
+    }
+#else // !(defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    Q_UNUSED(window);
+#endif // (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    return std::nullopt;
+}
+
+void FramelessManagerPrivate::addThemeSubscriber(const QObject *object, const ThemeSubscriber &callback)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(callback);
+    if (!object || !callback) {
+        return;
+    }
+    g_internalData()->themeSubscribers.insert(object, callback);
+}
+
+void FramelessManagerPrivate::removeThemeSubscriber(const QObject *object)
+{
+    Q_ASSERT(object);
+    if (!object) {
+        return;
+    }
+    // The subscribers may be destroyed after the global data during application exit.
+    if (g_internalData.isDestroyed()) {
+        return;
+    }
+    g_internalData()->themeSubscribers.remove(object);
+}
+
+quint64 FramelessManagerPrivate::themeGeneration()
+{
+    return g_internalData()->themeGeneration;
+}
+
+void FramelessManagerPrivate::commitThemeChange()
+{
+    ++g_internalData()->themeGeneration;
+    Q_Q(FramelessManager);
+    FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::ThemeChanged, 0,
+        quintptr(q->systemTheme()), quintptr(g_internalData()->themeGeneration));
+    // Refresh all the subscribers in one pass. A subscriber may destroy other
+    // subscribers when being refreshed, so look every one of them up again.
+    const QList<const QObject *> subscribers = g_internalData()->themeSubscribers.keys();
+    for (auto &&subscriber : std::as_const(subscribers)) {
+        const auto it = g_internalData()->themeSubscribers.constFind(subscriber);
+        if (it != g_internalData()->themeSubscribers.constEnd()) {
+            const ThemeSubscriber callback = it.value();
+            callback();
+        }
+    }
+    Q_EMIT q->systemThemeChanged();
+}
+
 bool FramelessManagerPrivate::isThemeOverrided() const
 {
     return (overrideTheme.value_or(SystemTheme::Unknown) != SystemTheme::Unknown);
@@ -453,7 +520,7 @@ void FramelessManager::setOverrideTheme(const SystemTheme theme)
     } else {
         d->overrideTheme = theme;
     }
-    Q_EMIT systemThemeChanged();
+    d->commitThemeChange();
 }
 
 bool FramelessManager::addWindow(const QObject *window, const WId windowId)
@@ -490,6 +557,7 @@ bool FramelessManager::addWindow(const QObject *window, const WId windowId)
         data->internalEventHandler = new InternalEventFilter(data->window, data->window);
         data->window->installEventFilter(data->internalEventHandler);
     }
+    FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::WindowAdded, quint64(windowId));
     return true;
 }
 
@@ -526,6 +594,7 @@ bool FramelessManager::removeWindow(const QObject *window)
 #else
     FramelessHelperQt::removeWindow(window);
 #endif
+    FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::WindowRemoved, quint64(data->windowId));
     g_internalData()->dataMap.erase(it);
     g_internalData()->windowMap.remove(data->windowId);
     return true;
@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "hittestengine_p.h"
+#include <QtGui/qwindow.h>
+#include <algorithm>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+using namespace Global;
+
+// Indexed by the raw value of Qt::Edges, the priority is the same with what
+// Utils::calculateCursorShape() used to have: corners first, then the edges.
+static constexpr const std::array<Qt::CursorShape, 16> g_cursorShapeTable =
+{
+    Qt::ArrowCursor,    // None
+    Qt::SizeVerCursor,  // Top
+    Qt::SizeHorCursor,  // Left
+    Qt::SizeFDiagCursor, // Top | Left
+    Qt::SizeHorCursor,  // Right
+    Qt::SizeBDiagCursor, // Top | Right
+    Qt::SizeHorCursor,  // Left | Right
+    Qt::SizeFDiagCursor, // Top | Left | Right
+    Qt::SizeVerCursor,  // Bottom
+    Qt::SizeVerCursor,  // Top | Bottom
+    Qt::SizeBDiagCursor, // Left | Bottom
+    Qt::SizeFDiagCursor, // Top | Left | Bottom
+    Qt::SizeFDiagCursor, // Right | Bottom
+    Qt::SizeFDiagCursor, // Top | Right | Bottom
+    Qt::SizeFDiagCursor, // Left | Right | Bottom
+    Qt::SizeFDiagCursor  // All
+};
+
+HitTestEngine::HitTestEngine()
+{
+    rebuild();
+}
+
+HitTestEngine::~HitTestEngine() = default;
+
+HitTestEngine::Geometry HitTestEngine::geometry() const
+{
+    return m_geometry;
+}
+
+bool HitTestEngine::setGeometry(const Geometry &value)
+{
+    if (m_geometry == value) {
+        return false;
+    }
+    m_geometry = value;
+    rebuild();
+    return true;
+}
+
+bool HitTestEngine::setGeometry(const QWindow *window, const bool fixedSize, const QMargins &extraMargins)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    Geometry geometry = {};
+    geometry.windowSize = window->size();
+    geometry.horizontalBorderThickness = (kDefaultResizeBorderThickness + std::max(extraMargins.left(), extraMargins.right()));
+    geometry.verticalBorderThickness = (kDefaultResizeBorderThickness + std::max(extraMargins.top(), extraMargins.bottom()));
+#ifdef Q_OS_MACOS
+    // The window is always resized by the system on macOS.
+    Q_UNUSED(fixedSize);
+    geometry.resizable = false;
+#else // !Q_OS_MACOS
+    geometry.resizable = (!fixedSize && (window->visibility() == QWindow::Windowed));
+#endif // Q_OS_MACOS
+    return setGeometry(geometry);
+}
+
+Qt::Edges HitTestEngine::edgesAt(const QPoint &pos) const
+{
+    return m_zoneEdges.at(zoneIndexAt(pos));
+}
+
+Qt::CursorShape HitTestEngine::cursorShapeAt(const QPoint &pos) const
+{
+    return m_zoneCursors.at(zoneIndexAt(pos));
+}
+
+Qt::CursorShape HitTestEngine::cursorShapeForEdges(const Qt::Edges edges)
+{
+    return g_cursorShapeTable.at(int(edges) & 0xF);
+}
+
+void HitTestEngine::rebuild()
+{
+    if (!m_geometry.resizable || m_geometry.windowSize.isEmpty()) {
+        // Everything is client area, no need to care about the bounds at all.
+        m_rowBounds = {};
+        m_columnBounds = {};
+        m_zoneEdges.fill(Qt::Edges{});
+        m_zoneCursors.fill(Qt::ArrowCursor);
+        return;
+    }
+    const int width = m_geometry.windowSize.width();
+    const int height = m_geometry.windowSize.height();
+    const int borderX = m_geometry.horizontalBorderThickness;
+    const int borderY = m_geometry.verticalBorderThickness;
+    const int cornerX = ((m_geometry.cornerExtent > 0) ? m_geometry.cornerExtent : borderX);
+    // The bounds must not decrease, otherwise the lookup will return wrong zones for
+    // extremely small windows, in such case the far edge wins.
+    m_rowBounds = { borderY, std::max(height - borderY, borderY) };
+    m_columnBounds.at(0) = { cornerX, std::max(width - cornerX, cornerX) };
+    m_columnBounds.at(1) = { borderX, std::max(width - borderX, borderX) };
+    m_columnBounds.at(2) = m_columnBounds.at(0);
+    for (int row = 0; row != 3; ++row) {
+        for (int column = 0; column != 3; ++column) {
+            Qt::Edges edges = {};
+            if (row == 0) {
+                edges |= Qt::TopEdge;
+            } else if (row == 2) {
+                edges |= Qt::BottomEdge;
+            }
+            if (column == 0) {
+                edges |= Qt::LeftEdge;
+            } else if (column == 2) {
+                edges |= Qt::RightEdge;
+            }
+            const int index = ((row * 3) + column);
+            m_zoneEdges.at(index) = edges;
+            m_zoneCursors.at(index) = cursorShapeForEdges(edges);
+        }
+    }
+}
+
+int HitTestEngine::zoneIndexAt(const QPoint &pos) const
+{
+    const int x = pos.x();
+    const int y = pos.y();
+    const int row = (int(y >= m_rowBounds[0]) + int(y >= m_rowBounds[1]));
+    const std::array<int, 2> &columnBounds = m_columnBounds[row];
+    const int column = (int(x >= columnBounds[0]) + int(x >= columnBounds[1]));
+    return ((row * 3) + column);
+}
+
+FRAMELESSHELPER_END_NAMESPACE
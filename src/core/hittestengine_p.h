@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/hittestengine_p.h"
@@ -28,13 +28,25 @@
 #if FRAMELESSHELPER_CONFIG(mica_material)
 
 #include "framelessmanager.h"
+#include "framelessmanager_p.h"
 #include "utils.h"
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
+#include "diagnosticslog_p.h"
+#include "backgroundexecutor_p.h"
 #include <optional>
 #include <memory>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <array>
+#include <vector>
 #include <QtCore/qsysinfo.h>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qelapsedtimer.h>
+#if (QT_VERSION < QT_VERSION_CHECK(5, 10, 0))
+#  include <QtCore/qthread.h>
+#endif
 #if FRAMELESSHELPER_HAS_THREAD
 #  include <QtCore/qmutex.h>
 #endif
@@ -71,15 +83,242 @@ using namespace Global;
 [[maybe_unused]] static constexpr const qreal kDefaultTintOpacity = 0.7;
 [[maybe_unused]] static constexpr const qreal kDefaultNoiseOpacity = 0.04;
 [[maybe_unused]] static constexpr const qreal kDefaultBlurRadius = 128.0;
+// How many screen pixels one decoded wallpaper pixel may cover. The blur kernel still spans
+// 16 decoded pixels at this ratio, the interpolation error it leaves behind is far below
+// one 8-bit color step, so the blurred result can't be told apart from a full size decode.
+[[maybe_unused]] static constexpr const qreal kMaximumDecodeUpscaleFactor = (kDefaultBlurRadius / 16.0);
+// The low resolution copy used by MicaQuality::Reduced, it's 1/16 of the full wallpaper.
+[[maybe_unused]] static constexpr const int kReducedWallpaperScaleFactor = 4;
+
+// Mica is only a small part of a frame, leave the rest of the 60Hz budget to the application.
+[[maybe_unused]] static constexpr const qreal kDefaultFrameBudget = 4.0; // ms
+[[maybe_unused]] static constexpr const int kDefaultQualityRecoveryInterval = 2000; // ms
+// Consecutive over budget paints before stepping down, a single slow frame is not a trend.
+[[maybe_unused]] static constexpr const int kQualityDowngradeThreshold = 3;
+// Weight of the newest sample in the moving average of the paint cost.
+[[maybe_unused]] static constexpr const qreal kPaintCostSmoothingFactor = 0.25;
+// A window painted more recently than this is considered busy, e.g. being resized.
+[[maybe_unused]] static constexpr const int kQualityIdleThreshold = 250; // ms
+// Each failed recovery doubles the recovery interval, up to this factor.
+[[maybe_unused]] static constexpr const int kMaximumQualityRecoveryBackoff = 8;
+// Distinct material parameter sets alive at the same time, the textures are only 16KiB each.
+[[maybe_unused]] static constexpr const std::size_t kMaximumMaterialBrushCacheSize = 16;
 
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultSystemLightColor2 = {243, 243, 243}; // #F3F3F3
 
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultFallbackColorDark = {44, 44, 44}; // #2C2C2C
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultFallbackColorLight = {249, 249, 249}; // #F9F9F9
 
+// 4x4 Bayer matrix, used to spread the quantization error of the 16-bit format.
+static constexpr const std::array<std::array<int, 4>, 4> kBayerMatrix = {{
+    {{ 0, 8, 2, 10 }},
+    {{ 12, 4, 14, 6 }},
+    {{ 3, 11, 1, 9 }},
+    {{ 15, 7, 13, 5 }}
+}};
+
+[[nodiscard]] static inline int clampColorComponent(const int value)
+{
+    return std::clamp(value, 0, 255);
+}
+
+bool WallpaperStorage::isNull() const
+{
+    return m_size.isEmpty();
+}
+
+QSize WallpaperStorage::size() const
+{
+    return m_size;
+}
+
+WallpaperStorageFormat WallpaperStorage::format() const
+{
+    return m_format;
+}
+
+WallpaperStorage WallpaperStorage::pack(const QImage &image, const WallpaperStorageFormat format)
+{
+    WallpaperStorage storage = {};
+    if (image.isNull()) {
+        return storage;
+    }
+    storage.m_size = image.size();
+    storage.m_format = format;
+    switch (format) {
+    case WallpaperStorageFormat::Argb32:
+        storage.m_pixmap = QPixmap::fromImage(image);
+        break;
+    case WallpaperStorageFormat::Rgb888:
+        storage.m_image = image.convertToFormat(QImage::Format_RGB888);
+        break;
+    case WallpaperStorageFormat::Rgb16:
+        storage.m_image = packRgb16(image);
+        break;
+    case WallpaperStorageFormat::YCbCr420:
+        storage.packYCbCr420(image);
+        break;
+    }
+    return storage;
+}
+
+void WallpaperStorage::draw(QPainter *painter, const QPoint &target, const QRect &source) const
+{
+    Q_ASSERT(painter);
+    if (!painter || isNull() || source.isEmpty()) {
+        return;
+    }
+    switch (m_format) {
+    case WallpaperStorageFormat::Argb32:
+        painter->drawPixmap(target, m_pixmap, source);
+        break;
+    case WallpaperStorageFormat::Rgb888:
+    case WallpaperStorageFormat::Rgb16:
+        // QPainter converts the scan lines on the fly.
+        painter->drawImage(target, m_image, source);
+        break;
+    case WallpaperStorageFormat::YCbCr420: {
+        const QRect rect = source.intersected(QRect(QPoint(0, 0), m_size));
+        if (rect.isEmpty()) {
+            break;
+        }
+        // Reuse the scratch buffer, it only grows up to the largest window we paint.
+        if ((m_scratch.width() < rect.width()) || (m_scratch.height() < rect.height())) {
+            m_scratch = QImage(m_scratch.size().expandedTo(rect.size()), QImage::Format_RGB32);
+        }
+        unpackYCbCr420(rect, &m_scratch);
+        painter->drawImage(target + (rect.topLeft() - source.topLeft()), m_scratch, QRect(QPoint(0, 0), rect.size()));
+    } break;
+    }
+}
+
+QImage WallpaperStorage::toImage() const
+{
+    switch (m_format) {
+    case WallpaperStorageFormat::Argb32:
+        return m_pixmap.toImage();
+    case WallpaperStorageFormat::Rgb888:
+    case WallpaperStorageFormat::Rgb16:
+        return m_image;
+    case WallpaperStorageFormat::YCbCr420: {
+        QImage image(m_size, QImage::Format_RGB32);
+        unpackYCbCr420(QRect(QPoint(0, 0), m_size), &image);
+        return image;
+    }
+    }
+    return {};
+}
+
+qsizetype WallpaperStorage::byteCount() const
+{
+    switch (m_format) {
+    case WallpaperStorageFormat::Argb32:
+        return (qsizetype(m_size.width()) * qsizetype(m_size.height()) * 4);
+    case WallpaperStorageFormat::Rgb888:
+    case WallpaperStorageFormat::Rgb16:
+        return qsizetype(m_image.sizeInBytes());
+    case WallpaperStorageFormat::YCbCr420:
+        return qsizetype(m_luma.size() + m_blueChroma.size() + m_redChroma.size());
+    }
+    return 0;
+}
+
+QImage WallpaperStorage::packRgb16(const QImage &image)
+{
+    QImage result(image.size(), QImage::Format_RGB16);
+    for (int y = 0; y != image.height(); ++y) {
+        const auto src = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        const auto dst = reinterpret_cast<quint16 *>(result.scanLine(y));
+        const std::array<int, 4> &row = kBayerMatrix.at(y & 3);
+        for (int x = 0; x != image.width(); ++x) {
+            // Quantizes in level space: adds (bayer + 0.5) / 16 of a level before the
+            // truncation, a zero mean dither of plus or minus half a level plus half a level
+            // of rounding. The dither is in 1/32 of a level, half a 6-bit level is 2 in 8-bit.
+            const int dither = (((row.at(x & 3) * 2) + 1) * 255);
+            const int r = (((qRed(src[x]) * 31 * 32) + dither) / (255 * 32));
+            const int g = (((qGreen(src[x]) * 63 * 32) + dither) / (255 * 32));
+            const int b = (((qBlue(src[x]) * 31 * 32) + dither) / (255 * 32));
+            dst[x] = quint16((r << 11) | (g << 5) | b);
+        }
+    }
+    return result;
+}
+
+// Full range BT.601, the same as JPEG. Every fixed point step rounds to nearest,
+// flooring would darken the picture by almost one 8-bit step.
+void WallpaperStorage::packYCbCr420(const QImage &image)
+{
+    const int width = m_size.width();
+    const int height = m_size.height();
+    const int chromaWidth = ((width + 1) / 2);
+    const int chromaHeight = ((height + 1) / 2);
+    m_luma.resize(std::size_t(width) * std::size_t(height));
+    m_blueChroma.assign(std::size_t(chromaWidth) * std::size_t(chromaHeight), 0);
+    m_redChroma.assign(m_blueChroma.size(), 0);
+    std::vector<int> blueSum(std::size_t(chromaWidth), 0);
+    std::vector<int> redSum(std::size_t(chromaWidth), 0);
+    std::vector<int> count(std::size_t(chromaWidth), 0);
+    for (int y = 0; y != height; ++y) {
+        const auto src = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        quint8 * const luma = (m_luma.data() + (std::size_t(y) * std::size_t(width)));
+        for (int x = 0; x != width; ++x) {
+            const int r = qRed(src[x]);
+            const int g = qGreen(src[x]);
+            const int b = qBlue(src[x]);
+            luma[x] = quint8(((77 * r) + (150 * g) + (29 * b) + 128) >> 8);
+            const auto cx = std::size_t(x / 2);
+            blueSum.at(cx) += ((((-43 * r) - (85 * g) + (128 * b) + 128) >> 8) + 128);
+            redSum.at(cx) += ((((128 * r) - (107 * g) - (21 * b) + 128) >> 8) + 128);
+            ++count.at(cx);
+        }
+        if (((y & 1) == 1) || (y == (height - 1))) {
+            const std::size_t offset = (std::size_t(y / 2) * std::size_t(chromaWidth));
+            for (std::size_t cx = 0; cx != std::size_t(chromaWidth); ++cx) {
+                m_blueChroma.at(offset + cx) = quint8(clampColorComponent((blueSum.at(cx) + (count.at(cx) / 2)) / count.at(cx)));
+                m_redChroma.at(offset + cx) = quint8(clampColorComponent((redSum.at(cx) + (count.at(cx) / 2)) / count.at(cx)));
+            }
+            std::fill(blueSum.begin(), blueSum.end(), 0);
+            std::fill(redSum.begin(), redSum.end(), 0);
+            std::fill(count.begin(), count.end(), 0);
+        }
+    }
+}
+
+void WallpaperStorage::unpackYCbCr420(const QRect &rect, QImage *destination) const
+{
+    Q_ASSERT(destination);
+    Q_ASSERT(destination->format() == QImage::Format_RGB32);
+    Q_ASSERT((destination->width() >= rect.width()) && (destination->height() >= rect.height()));
+    if (!destination || rect.isEmpty()) {
+        return;
+    }
+    const int width = m_size.width();
+    const int chromaWidth = ((width + 1) / 2);
+    for (int y = 0; y != rect.height(); ++y) {
+        const int sy = (rect.y() + y);
+        const quint8 * const luma = (m_luma.data() + (std::size_t(sy) * std::size_t(width)));
+        const std::size_t chromaOffset = (std::size_t(sy / 2) * std::size_t(chromaWidth));
+        const auto dst = reinterpret_cast<QRgb *>(destination->scanLine(y));
+        for (int x = 0; x != rect.width(); ++x) {
+            const int sx = (rect.x() + x);
+            const int l = luma[sx];
+            const int cb = (int(m_blueChroma.at(chromaOffset + std::size_t(sx / 2))) - 128);
+            const int cr = (int(m_redChroma.at(chromaOffset + std::size_t(sx / 2))) - 128);
+            const int r = clampColorComponent(l + (((359 * cr) + 128) >> 8));
+            const int g = clampColorComponent(l - (((88 * cb) + (183 * cr) + 128) >> 8));
+            const int b = clampColorComponent(l + (((454 * cb) + 128) >> 8));
+            dst[x] = qRgb(r, g, b);
+        }
+    }
+}
+
 struct ImageData
 {
-    QPixmap blurredWallpaper = {};
+    WallpaperStorage blurredWallpaper = {};
+    QImage reducedWallpaper = {};
+    WallpaperStorageFormat storageFormat = WallpaperStorageFormat::Argb32;
+    // Bumped whenever the wallpaper is replaced.
+    quint64 wallpaperSerial = 0;
     bool graphicsResourcesReady = false;
 #if FRAMELESSHELPER_HAS_THREAD
     QMutex mutex{};
@@ -482,57 +721,98 @@ static inline void expblur(QImage &img, qreal radius, const bool improvedQuality
     return {x, y, w, h};
 }
 
-WallpaperThread::WallpaperThread(QObject *parent) : FramelessHelperThreadClass(parent)
+/*!
+    Calculates the smallest decode resolution which is visually identical to the full
+    size picture once it has been blurred. For JPEG pictures the result is snapped to
+    the 1/2, 1/4 and 1/8 scales libjpeg can produce natively while decoding the DCT
+    blocks, so the full size picture is never decoded at all.
+*/
+MicaMaterialPrivate::WallpaperDecodePlan MicaMaterialPrivate::planWallpaperDecode(const QSize &pictureSize,
+    const QByteArray &format, const WallpaperAspectStyle aspectStyle, const QSize &screenSize)
 {
+    Q_ASSERT(!pictureSize.isEmpty());
+    Q_ASSERT(!screenSize.isEmpty());
+    if (pictureSize.isEmpty() || screenSize.isEmpty()) {
+        return {};
+    }
+    WallpaperDecodePlan plan = {};
+    switch (aspectStyle) {
+    case WallpaperAspectStyle::Fill:
+        plan.displaySize = pictureSize.scaled(screenSize, Qt::KeepAspectRatioByExpanding);
+        break;
+    case WallpaperAspectStyle::Fit:
+        plan.displaySize = pictureSize.scaled(screenSize, Qt::KeepAspectRatio);
+        break;
+    case WallpaperAspectStyle::Stretch:
+        plan.displaySize = screenSize;
+        break;
+    default:
+        // Drawn at its own size, but we never keep more than 1920x1080 pixels around.
+        plan.displaySize = ((pictureSize.width() > kMaximumPictureSize.width()) || (pictureSize.height() > kMaximumPictureSize.height()))
+            ? pictureSize.scaled(kMaximumPictureSize, Qt::KeepAspectRatio) : pictureSize;
+        break;
+    }
+    const qreal displayScale = std::max(qreal(plan.displaySize.width()) / qreal(pictureSize.width()),
+        qreal(plan.displaySize.height()) / qreal(pictureSize.height()));
+    const qreal decodeScale = std::min(qreal(1), (displayScale / kMaximumDecodeUpscaleFactor));
+    const QSize minimumSize = { std::max(1, qCeil(qreal(pictureSize.width()) * decodeScale)),
+        std::max(1, qCeil(qreal(pictureSize.height()) * decodeScale)) };
+    const QByteArray lowerFormat = format.toLower();
+    if ((lowerFormat == "jpeg") || (lowerFormat == "jpg")) {
+        // libjpeg rounds the scaled dimensions up.
+        for (auto &&denominator : { 8, 4, 2, 1 }) {
+            const QSize size = { ((pictureSize.width() + denominator - 1) / denominator),
+                ((pictureSize.height() + denominator - 1) / denominator) };
+            if ((size.width() >= minimumSize.width()) && (size.height() >= minimumSize.height())) {
+                plan.decodeSize = size;
+                break;
+            }
+        }
+    } else {
+        plan.decodeSize = minimumSize;
+    }
+    return plan;
 }
 
-WallpaperThread::~WallpaperThread() = default;
-
-#if FRAMELESSHELPER_HAS_THREAD
-void WallpaperThread::run()
-#else
-void WallpaperThread::start()
-#endif
+QImage MicaMaterialPrivate::decodeWallpaper(const QString &filePath,
+    const WallpaperAspectStyle aspectStyle, const QSize &screenSize)
 {
-    const QString wallpaperFilePath = Utils::getWallpaperFilePath();
-    if (wallpaperFilePath.isEmpty()) {
-        WARNING << "Failed to retrieve the wallpaper file path.";
-        return;
+    Q_ASSERT(!filePath.isEmpty());
+    Q_ASSERT(!screenSize.isEmpty());
+    if (filePath.isEmpty() || screenSize.isEmpty()) {
+        return {};
     }
     // QImageReader allows us read the image size before we actually loading it, this behavior
     // can help us avoid consume too much memory if the image resolution is very large, eg, 4K.
-    QImageReader reader(wallpaperFilePath);
+    QImageReader reader(filePath);
     if (!reader.canRead()) {
         WARNING << "Qt can't read the wallpaper file:" << reader.errorString();
-        return;
+        return {};
     }
     const QSize actualSize = reader.size();
     if (actualSize.isEmpty()) {
         WARNING << "The wallpaper picture size is invalid.";
-        return;
+        return {};
     }
-    const QSize correctedSize = (actualSize > kMaximumPictureSize ? kMaximumPictureSize : actualSize);
-    if (correctedSize != actualSize) {
-        DEBUG << "The wallpaper picture size is greater than 1920x1080, it will be shrinked to reduce memory consumption.";
-        reader.setScaledSize(correctedSize);
+    // Everything will be blurred away anyway, decode only as much detail as survives the blur.
+    const WallpaperDecodePlan plan = planWallpaperDecode(actualSize, reader.format(), aspectStyle, screenSize);
+    if (plan.decodeSize.isEmpty()) {
+        WARNING << "Failed to calculate the wallpaper decode size.";
+        return {};
+    }
+    if (plan.decodeSize != actualSize) {
+        DEBUG << "Decoding the wallpaper picture at" << plan.decodeSize << "instead of" << actualSize;
+        reader.setScaledSize(plan.decodeSize);
     }
-    QImage image(correctedSize, kDefaultImageFormat);
+    QImage image(plan.decodeSize, kDefaultImageFormat);
     if (!reader.read(&image)) {
         WARNING << "Failed to read the wallpaper image:" << reader.errorString();
-        return;
+        return {};
     }
     if (image.isNull()) {
         WARNING << "The obtained image data is null.";
-        return;
-    }
-    WallpaperAspectStyle aspectStyle = Utils::getWallpaperAspectStyle();
-    const QSize wallpaperSize = QGuiApplication::primaryScreen()->size();
-    QImage buffer(wallpaperSize, kDefaultImageFormat);
-#ifdef Q_OS_WINDOWS
-    if (aspectStyle == WallpaperAspectStyle::Center) {
-        buffer.fill(kDefaultBlackColor);
+        return {};
     }
-#endif
     if ((aspectStyle == WallpaperAspectStyle::Stretch)
         || (aspectStyle == WallpaperAspectStyle::Fit)
         || (aspectStyle == WallpaperAspectStyle::Fill)) {
@@ -543,9 +823,95 @@ void WallpaperThread::start()
             mode = Qt::KeepAspectRatio;
         }
         QSize newSize = image.size();
-        newSize.scale(wallpaperSize, mode);
-        image = image.scaled(newSize);
+        newSize.scale(screenSize, mode);
+        // Nearest neighbour upscaling would leave visible blocks behind even after the blur.
+        image = image.scaled(newSize, Qt::IgnoreAspectRatio, ((newSize.width() > image.width())
+            ? Qt::SmoothTransformation : Qt::FastTransformation));
+    } else if (image.size() != plan.displaySize) {
+        image = image.scaled(plan.displaySize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
+
+struct WallpaperGenerator::Context
+{
+    std::atomic<quint64> generation = 0;
+#if FRAMELESSHELPER_HAS_THREAD
+    QMutex mutex{};
+#endif
+    // Reset to null once the generator is destroyed, guarded by the mutex.
+    WallpaperGenerator *generator = nullptr;
+};
+
+WallpaperGenerator::WallpaperGenerator(QObject *parent)
+    : QObject(parent), m_context(std::make_shared<Context>())
+{
+    m_context->generator = this;
+}
+
+WallpaperGenerator::~WallpaperGenerator()
+{
+    // Custom task runners may still have our jobs queued, or run them after we are gone.
+#if FRAMELESSHELPER_HAS_THREAD
+    const QMutexLocker locker(&m_context->mutex);
+#endif
+    m_context->generator = nullptr;
+    ++m_context->generation;
+}
+
+void WallpaperGenerator::start()
+{
+    const quint64 generation = ++m_context->generation;
+    BackgroundExecutor::post([context = m_context, generation](){ generate(context, generation); });
+}
+
+void WallpaperGenerator::cancel()
+{
+    ++m_context->generation;
+}
+
+bool WallpaperGenerator::isSuperseded(const Context &context, const quint64 generation)
+{
+    return (generation != context.generation.load());
+}
+
+void WallpaperGenerator::generate(const std::shared_ptr<Context> &context, const quint64 generation)
+{
+    Q_ASSERT(context);
+    if (!context) {
+        return;
     }
+    // A newer request has been made while we were waiting in the queue.
+    if (isSuperseded(*context, generation)) {
+        return;
+    }
+    FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::WallpaperGenerationStarted);
+    QElapsedTimer timer = {};
+    timer.start();
+    const QString wallpaperFilePath = Utils::getWallpaperFilePath();
+    if (wallpaperFilePath.isEmpty()) {
+        WARNING << "Failed to retrieve the wallpaper file path.";
+        return;
+    }
+    const WallpaperAspectStyle aspectStyle = Utils::getWallpaperAspectStyle();
+    const QScreen * const screen = QGuiApplication::primaryScreen();
+    if (!screen) {
+        return;
+    }
+    const QSize wallpaperSize = screen->size();
+    const QImage image = MicaMaterialPrivate::decodeWallpaper(wallpaperFilePath, aspectStyle, wallpaperSize);
+    if (image.isNull()) {
+        return;
+    }
+    if (isSuperseded(*context, generation)) {
+        return;
+    }
+    QImage buffer(wallpaperSize, kDefaultImageFormat);
+#ifdef Q_OS_WINDOWS
+    if (aspectStyle == WallpaperAspectStyle::Center) {
+        buffer.fill(kDefaultBlackColor);
+    }
+#endif
     static constexpr const QPoint desktopOriginPoint = {0, 0};
     const QRect desktopRect = {desktopOriginPoint, wallpaperSize};
     if (aspectStyle == WallpaperAspectStyle::Tile) {
@@ -564,13 +930,14 @@ void WallpaperThread::start()
         const QRect rect = alignedRect(Qt::LeftToRight, Qt::AlignCenter, image.size(), desktopRect);
         bufferPainter.drawImage(rect.topLeft(), image);
     }
+    if (isSuperseded(*context, generation)) {
+        return;
+    }
+    // Blur and pack outside of the lock, the paint thread only waits for the final swap.
+    QImage blurredImage(wallpaperSize, QImage::Format_ARGB32_Premultiplied);
+    blurredImage.fill(kDefaultTransparentColor);
     {
-#if FRAMELESSHELPER_HAS_THREAD
-        const QMutexLocker locker(&g_imageData()->mutex);
-#endif
-        g_imageData()->blurredWallpaper = QPixmap(wallpaperSize);
-        g_imageData()->blurredWallpaper.fill(kDefaultTransparentColor);
-        QPainter painter(&g_imageData()->blurredWallpaper);
+        QPainter painter(&blurredImage);
         // Same here.
         painter.setRenderHint(QPainter::Antialiasing, false);
         painter.setRenderHint(QPainter::TextAntialiasing, false);
@@ -581,27 +948,90 @@ void WallpaperThread::start()
         painter.drawImage(desktopOriginPoint, buffer);
 #endif // FRAMELESSHELPER_CONFIG(private_qt)
     }
-    Q_EMIT imageUpdated();
+    buffer = {};
+    // Packing is not cheap either, don't waste it on a stale result.
+    if (isSuperseded(*context, generation)) {
+        return;
+    }
+    WallpaperStorageFormat storageFormat = WallpaperStorageFormat::Argb32;
+    {
+#if FRAMELESSHELPER_HAS_THREAD
+        const QMutexLocker locker(&context->mutex);
+#endif
+        // The global data is gone if a custom task runner ran us during application exit.
+        if (!context->generator || g_imageData.isDestroyed()) {
+            return;
+        }
+#if FRAMELESSHELPER_HAS_THREAD
+        const QMutexLocker imageLocker(&g_imageData()->mutex);
+#endif
+        storageFormat = g_imageData()->storageFormat;
+    }
+    WallpaperStorage blurredWallpaper = WallpaperStorage::pack(blurredImage, storageFormat);
+    QImage reducedWallpaper = blurredImage.scaled(wallpaperSize / kReducedWallpaperScaleFactor,
+        Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_RGB32);
+    blurredImage = {};
+    DEBUG << "The blurred wallpaper occupies" << blurredWallpaper.byteCount() << "bytes in" << storageFormat;
+#if FRAMELESSHELPER_HAS_THREAD
+    // Keeps the generator alive until we are done with it.
+    const QMutexLocker locker(&context->mutex);
+#endif
+    if (!context->generator || g_imageData.isDestroyed()) {
+        return;
+    }
+    {
+#if FRAMELESSHELPER_HAS_THREAD
+        const QMutexLocker imageLocker(&g_imageData()->mutex);
+#endif
+        // Never overwrite the result of a newer generation which finished before us.
+        if (isSuperseded(*context, generation)) {
+            return;
+        }
+        g_imageData()->blurredWallpaper = std::move(blurredWallpaper);
+        g_imageData()->reducedWallpaper = std::move(reducedWallpaper);
+        ++g_imageData()->wallpaperSerial;
+    }
+    FRAMELESSHELPER_DIAGNOSTICS_RECORD(DiagnosticsEvent::WallpaperGenerationFinished, 0,
+        quintptr(wallpaperSize.width()), quintptr(wallpaperSize.height()), quintptr(timer.nsecsElapsed() / 1000));
+    Q_EMIT context->generator->imageUpdated();
 }
 
 struct ThreadData
 {
-    std::unique_ptr<WallpaperThread> thread = nullptr;
+    std::unique_ptr<WallpaperGenerator> generator = nullptr;
 #if FRAMELESSHELPER_HAS_THREAD
     QMutex mutex{};
 #endif
 };
 Q_GLOBAL_STATIC(ThreadData, g_threadData)
 
+// Dark theme, tint color, tint opacity and noise opacity.
+using MaterialBrushKey = std::tuple<bool, QRgb, qreal, qreal>;
+
+struct MaterialBrushCache
+{
+    struct Entry
+    {
+        QBrush brush = {};
+        QBrush brushWithoutNoise = {};
+        // The theme generation this entry was last used in.
+        quint64 generation = 0;
+    };
+    std::map<MaterialBrushKey, Entry> entries = {};
+    quint64 builds = 0;
+    quint64 hits = 0;
+};
+Q_GLOBAL_STATIC(MaterialBrushCache, g_materialBrushCache)
+
 #if FRAMELESSHELPER_HAS_THREAD
 static inline void threadCleaner()
 {
     const QMutexLocker locker(&g_threadData()->mutex);
-    if (g_threadData()->thread && g_threadData()->thread->isRunning()) {
-        g_threadData()->thread->requestInterruption();
-        g_threadData()->thread->quit();
-        g_threadData()->thread->wait();
+    if (g_threadData()->generator) {
+        // Drop the queued generations, then wait for the running one.
+        g_threadData()->generator->cancel();
     }
+    BackgroundExecutor::waitForDone();
 }
 #endif
 
@@ -615,7 +1045,10 @@ MicaMaterialPrivate::MicaMaterialPrivate(MicaMaterial *q) : QObject(q)
     initialize();
 }
 
-MicaMaterialPrivate::~MicaMaterialPrivate() = default;
+MicaMaterialPrivate::~MicaMaterialPrivate()
+{
+    FramelessManagerPrivate::removeThemeSubscriber(this);
+}
 
 MicaMaterialPrivate *MicaMaterialPrivate::get(MicaMaterial *q)
 {
@@ -649,15 +1082,10 @@ void MicaMaterialPrivate::maybeGenerateBlurredWallpaper(const bool force)
 #if FRAMELESSHELPER_HAS_THREAD
     g_imageData()->mutex.unlock();
     const QMutexLocker locker(&g_threadData()->mutex);
-    if (g_threadData()->thread->isRunning()) {
-        g_threadData()->thread->requestInterruption();
-        g_threadData()->thread->quit();
-        g_threadData()->thread->wait();
-    }
-    g_threadData()->thread->start(QThread::LowPriority);
-#else
-    g_threadData()->thread->start();
 #endif
+    // Any generation which is still queued or running becomes stale, we don't need to
+    // block the GUI thread to wait for it anymore.
+    g_threadData()->generator->start();
 }
 
 void MicaMaterialPrivate::updateMaterialBrush()
@@ -666,23 +1094,65 @@ void MicaMaterialPrivate::updateMaterialBrush()
     FramelessHelperCoreInitResource();
     static const QImage noiseTexture = QImage(FRAMELESSHELPER_STRING_LITERAL(":/org.wangwenx190.FramelessHelper/resources/images/noise.png"));
 #endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
+    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
+    // Most mica materials share the same parameters, so there's no need to re-generate
+    // the same texture for each of them when the theme changes. The textures are keyed
+    // by their parameters, materials with different parameters don't evict each other.
+    const MaterialBrushKey key = std::make_tuple(dark, tintColor.rgba(), tintOpacity, noiseOpacity);
+    MaterialBrushCache &cache = *g_materialBrushCache();
+    const auto it = cache.entries.find(key);
+    if (it != cache.entries.end()) {
+        it->second.generation = FramelessManagerPrivate::themeGeneration();
+        micaBrush = it->second.brush;
+        micaBrushWithoutNoise = it->second.brushWithoutNoise;
+        ++cache.hits;
+        if (initialized) {
+            Q_Q(MicaMaterial);
+            Q_EMIT q->shouldRedraw();
+        }
+        return;
+    }
     QImage micaTexture = QImage(QSize(64, 64), kDefaultImageFormat);
-    QColor fillColor = ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultSystemDarkColor : kDefaultSystemLightColor2);
+    QColor fillColor = (dark ? kDefaultSystemDarkColor : kDefaultSystemLightColor2);
     fillColor.setAlphaF(0.9f);
     micaTexture.fill(fillColor);
-    QPainter painter(&micaTexture);
-    // Same as above. We need speed, not quality.
-    painter.setRenderHint(QPainter::Antialiasing, false);
-    painter.setRenderHint(QPainter::TextAntialiasing, false);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
-    painter.setOpacity(tintOpacity);
     const QRect rect = {QPoint(0, 0), micaTexture.size()};
-    painter.fillRect(rect, tintColor);
-    painter.setOpacity(noiseOpacity);
+    {
+        QPainter painter(&micaTexture);
+        // Same as above. We need speed, not quality.
+        painter.setRenderHint(QPainter::Antialiasing, false);
+        painter.setRenderHint(QPainter::TextAntialiasing, false);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        painter.setOpacity(tintOpacity);
+        painter.fillRect(rect, tintColor);
+    }
+    // Used by the lower quality tiers.
+    micaBrushWithoutNoise = QBrush(micaTexture);
+    QImage noisyTexture = micaTexture.copy();
+    {
+        QPainter painter(&noisyTexture);
+        painter.setRenderHint(QPainter::Antialiasing, false);
+        painter.setRenderHint(QPainter::TextAntialiasing, false);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        painter.setOpacity(noiseOpacity);
 #if FRAMELESSHELPER_CONFIG(bundle_resource)
-    painter.fillRect(rect, QBrush(noiseTexture));
+        painter.fillRect(rect, QBrush(noiseTexture));
 #endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
-    micaBrush = QBrush(micaTexture);
+    }
+    micaBrush = QBrush(noisyTexture);
+    const quint64 generation = FramelessManagerPrivate::themeGeneration();
+    if (cache.entries.size() >= kMaximumMaterialBrushCacheSize) {
+        // Drop the textures nobody has used since the last theme change.
+        for (auto entry = cache.entries.begin(); entry != cache.entries.end();) {
+            if (entry->second.generation != generation) {
+                entry = cache.entries.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+    }
+    cache.entries[key] = { micaBrush, micaBrushWithoutNoise, generation };
+    ++cache.builds;
     if (initialized) {
         Q_Q(MicaMaterial);
         Q_EMIT q->shouldRedraw();
@@ -700,13 +1170,13 @@ void MicaMaterialPrivate::initialize()
 #if FRAMELESSHELPER_HAS_THREAD
     g_threadData()->mutex.lock();
 #endif
-    if (!g_threadData()->thread) {
-        g_threadData()->thread = std::make_unique<WallpaperThread>();
+    if (!g_threadData()->generator) {
+        g_threadData()->generator = std::make_unique<WallpaperGenerator>();
 #if FRAMELESSHELPER_HAS_THREAD
         qAddPostRoutine(threadCleaner);
 #endif
     }
-    connect(g_threadData()->thread.get(), &WallpaperThread::imageUpdated, this, [this](){
+    connect(g_threadData()->generator.get(), &WallpaperGenerator::imageUpdated, this, [this](){
         if (initialized) {
             Q_Q(MicaMaterial);
             Q_EMIT q->shouldRedraw();
@@ -724,10 +1194,15 @@ void MicaMaterialPrivate::initialize()
     // whether we should use the system color instead.
     noiseOpacity = kDefaultNoiseOpacity;
 
+    frameBudget = kDefaultFrameBudget;
+    qualityRecoveryInterval = kDefaultQualityRecoveryInterval;
+    qualityRecoveryTimer.setSingleShot(true);
+    qualityRecoveryTimer.setInterval(qualityRecoveryInterval);
+    connect(&qualityRecoveryTimer, &QTimer::timeout, this, &MicaMaterialPrivate::maybeRecoverQuality);
+
     updateMaterialBrush();
 
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged,
-        this, &MicaMaterialPrivate::updateMaterialBrush);
+    FramelessManagerPrivate::addThemeSubscriber(this, [this](){ updateMaterialBrush(); });
     connect(FramelessManager::instance(), &FramelessManager::wallpaperChanged,
         this, &MicaMaterialPrivate::forceRebuildWallpaper);
     connect(qGuiApp, &QGuiApplication::primaryScreenChanged,
@@ -758,6 +1233,82 @@ void MicaMaterialPrivate::prepareGraphicsResources()
     maybeGenerateBlurredWallpaper();
 }
 
+void MicaMaterialPrivate::updateQuality(const qint64 paintCost)
+{
+    lastPaintTimer.start();
+    if (!adaptiveQualityEnabled) {
+        return;
+    }
+    const qreal cost = (qreal(paintCost) / qreal(1000000));
+    if (averagePaintCost < qreal(0)) {
+        averagePaintCost = cost;
+    } else {
+        averagePaintCost += ((cost - averagePaintCost) * kPaintCostSmoothingFactor);
+    }
+    if (averagePaintCost <= frameBudget) {
+        overBudgetPaints = 0;
+        return;
+    }
+    ++overBudgetPaints;
+    if (overBudgetPaints < kQualityDowngradeThreshold) {
+        return;
+    }
+    const MicaQuality current = quality;
+    if (current != MicaQuality::Solid) {
+        DEBUG << "Mica material paints take" << averagePaintCost << "ms on average, exceeding the"
+              << frameBudget << "ms budget. Lowering the quality.";
+        setQuality(MicaQuality(int(current) + 1));
+    }
+    qualityRecoveryTimer.start(qualityRecoveryInterval * recoveryBackoff);
+    // Back off in case we are oscillating between two tiers.
+    recoveryBackoff = std::min((recoveryBackoff * 2), kMaximumQualityRecoveryBackoff);
+}
+
+void MicaMaterialPrivate::reportPaintCost(const qint64 paintCost)
+{
+    const auto update = [this, paintCost](){ updateQuality(paintCost); };
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+    QMetaObject::invokeMethod(this, update, Qt::AutoConnection);
+#else
+    if (thread() == QThread::currentThread()) {
+        update();
+    } else {
+        QTimer::singleShot(0, this, update);
+    }
+#endif
+}
+
+void MicaMaterialPrivate::maybeRecoverQuality()
+{
+    const MicaQuality current = quality;
+    if (current == MicaQuality::Full) {
+        // Stayed at full quality for a whole interval, the load has really gone.
+        recoveryBackoff = 1;
+        return;
+    }
+    // Still busy painting (most likely being resized), stepping up now would stutter again.
+    if (lastPaintTimer.isValid() && (lastPaintTimer.elapsed() < kQualityIdleThreshold)) {
+        qualityRecoveryTimer.start(kQualityIdleThreshold);
+        return;
+    }
+    setQuality(MicaQuality(int(current) - 1));
+    qualityRecoveryTimer.start(qualityRecoveryInterval);
+}
+
+void MicaMaterialPrivate::setQuality(const MicaQuality value)
+{
+    if (quality == value) {
+        return;
+    }
+    quality = value;
+    // The moving average describes the previous tier only.
+    averagePaintCost = qreal(-1);
+    overBudgetPaints = 0;
+    Q_Q(MicaMaterial);
+    Q_EMIT q->qualityChanged();
+    Q_EMIT q->shouldRedraw();
+}
+
 QColor MicaMaterialPrivate::systemFallbackColor()
 {
     return ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultFallbackColorDark : kDefaultFallbackColorLight);
@@ -812,6 +1363,50 @@ QRect MicaMaterialPrivate::mapToWallpaper(const QRect &rect) const
     return mappedRect.toRect();
 }
 
+quint64 MicaMaterialPrivate::wallpaperKey(const MicaQuality quality)
+{
+#if FRAMELESSHELPER_HAS_THREAD
+    const QMutexLocker locker(&g_imageData()->mutex);
+#endif
+    if (g_imageData()->blurredWallpaper.isNull()) {
+        return 0;
+    }
+    const bool reduced = ((quality == MicaQuality::Reduced) && !g_imageData()->reducedWallpaper.isNull());
+    return ((g_imageData()->wallpaperSerial << 1) | (reduced ? 1 : 0));
+}
+
+QImage MicaMaterialPrivate::wallpaperImage(const MicaQuality quality)
+{
+#if FRAMELESSHELPER_HAS_THREAD
+    const QMutexLocker locker(&g_imageData()->mutex);
+#endif
+    if ((quality == MicaQuality::Reduced) && !g_imageData()->reducedWallpaper.isNull()) {
+        return g_imageData()->reducedWallpaper;
+    }
+    return g_imageData()->blurredWallpaper.toImage();
+}
+
+QBrush MicaMaterialPrivate::materialBrush(const bool active, const MicaQuality quality) const
+{
+    if ((!fallbackEnabled || active) && (quality != MicaQuality::Solid)) {
+        return ((quality == MicaQuality::Full) ? micaBrush : micaBrushWithoutNoise);
+    }
+    if (fallbackColor.isValid()) {
+        return fallbackColor;
+    }
+    return systemFallbackColor();
+}
+
+MicaMaterialPrivate::BrushCacheStatistics MicaMaterialPrivate::brushCacheStatistics()
+{
+    const MaterialBrushCache &cache = *g_materialBrushCache();
+    BrushCacheStatistics statistics = {};
+    statistics.builds = cache.builds;
+    statistics.hits = cache.hits;
+    statistics.textures = int(cache.entries.size());
+    return statistics;
+}
+
 MicaMaterial::MicaMaterial(QObject *parent)
     : QObject(parent), d_ptr(std::make_unique<MicaMaterialPrivate>(this))
 {
@@ -917,6 +1512,107 @@ void MicaMaterial::setFallbackEnabled(const bool value)
     Q_EMIT fallbackEnabledChanged();
 }
 
+WallpaperStorageFormat MicaMaterial::wallpaperStorageFormat()
+{
+#if FRAMELESSHELPER_HAS_THREAD
+    const QMutexLocker locker(&g_imageData()->mutex);
+#endif
+    return g_imageData()->storageFormat;
+}
+
+void MicaMaterial::setWallpaperStorageFormat(const WallpaperStorageFormat value)
+{
+    {
+#if FRAMELESSHELPER_HAS_THREAD
+        const QMutexLocker locker(&g_imageData()->mutex);
+#endif
+        if (g_imageData()->storageFormat == value) {
+            return;
+        }
+        g_imageData()->storageFormat = value;
+        // Nothing has been generated yet, the first generation will use the new format.
+        if (!g_imageData()->graphicsResourcesReady) {
+            return;
+        }
+    }
+#if FRAMELESSHELPER_HAS_THREAD
+    const QMutexLocker locker(&g_threadData()->mutex);
+#endif
+    // The stored wallpaper has to be packed again in the new format, every material
+    // redraws once it's done.
+    if (g_threadData()->generator) {
+        g_threadData()->generator->start();
+    }
+}
+
+MicaQuality MicaMaterial::quality() const
+{
+    Q_D(const MicaMaterial);
+    return d->quality;
+}
+
+bool MicaMaterial::isAdaptiveQualityEnabled() const
+{
+    Q_D(const MicaMaterial);
+    return d->adaptiveQualityEnabled;
+}
+
+void MicaMaterial::setAdaptiveQualityEnabled(const bool value)
+{
+    Q_D(MicaMaterial);
+    if (d->adaptiveQualityEnabled == value) {
+        return;
+    }
+    d->adaptiveQualityEnabled = value;
+    if (!value) {
+        d->qualityRecoveryTimer.stop();
+        d->recoveryBackoff = 1;
+        d->setQuality(MicaQuality::Full);
+    }
+    Q_EMIT adaptiveQualityEnabledChanged();
+}
+
+qreal MicaMaterial::frameBudget() const
+{
+    Q_D(const MicaMaterial);
+    return d->frameBudget;
+}
+
+void MicaMaterial::setFrameBudget(const qreal value)
+{
+    Q_ASSERT(value > qreal(0));
+    if (value <= qreal(0)) {
+        return;
+    }
+    Q_D(MicaMaterial);
+    if (qFuzzyCompare(d->frameBudget, value)) {
+        return;
+    }
+    d->frameBudget = value;
+    d->overBudgetPaints = 0;
+    Q_EMIT frameBudgetChanged();
+}
+
+int MicaMaterial::qualityRecoveryInterval() const
+{
+    Q_D(const MicaMaterial);
+    return d->qualityRecoveryInterval;
+}
+
+void MicaMaterial::setQualityRecoveryInterval(const int value)
+{
+    Q_ASSERT(value > 0);
+    if (value <= 0) {
+        return;
+    }
+    Q_D(MicaMaterial);
+    if (d->qualityRecoveryInterval == value) {
+        return;
+    }
+    d->qualityRecoveryInterval = value;
+    Q_EMIT qualityRecoveryIntervalChanged();
+}
+
 void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active)
 {
     Q_ASSERT(painter);
@@ -925,6 +1621,10 @@ void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active
     }
     Q_D(MicaMaterial);
     d->prepareGraphicsResources();
+    // Only the CPU side cost can be measured, which is all there is for the raster engine.
+    QElapsedTimer paintTimer = {};
+    paintTimer.start();
+    const MicaQuality quality = d->quality;
     static constexpr const auto originPoint = QPoint{ 0, 0 };
     const QRect wallpaperRect = { originPoint, d->wallpaperSize };
     const QRect mappedRect = d->mapToWallpaper(rect);
@@ -933,12 +1633,25 @@ void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active
     painter->setRenderHint(QPainter::Antialiasing, false);
     painter->setRenderHint(QPainter::TextAntialiasing, false);
     painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
-    if (active) {
+    // The caller must hold the image mutex.
+    const auto drawWallpaper = [painter, quality](const QPoint &target, const QRect &source) -> void {
+        const QImage &reducedWallpaper = g_imageData()->reducedWallpaper;
+        const QSize fullSize = g_imageData()->blurredWallpaper.size();
+        if ((quality == MicaQuality::Reduced) && !reducedWallpaper.isNull() && !fullSize.isEmpty()) {
+            const qreal xRatio = (qreal(reducedWallpaper.width()) / qreal(fullSize.width()));
+            const qreal yRatio = (qreal(reducedWallpaper.height()) / qreal(fullSize.height()));
+            const QRectF reducedSource = { source.x() * xRatio, source.y() * yRatio, source.width() * xRatio, source.height() * yRatio };
+            painter->drawImage(QRectF(target, source.size()), reducedWallpaper, reducedSource);
+            return;
+        }
+        g_imageData()->blurredWallpaper.draw(painter, target, source);
+    };
+    if (active && (quality != MicaQuality::Solid)) {
         const QRect intersectedRect = wallpaperRect.intersected(mappedRect);
 #if FRAMELESSHELPER_HAS_THREAD
         g_imageData()->mutex.lock();
 #endif
-        painter->drawPixmap(originPoint, g_imageData()->blurredWallpaper, intersectedRect);
+        drawWallpaper(originPoint, intersectedRect);
 #if FRAMELESSHELPER_HAS_THREAD
         g_imageData()->mutex.unlock();
 #endif
@@ -951,7 +1664,7 @@ void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active
 #if FRAMELESSHELPER_HAS_THREAD
                 const QMutexLocker locker(&g_imageData()->mutex);
 #endif
-                painter->drawPixmap(outerRectOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRect);
+                drawWallpaper(outerRectOriginPoint, mappedOuterRect);
             } else {
                 static constexpr const auto yOffset = QPoint{ 0, 1 };
                 const QRect outerRectBottom = { intersectedRect.bottomLeft() + yOffset, QSize{ intersectedRect.width(), mappedRect.height() - intersectedRect.height() } };
@@ -960,7 +1673,7 @@ void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active
 #if FRAMELESSHELPER_HAS_THREAD
                 g_imageData()->mutex.lock();
 #endif
-                painter->drawPixmap(outerRectBottomOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectBottom);
+                drawWallpaper(outerRectBottomOriginPoint, mappedOuterRectBottom);
 #if FRAMELESSHELPER_HAS_THREAD
                 g_imageData()->mutex.unlock();
 #endif
@@ -974,23 +1687,33 @@ void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active
 #if FRAMELESSHELPER_HAS_THREAD
                     const QMutexLocker locker(&g_imageData()->mutex);
 #endif
-                    painter->drawPixmap(outerRectRightOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectRight);
-                    painter->drawPixmap(outerRectCornerOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectCorner);
+                    drawWallpaper(outerRectRightOriginPoint, mappedOuterRectRight);
+                    drawWallpaper(outerRectCornerOriginPoint, mappedOuterRectCorner);
                 }
             }
         }
     }
     painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
     painter->setOpacity(qreal(1));
-    painter->fillRect(QRect{originPoint, mappedRect.size()}, [d, active]() -> QBrush {
-        if (!d->fallbackEnabled || active) {
-            return d->micaBrush;
-        }
-        if (d->fallbackColor.isValid()) {
-            return d->fallbackColor;
-        }
-        return d->systemFallbackColor();
-    }());
+    painter->fillRect(QRect{originPoint, mappedRect.size()}, d->materialBrush(active, quality));
+    painter->restore();
+    d->reportPaintCost(paintTimer.nsecsElapsed());
+}
+
+void MicaMaterial::paint(QPainter *painter, const QRect &rect, const QRegion &clip, const bool active)
+{
+    Q_ASSERT(painter);
+    if (!painter) {
+        return;
+    }
+    if (clip.isEmpty()) {
+        return;
+    }
+    painter->save();
+    // The raster engine only blends the spans inside the clip, which is where the
+    // saving comes from when most of the window is covered by opaque widgets.
+    painter->setClipRegion(clip, Qt::IntersectClip);
+    paint(painter, rect, active);
     painter->restore();
 }
 
@@ -0,0 +1,278 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "moveresizeengine_p.h"
+#include <QtCore/qloggingcategory.h>
+#include <QtGui/qscreen.h>
+#include <QtGui/qwindow.h>
+#include <algorithm>
+#include <cstdlib>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcMoveResizeEngine, "wangwenx190.framelesshelper.core.moveresizeengine")
+#  define INFO qCInfo(lcMoveResizeEngine)
+#  define DEBUG qCDebug(lcMoveResizeEngine)
+#  define WARNING qCWarning(lcMoveResizeEngine)
+#  define CRITICAL qCCritical(lcMoveResizeEngine)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+static constexpr const int kDefaultSnapDistance = 10;
+static constexpr const qreal kDefaultRefreshRate = 60.0;
+// Same value as QWINDOWSIZE_MAX.
+static constexpr const int kMaximumWindowSize = ((1 << 24) - 1);
+
+[[nodiscard]] static inline int snapValue(const int value, const int target, const int distance)
+{
+    return ((std::abs(value - target) <= distance) ? target : value);
+}
+
+MoveResizeEngine::MoveResizeEngine(QObject *parent) : QObject(parent)
+{
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &MoveResizeEngine::flush);
+}
+
+MoveResizeEngine::~MoveResizeEngine() = default;
+
+bool MoveResizeEngine::isActive() const
+{
+    return m_active;
+}
+
+QWindow *MoveResizeEngine::window() const
+{
+    return m_window;
+}
+
+Qt::Edges MoveResizeEngine::edges() const
+{
+    return m_edges;
+}
+
+bool MoveResizeEngine::start(QWindow *window, const Qt::Edges edges, const QPoint &globalPos)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return false;
+    }
+    if (m_active) {
+        stop();
+    }
+    const QWindow::Visibility visibility = window->visibility();
+    if ((visibility != QWindow::Windowed) && (visibility != QWindow::AutomaticVisibility)) {
+        // Maximized, minimized and fullscreen windows can't be moved or resized.
+        return false;
+    }
+    m_window = window;
+    m_edges = edges;
+    m_startGeometry = window->geometry();
+    m_startPos = globalPos;
+    m_pendingPos = globalPos;
+    m_dirty = false;
+    m_active = true;
+    qreal refreshRate = kDefaultRefreshRate;
+    if (const QScreen * const screen = window->screen()) {
+        if (screen->refreshRate() > qreal(1)) {
+            refreshRate = screen->refreshRate();
+        }
+    }
+    m_frameTimer.setInterval(std::max(1, qRound(qreal(1000) / refreshRate)));
+    DEBUG << "Software" << ((edges == Qt::Edges{}) ? "move" : "resize") << "started for" << window;
+    return true;
+}
+
+void MoveResizeEngine::update(const QPoint &globalPos)
+{
+    if (!m_active) {
+        return;
+    }
+    m_pendingPos = globalPos;
+    m_dirty = true;
+    // Coalesce all the mouse moves inside the same frame into one geometry change.
+    if (!m_frameTimer.isActive()) {
+        m_frameTimer.start();
+    }
+}
+
+void MoveResizeEngine::finish(const QPoint &globalPos)
+{
+    if (!m_active) {
+        return;
+    }
+    update(globalPos);
+    flush();
+    stop();
+}
+
+void MoveResizeEngine::cancel()
+{
+    if (!m_active) {
+        return;
+    }
+    if (m_window && (m_window->geometry() != m_startGeometry)) {
+        m_window->setGeometry(m_startGeometry);
+    }
+    stop();
+}
+
+QRect MoveResizeEngine::calculateGeometry(const QRect &startGeometry, const Qt::Edges edges,
+    const QPoint &delta, const Constraints &constraints)
+{
+    const QRect &available = constraints.availableGeometry;
+    const bool snap = (available.isValid() && (constraints.snapDistance > 0));
+    const int availableLeft = available.x();
+    const int availableTop = available.y();
+    const int availableRight = (available.x() + available.width());
+    const int availableBottom = (available.y() + available.height());
+    if (edges == Qt::Edges{}) {
+        QRect geometry = startGeometry.translated(delta);
+        if (snap) {
+            const int left = snapValue(geometry.x(), availableLeft, constraints.snapDistance);
+            if (left != geometry.x()) {
+                geometry.moveLeft(left);
+            } else {
+                const int right = snapValue(geometry.x() + geometry.width(), availableRight, constraints.snapDistance);
+                geometry.moveLeft(right - geometry.width());
+            }
+            const int top = snapValue(geometry.y(), availableTop, constraints.snapDistance);
+            if (top != geometry.y()) {
+                geometry.moveTop(top);
+            } else {
+                const int bottom = snapValue(geometry.y() + geometry.height(), availableBottom, constraints.snapDistance);
+                geometry.moveTop(bottom - geometry.height());
+            }
+        }
+        return geometry;
+    }
+    // Use exclusive right/bottom coordinates to avoid the off-by-one of QRect::right().
+    int left = startGeometry.x();
+    int top = startGeometry.y();
+    int right = (startGeometry.x() + startGeometry.width());
+    int bottom = (startGeometry.y() + startGeometry.height());
+    if (edges & Qt::LeftEdge) {
+        left += delta.x();
+        if (snap) {
+            left = snapValue(left, availableLeft, constraints.snapDistance);
+        }
+    }
+    if (edges & Qt::RightEdge) {
+        right += delta.x();
+        if (snap) {
+            right = snapValue(right, availableRight, constraints.snapDistance);
+        }
+    }
+    if (edges & Qt::TopEdge) {
+        top += delta.y();
+        if (snap) {
+            top = snapValue(top, availableTop, constraints.snapDistance);
+        }
+    }
+    if (edges & Qt::BottomEdge) {
+        bottom += delta.y();
+        if (snap) {
+            bottom = snapValue(bottom, availableBottom, constraints.snapDistance);
+        }
+    }
+    const int minimumWidth = std::max(1, constraints.minimumSize.width());
+    const int minimumHeight = std::max(1, constraints.minimumSize.height());
+    const int maximumWidth = ((constraints.maximumSize.width() > 0)
+        ? std::max(minimumWidth, constraints.maximumSize.width()) : kMaximumWindowSize);
+    const int maximumHeight = ((constraints.maximumSize.height() > 0)
+        ? std::max(minimumHeight, constraints.maximumSize.height()) : kMaximumWindowSize);
+    // The edge opposite to the dragged one is the anchor and never moves.
+    const int width = std::clamp(right - left, minimumWidth, maximumWidth);
+    const int height = std::clamp(bottom - top, minimumHeight, maximumHeight);
+    if (edges & Qt::LeftEdge) {
+        left = (right - width);
+    }
+    if (edges & Qt::TopEdge) {
+        top = (bottom - height);
+    }
+    return QRect(left, top, width, height);
+}
+
+void MoveResizeEngine::flush()
+{
+    m_frameTimer.stop();
+    if (!m_active || !m_dirty) {
+        return;
+    }
+    m_dirty = false;
+    if (!m_window) {
+        stop();
+        return;
+    }
+    const QRect geometry = calculateGeometry(m_startGeometry, m_edges, (m_pendingPos - m_startPos), constraints());
+    if (geometry == m_window->geometry()) {
+        return;
+    }
+    if (m_edges == Qt::Edges{}) {
+        // Only change the position, otherwise the window may be re-laid out for nothing.
+        m_window->setPosition(geometry.topLeft());
+    } else {
+        m_window->setGeometry(geometry);
+    }
+}
+
+void MoveResizeEngine::stop()
+{
+    m_frameTimer.stop();
+    m_active = false;
+    m_dirty = false;
+    m_window = nullptr;
+    m_edges = {};
+}
+
+MoveResizeEngine::Constraints MoveResizeEngine::constraints() const
+{
+    Constraints constraints = {};
+    if (!m_window) {
+        return constraints;
+    }
+    constraints.minimumSize = m_window->minimumSize();
+    constraints.maximumSize = m_window->maximumSize();
+    // Use the screen which contains the pointer, the window may be dragged across screens.
+    const QScreen *screen = m_window->screen();
+    if (screen) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+        if (const QScreen * const pointerScreen = screen->virtualSiblingAt(m_pendingPos)) {
+            screen = pointerScreen;
+        }
+#endif // (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+        constraints.availableGeometry = screen->availableGeometry();
+        constraints.snapDistance = kDefaultSnapDistance;
+    }
+    return constraints;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
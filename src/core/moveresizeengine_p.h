@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/moveresizeengine_p.h"
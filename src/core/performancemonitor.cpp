@@ -0,0 +1,307 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "performancemonitor_p.h"
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+
+#include "framelessconfig_p.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qfontmetrics.h>
+#include <algorithm>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+using namespace Global;
+
+static constexpr const int kFrameHistorySize = 100;
+// Longer gaps are idle time rather than slow frames.
+static constexpr const qint64 kMaximumFrameInterval = 250000; // us
+static constexpr const qint64 kOneSecond = 1000000000; // ns
+static constexpr const int kOverlayRefreshInterval = 500; // ms
+
+static constexpr const QSize kOverlaySize = { 212, 136 };
+static constexpr const int kOverlayPadding = 6;
+static constexpr const int kGraphHeight = 48;
+static constexpr const int kFontPixelSize = 11;
+// The full height of the graph, two frames at 60Hz.
+static constexpr const qreal kGraphScale = 33333.0; // us
+static constexpr const qint64 kFrameBudget = 16667; // us
+
+static constexpr const std::array<const char *, int(PerformanceComponent::Last) + 1> g_componentNames =
+{
+    "Mica material",
+    "Window border",
+    "Title bar"
+};
+
+struct WindowPerformanceData
+{
+    std::array<qint64, kFrameHistorySize> frameTimes = {}; // Ring buffer.
+    int frameCount = 0;
+    int nextFrameIndex = 0;
+    qint64 lastFrameTimestamp = -1; // ns
+    std::array<qint64, int(PerformanceComponent::Last) + 1> paintCosts = {};
+    qint64 eventFilterBucketStart = -1; // ns
+    qint64 eventFilterCurrentCost = 0; // ns
+    qint64 eventFilterLastCost = 0; // ns
+
+    WindowPerformanceData()
+    {
+        paintCosts.fill(-1);
+    }
+};
+
+struct PerformanceData
+{
+    QMutex mutex{};
+    QElapsedTimer clock{};
+    QHash<const QObject *, WindowPerformanceData> windows = {};
+
+    PerformanceData()
+    {
+        clock.start();
+    }
+};
+
+Q_GLOBAL_STATIC(PerformanceData, g_performanceData)
+
+// Moves the event filter cost into the finished second once it's over.
+static inline void rollEventFilterBucket(WindowPerformanceData &data, const qint64 now)
+{
+    if (data.eventFilterBucketStart < 0) {
+        data.eventFilterBucketStart = now;
+        return;
+    }
+    const qint64 elapsed = (now - data.eventFilterBucketStart);
+    if (elapsed < kOneSecond) {
+        return;
+    }
+    // If the current bucket ended more than one second ago, the last whole second was idle.
+    data.eventFilterLastCost = ((elapsed < (kOneSecond * 2)) ? data.eventFilterCurrentCost : 0);
+    data.eventFilterCurrentCost = 0;
+    data.eventFilterBucketStart = (now - (elapsed % kOneSecond));
+}
+
+[[nodiscard]] static inline QString formatCost(const qint64 usecs, const char *suffix = " ms")
+{
+    if (usecs < 0) {
+        return FRAMELESSHELPER_STRING_LITERAL("-");
+    }
+    return (QString::number(qreal(usecs) / qreal(1000), 'f', 2) + QUtf8String(suffix));
+}
+
+[[nodiscard]] static inline QColor frameColor(const qint64 usecs)
+{
+    if (usecs <= kFrameBudget) {
+        return QColor(80, 200, 120);
+    }
+    if (usecs <= (kFrameBudget * 2)) {
+        return QColor(230, 190, 60);
+    }
+    return QColor(230, 80, 70);
+}
+
+bool PerformanceMonitor::isEnabled()
+{
+    return FramelessConfig::instance()->isSet(Option::EnablePerformanceOverlay);
+}
+
+void PerformanceMonitor::recordFrame(const QObject *window)
+{
+    Q_ASSERT(window);
+    if (!window || !isEnabled()) {
+        return;
+    }
+    const QMutexLocker locker(&g_performanceData()->mutex);
+    const qint64 now = g_performanceData()->clock.nsecsElapsed();
+    WindowPerformanceData &data = g_performanceData()->windows[window];
+    if (data.lastFrameTimestamp >= 0) {
+        const qint64 interval = ((now - data.lastFrameTimestamp) / 1000);
+        if (interval <= kMaximumFrameInterval) {
+            data.frameTimes.at(data.nextFrameIndex) = interval;
+            data.nextFrameIndex = ((data.nextFrameIndex + 1) % kFrameHistorySize);
+            data.frameCount = std::min(data.frameCount + 1, kFrameHistorySize);
+        }
+    }
+    data.lastFrameTimestamp = now;
+}
+
+void PerformanceMonitor::recordPaintCost(const QObject *window, const PerformanceComponent component, const qint64 nsecs)
+{
+    Q_ASSERT(window);
+    if (!window || !isEnabled()) {
+        return;
+    }
+    const QMutexLocker locker(&g_performanceData()->mutex);
+    g_performanceData()->windows[window].paintCosts.at(int(component)) = (nsecs / 1000);
+}
+
+void PerformanceMonitor::recordEventFilterCost(const QObject *window, const qint64 nsecs)
+{
+    Q_ASSERT(window);
+    if (!window || !isEnabled()) {
+        return;
+    }
+    const QMutexLocker locker(&g_performanceData()->mutex);
+    WindowPerformanceData &data = g_performanceData()->windows[window];
+    rollEventFilterBucket(data, g_performanceData()->clock.nsecsElapsed());
+    data.eventFilterCurrentCost += nsecs;
+}
+
+void PerformanceMonitor::removeWindow(const QObject *window)
+{
+    Q_ASSERT(window);
+    if (!window || !isEnabled()) {
+        return;
+    }
+    const QMutexLocker locker(&g_performanceData()->mutex);
+    g_performanceData()->windows.remove(window);
+}
+
+PerformanceSnapshot PerformanceMonitor::snapshot(const QObject *window)
+{
+    Q_ASSERT(window);
+    PerformanceSnapshot result = {};
+    result.paintCosts.fill(-1);
+    if (!window || !isEnabled()) {
+        return result;
+    }
+    const QMutexLocker locker(&g_performanceData()->mutex);
+    const auto it = g_performanceData()->windows.find(window);
+    if (it == g_performanceData()->windows.end()) {
+        return result;
+    }
+    WindowPerformanceData &data = it.value();
+    rollEventFilterBucket(data, g_performanceData()->clock.nsecsElapsed());
+    result.frameTimes.reserve(data.frameCount);
+    const int firstIndex = ((data.nextFrameIndex - data.frameCount + kFrameHistorySize) % kFrameHistorySize);
+    for (int index = 0; index != data.frameCount; ++index) {
+        result.frameTimes.append(data.frameTimes.at((firstIndex + index) % kFrameHistorySize));
+    }
+    result.paintCosts = data.paintCosts;
+    result.eventFilterCost = (data.eventFilterLastCost / 1000);
+    return result;
+}
+
+QSize PerformanceMonitor::overlaySize()
+{
+    return kOverlaySize;
+}
+
+int PerformanceMonitor::overlayRefreshInterval()
+{
+    return kOverlayRefreshInterval;
+}
+
+void PerformanceMonitor::paintOverlay(QPainter *painter, const QRect &rect, const PerformanceSnapshot &snapshot)
+{
+    Q_ASSERT(painter);
+    if (!painter || !rect.isValid()) {
+        return;
+    }
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->fillRect(rect, QColor(0, 0, 0, 180));
+    const QRect contentRect = rect.marginsRemoved({ kOverlayPadding, kOverlayPadding, kOverlayPadding, kOverlayPadding });
+
+    // One bar per frame, the newest one on the right.
+    const QRect graphRect = { contentRect.topLeft(), QSize(contentRect.width(), kGraphHeight) };
+    painter->fillRect(graphRect, QColor(255, 255, 255, 20));
+    const int barWidth = std::max(1, graphRect.width() / kFrameHistorySize);
+    const int frameCount = int(snapshot.frameTimes.size());
+    const int barCount = std::min(frameCount, graphRect.width() / barWidth);
+    qint64 totalFrameTime = 0;
+    qint64 maximumFrameTime = 0;
+    for (int index = 0; index != barCount; ++index) {
+        const qint64 frameTime = snapshot.frameTimes.at(frameCount - barCount + index);
+        totalFrameTime += frameTime;
+        maximumFrameTime = std::max(maximumFrameTime, frameTime);
+        const int barHeight = std::clamp(qRound(qreal(frameTime) / kGraphScale * qreal(kGraphHeight)), 1, kGraphHeight);
+        const int x = (graphRect.right() + 1 - (barCount - index) * barWidth);
+        painter->fillRect(QRect(x, (graphRect.bottom() + 1 - barHeight), barWidth, barHeight), frameColor(frameTime));
+    }
+    // The frame budget at 60Hz.
+    const int budgetY = (graphRect.bottom() + 1 - qRound(qreal(kFrameBudget) / kGraphScale * qreal(kGraphHeight)));
+    painter->fillRect(QRect(graphRect.left(), budgetY, graphRect.width(), 1), QColor(255, 255, 255, 90));
+
+    QFont font = painter->font();
+    font.setPixelSize(kFontPixelSize);
+    painter->setFont(font);
+    painter->setPen(Qt::white);
+    const int lineHeight = QFontMetrics(font).height();
+    QRect lineRect = { contentRect.left(), (graphRect.bottom() + 1 + kOverlayPadding), contentRect.width(), lineHeight };
+    const auto drawLine = [painter, &lineRect](const QString &label, const QString &value) -> void {
+        painter->drawText(lineRect, (Qt::AlignLeft | Qt::AlignVCenter), label);
+        painter->drawText(lineRect, (Qt::AlignRight | Qt::AlignVCenter), value);
+        lineRect.translate(0, lineRect.height());
+    };
+    drawLine(FRAMELESSHELPER_STRING_LITERAL("Frame time (avg / max)"), ((barCount > 0)
+        ? (formatCost(totalFrameTime / barCount, "") + FRAMELESSHELPER_STRING_LITERAL(" / ") + formatCost(maximumFrameTime))
+        : formatCost(-1)));
+    for (int index = 0; index != int(g_componentNames.size()); ++index) {
+        drawLine(QUtf8String(g_componentNames.at(index)), formatCost(snapshot.paintCosts.at(index)));
+    }
+    drawLine(FRAMELESSHELPER_STRING_LITERAL("Event filters"), formatCost(snapshot.eventFilterCost, " ms/s"));
+    painter->restore();
+}
+
+PerformanceScope::PerformanceScope(const QObject *window, const PerformanceComponent component)
+{
+    if (!window || !PerformanceMonitor::isEnabled()) {
+        return;
+    }
+    m_window = window;
+    m_component = int(component);
+    m_timer.start();
+}
+
+PerformanceScope::PerformanceScope(const QObject *window)
+{
+    if (!window || !PerformanceMonitor::isEnabled()) {
+        return;
+    }
+    m_window = window;
+    m_timer.start();
+}
+
+PerformanceScope::~PerformanceScope()
+{
+    if (!m_window) {
+        return;
+    }
+    const qint64 elapsed = m_timer.nsecsElapsed();
+    if (m_component >= 0) {
+        PerformanceMonitor::recordPaintCost(m_window, static_cast<PerformanceComponent>(m_component), elapsed);
+    } else {
+        PerformanceMonitor::recordEventFilterCost(m_window, elapsed);
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(performance_overlay)
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/performancemonitor_p.h"
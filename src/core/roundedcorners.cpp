@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "roundedcorners_p.h"
+#include "framelessconfig_p.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qmath.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qpaintdevice.h>
+#include <cmath>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+using namespace Global;
+
+[[nodiscard]] static inline quint64 cornerMaskKey(const int radius, const qreal devicePixelRatio)
+{
+    return ((quint64(quint32(radius)) << 32) | quint64(quint32(qRound(devicePixelRatio * qreal(100)))));
+}
+
+[[nodiscard]] static inline RoundedCorners::CornerMasks createCornerMasks(const int radius, const qreal devicePixelRatio)
+{
+    const int size = qCeil(qreal(radius) * devicePixelRatio);
+    QImage topLeft(size, size, QImage::Format_ARGB32_Premultiplied);
+    topLeft.fill(kDefaultBlackColor);
+    {
+        QPainter painter(&topLeft);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(kDefaultTransparentColor);
+        painter.drawEllipse(QRectF(0, 0, qreal(size) * 2, qreal(size) * 2));
+    }
+    RoundedCorners::CornerMasks masks = {};
+    masks.at(int(RoundedCorners::Corner::TopLeft)) = topLeft;
+    masks.at(int(RoundedCorners::Corner::TopRight)) = topLeft.mirrored(true, false);
+    masks.at(int(RoundedCorners::Corner::BottomLeft)) = topLeft.mirrored(false, true);
+    masks.at(int(RoundedCorners::Corner::BottomRight)) = topLeft.mirrored(true, true);
+    for (auto &&mask : masks) {
+        mask.setDevicePixelRatio(devicePixelRatio);
+    }
+    return masks;
+}
+
+bool RoundedCorners::isEnabled()
+{
+#if ((defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)) && !FRAMELESSHELPER_CONFIG(native_impl))
+    // Don't cache the result, the options can be changed at any time.
+    const FramelessConfig * const cfg = FramelessConfig::instance();
+    return (cfg->isSet(Option::WindowUseRoundCorners) && !cfg->isSet(Option::WindowUseSquareCorners));
+#else
+    return false;
+#endif
+}
+
+int RoundedCorners::radius()
+{
+    return (isEnabled() ? kDefaultWindowCornerRadius : 0);
+}
+
+RoundedCorners::CornerMasks RoundedCorners::cornerMasks(const int radius, const qreal devicePixelRatio)
+{
+    Q_ASSERT(radius > 0);
+    Q_ASSERT(devicePixelRatio > qreal(0));
+    if ((radius <= 0) || (devicePixelRatio <= qreal(0))) {
+        return {};
+    }
+    static QHash<quint64, CornerMasks> cache = {};
+    const quint64 key = cornerMaskKey(radius, devicePixelRatio);
+    auto it = cache.constFind(key);
+    if (it == cache.constEnd()) {
+        it = cache.insert(key, createCornerMasks(radius, devicePixelRatio));
+    }
+    return it.value();
+}
+
+void RoundedCorners::eraseCorners(QPainter *painter, const QSize &size, const int radius)
+{
+    Q_ASSERT(painter);
+    if (!painter || size.isEmpty() || (radius <= 0)) {
+        return;
+    }
+    const QPaintDevice * const device = painter->device();
+    const qreal dpr = (device ? device->devicePixelRatioF() : qreal(1));
+    const CornerMasks masks = cornerMasks(radius, dpr);
+    const int right = (size.width() - radius);
+    const int bottom = (size.height() - radius);
+    painter->save();
+    painter->setCompositionMode(QPainter::CompositionMode_DestinationOut);
+    painter->drawImage(QPoint(0, 0), masks.at(int(Corner::TopLeft)));
+    painter->drawImage(QPoint(right, 0), masks.at(int(Corner::TopRight)));
+    painter->drawImage(QPoint(0, bottom), masks.at(int(Corner::BottomLeft)));
+    painter->drawImage(QPoint(right, bottom), masks.at(int(Corner::BottomRight)));
+    painter->restore();
+}
+
+QRegion RoundedCorners::shapeRegion(const QSize &size, const int radius)
+{
+    if (size.isEmpty()) {
+        return {};
+    }
+    const int width = size.width();
+    const int height = size.height();
+    const int r = std::min(radius, (std::min(width, height) / 2));
+    if (r <= 0) {
+        return QRegion(0, 0, width, height);
+    }
+    QRegion region(0, r, width, (height - (r * 2)));
+    for (int y = 0; y != r; ++y) {
+        // Horizontal inset of the arc at the center of this scan line.
+        const qreal dy = (qreal(r) - qreal(y) - qreal(0.5));
+        const int inset = qRound(qreal(r) - std::sqrt(qreal(r * r) - (dy * dy)));
+        region += QRect(inset, y, (width - (inset * 2)), 1);
+        region += QRect(inset, (height - y - 1), (width - (inset * 2)), 1);
+    }
+    return region;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/roundedcorners_p.h"
@@ -26,6 +26,7 @@
 #include "framelesshelpercore_global_p.h"
 #include "framelessmanager_p.h"
 #include "framelessmanager.h"
+#include "hittestengine_p.h"
 #ifdef Q_OS_WINDOWS
 #  include "winverhelper_p.h"
 #endif // Q_OS_WINDOWS
@@ -105,71 +106,24 @@ static constexpr const std::array<FONT_ICON, static_cast<int>(SystemButtonType::
 
 Qt::CursorShape Utils::calculateCursorShape(const QWindow *window, const QPoint &pos)
 {
-#ifdef Q_OS_MACOS
-    Q_UNUSED(window);
-    Q_UNUSED(pos);
-    return Qt::ArrowCursor;
-#else
     Q_ASSERT(window);
     if (!window) {
         return Qt::ArrowCursor;
     }
-    if (window->visibility() != QWindow::Windowed) {
-        return Qt::ArrowCursor;
-    }
-    const int x = pos.x();
-    const int y = pos.y();
-    const int w = window->width();
-    const int h = window->height();
-    if (((x < kDefaultResizeBorderThickness) && (y < kDefaultResizeBorderThickness))
-        || ((x >= (w - kDefaultResizeBorderThickness)) && (y >= (h - kDefaultResizeBorderThickness)))) {
-        return Qt::SizeFDiagCursor;
-    }
-    if (((x >= (w - kDefaultResizeBorderThickness)) && (y < kDefaultResizeBorderThickness))
-        || ((x < kDefaultResizeBorderThickness) && (y >= (h - kDefaultResizeBorderThickness)))) {
-        return Qt::SizeBDiagCursor;
-    }
-    if ((x < kDefaultResizeBorderThickness) || (x >= (w - kDefaultResizeBorderThickness))) {
-        return Qt::SizeHorCursor;
-    }
-    if ((y < kDefaultResizeBorderThickness) || (y >= (h - kDefaultResizeBorderThickness))) {
-        return Qt::SizeVerCursor;
-    }
-    return Qt::ArrowCursor;
-#endif
+    HitTestEngine engine = {};
+    std::ignore = engine.setGeometry(window);
+    return engine.cursorShapeAt(pos);
 }
 
 Qt::Edges Utils::calculateWindowEdges(const QWindow *window, const QPoint &pos)
 {
-#ifdef Q_OS_MACOS
-    Q_UNUSED(window);
-    Q_UNUSED(pos);
-    return {};
-#else
     Q_ASSERT(window);
     if (!window) {
         return {};
     }
-    if (window->visibility() != QWindow::Windowed) {
-        return {};
-    }
-    Qt::Edges edges = {};
-    const int x = pos.x();
-    const int y = pos.y();
-    if (x < kDefaultResizeBorderThickness) {
-        edges |= Qt::LeftEdge;
-    }
-    if (x >= (window->width() - kDefaultResizeBorderThickness)) {
-        edges |= Qt::RightEdge;
-    }
-    if (y < kDefaultResizeBorderThickness) {
-        edges |= Qt::TopEdge;
-    }
-    if (y >= (window->height() - kDefaultResizeBorderThickness)) {
-        edges |= Qt::BottomEdge;
-    }
-    return edges;
-#endif
+    HitTestEngine engine = {};
+    std::ignore = engine.setGeometry(window);
+    return engine.edgesAt(pos);
 }
 
 QString Utils::getSystemButtonGlyph(const SystemButtonType button)
@@ -665,4 +619,23 @@ QColor Utils::calculateForegroundColor(const QColor &backgroundColor)
     return kDefaultBlackColor;
 }
 
+bool Utils::shouldApplyFramelessWindowHint()
+{
+#if FRAMELESSHELPER_CONFIG(native_impl)
+    // The native implementations remove the system frame by themselves.
+    return false;
+#else // !FRAMELESSHELPER_CONFIG(native_impl)
+    static const bool result = []() -> bool {
+#  ifdef Q_OS_MACOS
+        return false;
+#  elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+        return !isCustomDecorationSupported();
+#  else
+        return true;
+#  endif // Q_OS_MACOS
+    }();
+    return result;
+#endif // FRAMELESSHELPER_CONFIG(native_impl)
+}
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -29,12 +29,16 @@
 #include "framelessconfig_p.h"
 #include "framelessmanager.h"
 #include "framelessmanager_p.h"
+#include "sysapiloader_p.h"
 #include <cstring> // for std::memcpy
+#include <array>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qvarlengtharray.h>
 #include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
 #include <QtGui/qscreen.h>
 #include <QtGui/qpalette.h>
+#include <QtGui/qregion.h>
 #include <QtGui/qguiapplication.h>
 #if FRAMELESSHELPER_CONFIG(private_qt)
 #  include <QtGui/qpa/qplatformnativeinterface.h>
@@ -83,6 +87,33 @@ FRAMELESSHELPER_BYTEARRAY_CONSTANT(gettimestamp)
 FRAMELESSHELPER_BYTEARRAY_CONSTANT(startupid)
 FRAMELESSHELPER_BYTEARRAY_CONSTANT(display)
 FRAMELESSHELPER_BYTEARRAY_CONSTANT(connection)
+FRAMELESSHELPER_BYTEARRAY_CONSTANT(compositingenabled)
+
+// The X Shape extension lives in its own library, which is not a dependency of Qt Gui,
+// so we always load it at runtime, by its versioned soname since the unversioned symlink
+// only exists when the development package is installed. We don't declare the real
+// function prototypes here to avoid clashing with the symbols the Qt XCB QPA plugin
+// links against.
+FRAMELESSHELPER_STRING_CONSTANT2(libxcb_shape, "libxcb-shape.so.0")
+FRAMELESSHELPER_STRING_CONSTANT(xcb_shape_rectangles)
+FRAMELESSHELPER_STRING_CONSTANT(xcb_shape_mask)
+
+struct X11Rectangle
+{
+    int16_t x = 0;
+    int16_t y = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+};
+
+using xcb_shape_rectangles_t = xcb_void_cookie_t(*)(xcb_connection_t *, uint8_t, uint8_t, uint8_t,
+    xcb_window_t, int16_t, int16_t, uint32_t, const X11Rectangle *);
+using xcb_shape_mask_t = xcb_void_cookie_t(*)(xcb_connection_t *, uint8_t, uint8_t,
+    xcb_window_t, int16_t, int16_t, uint32_t);
+
+static constexpr const uint8_t kShapeOperationSet = 0; // XCB_SHAPE_SO_SET
+static constexpr const uint8_t kShapeKindInput = 2; // XCB_SHAPE_SK_INPUT
+static constexpr const uint8_t kClipOrderingYXBanded = 3; // XCB_CLIP_ORDERING_YX_BANDED
 
 static constexpr const auto _XCB_SEND_EVENT_MASK =
     (XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT | XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY);
@@ -143,6 +174,12 @@ extern QString gtkSettings(const gchar *);
     QGuiApplication::postEvent(window, event);
 }
 
+[[maybe_unused]] [[nodiscard]] static inline bool isMoveResizeSupportedByWindowManager()
+{
+    static const xcb_atom_t atom = Utils::internAtom(ATOM_NET_WM_MOVERESIZE);
+    return ((atom != XCB_NONE) && Utils::isSupportedByWindowManager(atom));
+}
+
 QScreen *Utils::x11_findScreenForVirtualDesktop(const int virtualDesktopNumber)
 {
 #if FRAMELESSHELPER_CONFIG(private_qt)
@@ -367,6 +404,32 @@ xcb_connection_t *Utils::x11_connection()
 #endif // FRAMELESSHELPER_HAS_X11EXTRAS
 }
 
+bool Utils::x11_isCompositingManagerRunning()
+{
+#ifdef FRAMELESSHELPER_HAS_X11EXTRAS
+    return QX11Info::isCompositingManagerRunning();
+#else // !FRAMELESSHELPER_HAS_X11EXTRAS
+#  if FRAMELESSHELPER_CONFIG(private_qt)
+    if (!qApp) {
+        return false;
+    }
+    QPlatformNativeInterface *native = qApp->platformNativeInterface();
+    if (!native) {
+        return false;
+    }
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (!screen) {
+        return false;
+    }
+    // The xcb QPA returns a non-null pointer if the compositing manager is active.
+    return (native->nativeResourceForScreen(kcompositingenabled, screen) != nullptr);
+#  else // !FRAMELESSHELPER_CONFIG(private_qt)
+    // Assume the worst case, the caller will fall back to the window shape.
+    return false;
+#  endif // FRAMELESSHELPER_CONFIG(private_qt)
+#endif // FRAMELESSHELPER_HAS_X11EXTRAS
+}
+
 bool Utils::startSystemMove(QWindow *window, const QPoint &globalPos)
 {
     Q_ASSERT(window);
@@ -374,10 +437,17 @@ bool Utils::startSystemMove(QWindow *window, const QPoint &globalPos)
         return false;
     }
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-    window->startSystemMove();
+    // Let the caller fall back to its own implementation if neither the QPA
+    // nor the window manager can do this for us.
+    if (!window->startSystemMove()) {
+        return false;
+    }
     generateMouseReleaseEvent(window, globalPos);
     return true;
 #else // (QT_VERSION < QT_VERSION_CHECK(5, 15, 0))
+    if (!isMoveResizeSupportedByWindowManager()) {
+        return false;
+    }
     const QPoint nativeGlobalPos = Utils::toNativeGlobalPosition(window, globalPos);
     sendMoveResizeMessage(window->winId(), _NET_WM_MOVERESIZE_MOVE, nativeGlobalPos);
     return true;
@@ -394,10 +464,15 @@ bool Utils::startSystemResize(QWindow *window, const Qt::Edges edges, const QPoi
         return false;
     }
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
-    window->startSystemResize(edges);
+    if (!window->startSystemResize(edges)) {
+        return false;
+    }
     generateMouseReleaseEvent(window, globalPos);
     return true;
 #else // (QT_VERSION < QT_VERSION_CHECK(5, 15, 0))
+    if (!isMoveResizeSupportedByWindowManager()) {
+        return false;
+    }
     const QPoint nativeGlobalPos = Utils::toNativeGlobalPosition(window, globalPos);
     const int netWmOperation = qtEdgesToWmMoveOrResizeOperation(edges);
     sendMoveResizeMessage(window->winId(), netWmOperation, nativeGlobalPos);
@@ -951,6 +1026,59 @@ void Utils::sendMoveResizeMessage(const WId windowId, const uint32_t action, con
     xcb_flush(connection);
 }
 
+void Utils::setFrameExtents(const WId windowId, const QMargins &extents)
+{
+    Q_ASSERT(windowId);
+    if (!windowId) {
+        return;
+    }
+    static const xcb_atom_t atom = internAtom(ATOM_GTK_FRAME_EXTENTS);
+    if (atom == XCB_NONE) {
+        return;
+    }
+    if (extents.isNull()) {
+        clearWindowProperty(windowId, atom);
+        return;
+    }
+    // The order is left, right, top, bottom.
+    const std::array<quint32, 4> value = { quint32(extents.left()), quint32(extents.right()),
+        quint32(extents.top()), quint32(extents.bottom()) };
+    setWindowProperty(windowId, atom, XCB_ATOM_CARDINAL, value.data(), quint32(value.size()), sizeof(quint32) * 8);
+}
+
+void Utils::setWindowInputShape(const WId windowId, const QRegion &region)
+{
+    Q_ASSERT(windowId);
+    if (!windowId) {
+        return;
+    }
+    if (!API_AVAILABLE(libxcb_shape, xcb_shape_rectangles) || !API_AVAILABLE(libxcb_shape, xcb_shape_mask)) {
+        return;
+    }
+    xcb_connection_t * const connection = Utils::x11_connection();
+    Q_ASSERT(connection);
+    if (!connection) {
+        return;
+    }
+    if (region.isEmpty()) {
+        // Setting the mask to none restores the default shape (the whole window).
+        API_CALL_FUNCTION2(libxcb_shape, xcb_shape_mask, xcb_shape_mask_t, connection,
+            kShapeOperationSet, kShapeKindInput, windowId, 0, 0, XCB_NONE);
+    } else {
+        // QRegion stores its rectangles y-x banded already, which lets the X server
+        // skip sorting them. The whole region goes out in a single request.
+        QVarLengthArray<X11Rectangle, 16> rects = {};
+        rects.reserve(region.rectCount());
+        for (auto &&rect : region) {
+            rects.append(X11Rectangle{ int16_t(rect.x()), int16_t(rect.y()),
+                uint16_t(rect.width()), uint16_t(rect.height()) });
+        }
+        API_CALL_FUNCTION2(libxcb_shape, xcb_shape_rectangles, xcb_shape_rectangles_t, connection,
+            kShapeOperationSet, kShapeKindInput, kClipOrderingYXBanded, windowId, 0, 0, uint32_t(rects.size()), rects.constData());
+    }
+    xcb_flush(connection);
+}
+
 bool Utils::isCustomDecorationSupported()
 {
     static const xcb_atom_t atom = internAtom(ATOM_DEEPIN_NO_TITLEBAR);
@@ -29,6 +29,8 @@
 
 #include "utils.h"
 #include "framelessmanager.h"
+#include "framelessmanager_p.h"
+#include "roundedcorners_p.h"
 #ifdef Q_OS_WINDOWS
 #  include "winverhelper_p.h"
 #endif
@@ -86,11 +88,14 @@ const WindowBorderPainterPrivate *WindowBorderPainterPrivate::get(const WindowBo
 WindowBorderPainter::WindowBorderPainter(QObject *parent)
     : QObject(parent), d_ptr(std::make_unique<WindowBorderPainterPrivate>(this))
 {
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged, this, &WindowBorderPainter::nativeBorderChanged);
+    FramelessManagerPrivate::addThemeSubscriber(this, [this](){ Q_EMIT nativeBorderChanged(); });
     connect(this, &WindowBorderPainter::nativeBorderChanged, this, &WindowBorderPainter::shouldRepaint);
 }
 
-WindowBorderPainter::~WindowBorderPainter() = default;
+WindowBorderPainter::~WindowBorderPainter()
+{
+    FramelessManagerPrivate::removeThemeSubscriber(this);
+}
 
 int WindowBorderPainter::thickness() const
 {
@@ -123,7 +128,8 @@ int WindowBorderPainter::nativeThickness() const
     // based on the current system DPI and scale factor rounding policy.
     return kDefaultWindowFrameBorderThickness;
 #else
-    return 0;
+    // Rounded windows need an outline, otherwise the curve can hardly be seen.
+    return (RoundedCorners::isEnabled() ? kDefaultWindowFrameBorderThickness : 0);
 #endif
 }
 
@@ -134,6 +140,9 @@ WindowEdges WindowBorderPainter::nativeEdges() const
         return { WindowEdge::Top };
     }
 #endif
+    if (RoundedCorners::isEnabled()) {
+        return (WindowEdge::Left | WindowEdge::Top | WindowEdge::Right | WindowEdge::Bottom);
+    }
     return {};
 }
 
@@ -166,6 +175,9 @@ void WindowBorderPainter::paint(QPainter *painter, const QSize &size, const bool
     const auto rightBottom = QPointF{ rightTop.x(), qreal(size.height()) - gap };
     const auto leftBottom = QPointF{ leftTop.x(), rightBottom.y() };
     const WindowEdges edges = d->edges.value_or(nativeEdges());
+    static const WindowEdges allEdges = (WindowEdge::Left | WindowEdge::Top | WindowEdge::Right | WindowEdge::Bottom);
+    // Follow the window corner curve if all edges are visible.
+    const int radius = ((edges == allEdges) ? RoundedCorners::radius() : 0);
     if (edges & WindowEdge::Left) {
         lines.append({leftBottom, leftTop});
     }
@@ -198,7 +210,13 @@ void WindowBorderPainter::paint(QPainter *painter, const QSize &size, const bool
     }());
     pen.setWidth(d->thickness.value_or(nativeThickness()));
     painter->setPen(pen);
-    painter->drawLines(lines);
+    if (radius > 0) {
+        painter->setBrush(Qt::NoBrush);
+        const qreal r = (qreal(radius) - gap);
+        painter->drawRoundedRect(QRectF(leftTop, rightBottom), r, r);
+    } else {
+        painter->drawLines(lines);
+    }
     painter->restore();
 }
 
@@ -0,0 +1,286 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "windowshadow_p.h"
+#include "framelessconfig_p.h"
+#include "roundedcorners_p.h"
+#include "utils.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qpainter.h>
+#include <algorithm>
+#include <vector>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+using namespace Global;
+
+static constexpr const int kActiveShadowAlpha = 90;
+static constexpr const int kInactiveShadowAlpha = 45;
+// Two activation states on a few screens with different scale factors. The windows
+// which still hold an evicted texture keep it alive on their own.
+static constexpr const int kMaximumTextureCacheSize = 8;
+
+// The texture layout, all in image pixels:
+// [blur][corner][blur] [1] [blur][corner][blur]
+// The shape edge sits one blur radius inside the texture edge, and the blur reaches one
+// more blur radius into the shape, so every pixel further than that from both shape
+// corners has the same value along the edge, which is what makes the 1px middle slice
+// stretchable.
+struct TextureMetrics
+{
+    int blur = 0;
+    int corner = 0;
+    int slice = 0;
+    int side = 0;
+};
+
+[[nodiscard]] static inline TextureMetrics textureMetrics(const WindowShadow::Parameters &params)
+{
+    TextureMetrics metrics = {};
+    metrics.blur = std::max(0, qCeil(qreal(params.blurRadius) * params.devicePixelRatio));
+    metrics.corner = std::max(1, qCeil(qreal(params.cornerRadius) * params.devicePixelRatio));
+    metrics.slice = ((metrics.blur * 2) + metrics.corner);
+    metrics.side = ((metrics.slice * 2) + 1);
+    return metrics;
+}
+
+struct TextureCacheEntry
+{
+    QImage image = {};
+    // Bumped on every lookup, the smallest one is evicted first.
+    quint64 lastUse = 0;
+};
+
+// Shared by the GUI thread (Qt Widgets) and the render threads (Qt Quick).
+struct TextureCache
+{
+    QMutex mutex{};
+    QHash<quint64, TextureCacheEntry> entries = {};
+    quint64 useCounter = 0;
+};
+
+Q_GLOBAL_STATIC(TextureCache, g_textureCache)
+
+[[nodiscard]] static inline quint64 textureKey(const WindowShadow::Parameters &params)
+{
+    const auto blur = quint64(std::clamp(params.blurRadius, 0, 255));
+    const auto corner = quint64(std::clamp(params.cornerRadius, 0, 255));
+    const auto dpr = quint64(quint16(qRound(params.devicePixelRatio * qreal(100))));
+    return ((blur << 56) | (corner << 48) | (dpr << 32) | quint64(params.color.rgba()));
+}
+
+// One box blur pass over a single line, "stride" is the distance between two neighbouring
+// pixels of the line so the same function handles both the rows and the columns.
+static inline void boxBlurLine(const quint8 *src, quint8 *dst, const int length, const int stride, const int radius)
+{
+    const int window = ((radius * 2) + 1);
+    int sum = 0;
+    for (int i = 0; (i <= radius) && (i < length); ++i) {
+        sum += src[i * stride];
+    }
+    for (int i = 0; i != length; ++i) {
+        dst[i * stride] = quint8(sum / window);
+        const int incoming = (i + radius + 1);
+        const int outgoing = (i - radius);
+        if (incoming < length) {
+            sum += src[incoming * stride];
+        }
+        if (outgoing >= 0) {
+            sum -= src[outgoing * stride];
+        }
+    }
+}
+
+// Three box blur passes in each direction are a close enough approximation of a
+// gaussian blur, and much cheaper than a real one.
+static inline void blurAlpha(std::vector<quint8> &alpha, const int side, const int blurRadius)
+{
+    const int radius = std::max(1, (blurRadius / 3));
+    std::vector<quint8> buffer(alpha.size());
+    for (int pass = 0; pass != 3; ++pass) {
+        for (int y = 0; y != side; ++y) {
+            boxBlurLine(alpha.data() + (y * side), buffer.data() + (y * side), side, 1, radius);
+        }
+        for (int x = 0; x != side; ++x) {
+            boxBlurLine(buffer.data() + x, alpha.data() + x, side, side, radius);
+        }
+    }
+}
+
+[[nodiscard]] static inline QImage createTexture(const WindowShadow::Parameters &params)
+{
+    const TextureMetrics metrics = textureMetrics(params);
+    QImage image(metrics.side, metrics.side, QImage::Format_ARGB32_Premultiplied);
+    image.fill(kDefaultTransparentColor);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(kDefaultBlackColor);
+        const qreal corner = qreal(metrics.corner);
+        const qreal shapeSize = qreal(metrics.side - (metrics.blur * 2));
+        painter.drawRoundedRect(QRectF(metrics.blur, metrics.blur, shapeSize, shapeSize), corner, corner);
+    }
+    const auto pixelCount = std::size_t(metrics.side * metrics.side);
+    std::vector<quint8> alpha(pixelCount);
+    for (int y = 0; y != metrics.side; ++y) {
+        const auto line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = 0; x != metrics.side; ++x) {
+            alpha.at((y * metrics.side) + x) = quint8(qAlpha(line[x]));
+        }
+    }
+    if (metrics.blur > 0) {
+        blurAlpha(alpha, metrics.side, metrics.blur);
+    }
+    const QColor &color = params.color;
+    for (int y = 0; y != metrics.side; ++y) {
+        const auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x != metrics.side; ++x) {
+            const int a = ((int(alpha.at((y * metrics.side) + x)) * color.alpha()) / 255);
+            line[x] = qRgba(((color.red() * a) / 255), ((color.green() * a) / 255), ((color.blue() * a) / 255), a);
+        }
+    }
+    image.setDevicePixelRatio(params.devicePixelRatio);
+    return image;
+}
+
+bool WindowShadow::isEnabled()
+{
+#if ((defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)) && !FRAMELESSHELPER_CONFIG(native_impl))
+    // The margins must not change during the lifetime of the windows, so evaluate it only once.
+    static const bool result = (FramelessConfig::instance()->isSet(Option::EnableClientSideShadow)
+        && Utils::x11_isCompositingManagerRunning());
+    return result;
+#else
+    return false;
+#endif
+}
+
+WindowShadow::Parameters WindowShadow::defaultParameters(const bool active, const qreal devicePixelRatio)
+{
+    Parameters params = {};
+    // Keep the geometry the same for both states, only the color may change when the
+    // window activation changes, otherwise the window contents would jump around.
+    params.blurRadius = kDefaultWindowShadowBlurRadius;
+    params.offset = kDefaultWindowShadowOffset;
+    params.color = QColor(0, 0, 0, (active ? kActiveShadowAlpha : kInactiveShadowAlpha));
+    params.cornerRadius = RoundedCorners::radius();
+    params.devicePixelRatio = devicePixelRatio;
+    return params;
+}
+
+QMargins WindowShadow::margins(const Parameters &params)
+{
+    const int blur = params.blurRadius;
+    const int dx = params.offset.x();
+    const int dy = params.offset.y();
+    return QMargins(std::max(0, (blur - dx)), std::max(0, (blur - dy)), std::max(0, (blur + dx)), std::max(0, (blur + dy)));
+}
+
+QImage WindowShadow::texture(const Parameters &params)
+{
+    Q_ASSERT(params.devicePixelRatio > qreal(0));
+    if ((params.blurRadius <= 0) || (params.devicePixelRatio <= qreal(0)) || !params.color.isValid()) {
+        return {};
+    }
+    // A window painting its shadow during application exit.
+    if (g_textureCache.isDestroyed()) {
+        return createTexture(params);
+    }
+    const quint64 key = textureKey(params);
+    TextureCache &cache = *g_textureCache();
+    // Keep holding the lock while rendering, so that the same texture is never rendered twice.
+    const QMutexLocker locker(&cache.mutex);
+    const quint64 use = ++cache.useCounter;
+    const auto it = cache.entries.find(key);
+    if (it != cache.entries.end()) {
+        it->lastUse = use;
+        return it->image;
+    }
+    if (cache.entries.size() >= kMaximumTextureCacheSize) {
+        const auto oldest = std::min_element(cache.entries.begin(), cache.entries.end(),
+            [](const TextureCacheEntry &lhs, const TextureCacheEntry &rhs){ return (lhs.lastUse < rhs.lastUse); });
+        cache.entries.erase(oldest);
+    }
+    const QImage image = createTexture(params);
+    cache.entries.insert(key, { image, use });
+    return image;
+}
+
+WindowShadow::Slices WindowShadow::slices(const Parameters &params, const QSize &windowSize)
+{
+    if (windowSize.isEmpty() || (params.devicePixelRatio <= qreal(0))) {
+        return {};
+    }
+    const TextureMetrics metrics = textureMetrics(params);
+    const qreal dpr = params.devicePixelRatio;
+    const QMargins contentMargins = margins(params);
+    const QRectF content = QRectF(QPointF(0, 0), QSizeF(windowSize)).marginsRemoved(QMarginsF(contentMargins));
+    const qreal blur = (qreal(metrics.blur) / dpr);
+    const QRectF outer = content.translated(params.offset).adjusted(-blur, -blur, blur, blur);
+    const qreal slice = std::min((qreal(metrics.slice) / dpr), (std::min(outer.width(), outer.height()) / qreal(2)));
+    const qreal middleWidth = std::max(qreal(0), (outer.width() - (slice * 2)));
+    const qreal middleHeight = std::max(qreal(0), (outer.height() - (slice * 2)));
+    const int s = metrics.slice;
+    const qreal left = outer.left();
+    const qreal top = outer.top();
+    const qreal right = (left + slice + middleWidth);
+    const qreal bottom = (top + slice + middleHeight);
+    Slices result = {};
+    result.at(int(Slice::TopLeft)) = { QRect(0, 0, s, s), QRectF(left, top, slice, slice) };
+    result.at(int(Slice::Top)) = { QRect(s, 0, 1, s), QRectF((left + slice), top, middleWidth, slice) };
+    result.at(int(Slice::TopRight)) = { QRect((s + 1), 0, s, s), QRectF(right, top, slice, slice) };
+    result.at(int(Slice::Left)) = { QRect(0, s, s, 1), QRectF(left, (top + slice), slice, middleHeight) };
+    result.at(int(Slice::Right)) = { QRect((s + 1), s, s, 1), QRectF(right, (top + slice), slice, middleHeight) };
+    result.at(int(Slice::BottomLeft)) = { QRect(0, (s + 1), s, s), QRectF(left, bottom, slice, slice) };
+    result.at(int(Slice::Bottom)) = { QRect(s, (s + 1), 1, s), QRectF((left + slice), bottom, middleWidth, slice) };
+    result.at(int(Slice::BottomRight)) = { QRect((s + 1), (s + 1), s, s), QRectF(right, bottom, slice, slice) };
+    return result;
+}
+
+void WindowShadow::paint(QPainter *painter, const QSize &windowSize, const Parameters &params)
+{
+    Q_ASSERT(painter);
+    if (!painter || windowSize.isEmpty()) {
+        return;
+    }
+    const QImage image = texture(params);
+    if (image.isNull()) {
+        return;
+    }
+    painter->save();
+    // The middle slices are 1px wide, stretching them must not sample the neighbours.
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    for (auto &&slice : slices(params, windowSize)) {
+        if (slice.target.isEmpty()) {
+            continue;
+        }
+        painter->drawImage(slice.target, image, slice.source);
+    }
+    painter->restore();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
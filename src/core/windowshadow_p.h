@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/windowshadow_p.h"
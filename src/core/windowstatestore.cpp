@@ -0,0 +1,613 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "windowstatestore.h"
+#include "windowstatestore_p.h"
+#include "framelessmanager_p.h"
+#include "framelesshelpercore_global_p.h"
+#include "backgroundexecutor_p.h"
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtGui/qscreen.h>
+#include <QtGui/qguiapplication.h>
+#include <algorithm>
+#include <utility>
+#include <tuple>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcWindowStateStore, "wangwenx190.framelesshelper.core.windowstatestore")
+#  define INFO qCInfo(lcWindowStateStore)
+#  define DEBUG qCDebug(lcWindowStateStore)
+#  define WARNING qCWarning(lcWindowStateStore)
+#  define CRITICAL qCCritical(lcWindowStateStore)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+[[maybe_unused]] static constexpr const int kDefaultSaveDelay = 500; // ms
+[[maybe_unused]] static constexpr const quint32 kFileMagic = 0x46485753; // "FHWS"
+[[maybe_unused]] static constexpr const quint16 kFileVersion = 1;
+[[maybe_unused]] static constexpr const QDataStream::Version kStreamVersion = QDataStream::Qt_5_6;
+
+struct WindowStateWriter
+{
+    QMutex mutex{};
+    QString filePath = {};
+    QByteArray data = {};
+    bool pending = false;
+    bool scheduled = false;
+
+    // Held from taking the pending data until it's on the disk, so a flush either takes
+    // the data itself or waits for the write in progress. Always locked before "mutex".
+    QMutex fileMutex{};
+};
+
+[[nodiscard]] static inline Qt::WindowState sanitizeWindowState(const Qt::WindowState state)
+{
+    // Restoring a window to the minimized state is never what the user wants.
+    if ((state == Qt::WindowMaximized) || (state == Qt::WindowFullScreen)) {
+        return state;
+    }
+    return Qt::WindowNoState;
+}
+
+[[nodiscard]] static inline bool isSameRecord(const WindowStateRecord &lhs, const WindowStateRecord &rhs)
+{
+    return ((lhs.normalGeometry == rhs.normalGeometry) && (lhs.state == rhs.state)
+        && (lhs.screenName == rhs.screenName) && (lhs.screenGeometry == rhs.screenGeometry));
+}
+
+[[nodiscard]] static inline bool writeFile(const QString &filePath, const QByteArray &data)
+{
+    Q_ASSERT(!filePath.isEmpty());
+    if (filePath.isEmpty()) {
+        return false;
+    }
+    const QString dirPath = QFileInfo(filePath).absolutePath();
+    if (!QDir().mkpath(dirPath)) {
+        WARNING << "Failed to create the directory" << dirPath;
+        return false;
+    }
+    // Never leave a truncated file behind, the old one is kept until the new one is complete.
+    QSaveFile file(filePath);
+    if (!file.open(QSaveFile::WriteOnly)) {
+        WARNING << "Failed to open" << filePath << ':' << file.errorString();
+        return false;
+    }
+    if (file.write(data) != data.size()) {
+        WARNING << "Failed to write" << filePath << ':' << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        WARNING << "Failed to commit" << filePath << ':' << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Returns false if there was nothing left to write.
+[[nodiscard]] static inline bool writePending(const WindowStateWriterPtr &writer, const bool fromTask)
+{
+    Q_ASSERT(writer);
+    if (!writer) {
+        return false;
+    }
+    const QMutexLocker fileLocker(&writer->fileMutex);
+    QString filePath = {};
+    QByteArray data = {};
+    {
+        const QMutexLocker locker(&writer->mutex);
+        if (!writer->pending) {
+            if (fromTask) {
+                writer->scheduled = false;
+            }
+            return false;
+        }
+        filePath = writer->filePath;
+        data = std::exchange(writer->data, {});
+        writer->pending = false;
+    }
+    std::ignore = writeFile(filePath, data);
+    return true;
+}
+
+static inline void postWrite(const WindowStateWriterPtr &writer, const QString &filePath, const QByteArray &data)
+{
+    Q_ASSERT(writer);
+    if (!writer) {
+        return;
+    }
+    {
+        const QMutexLocker locker(&writer->mutex);
+        writer->filePath = filePath;
+        writer->data = data;
+        writer->pending = true;
+        // The running task will pick the new data up, only the latest snapshot matters.
+        if (writer->scheduled) {
+            return;
+        }
+        writer->scheduled = true;
+    }
+    BackgroundExecutor::post([writer](){
+        while (writePending(writer, true)) {}
+    });
+}
+
+static inline void flushWriter(const WindowStateWriterPtr &writer)
+{
+    Q_ASSERT(writer);
+    if (!writer) {
+        return;
+    }
+    // Blocks until the write in progress, if any, is done. Then writes whatever the
+    // background task hasn't picked up yet.
+    std::ignore = writePending(writer, false);
+}
+
+WindowStateStorePrivate::WindowStateStorePrivate(WindowStateStore *q) : QObject(q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return;
+    }
+    q_ptr = q;
+    filePath = defaultFilePath();
+    writer = std::make_shared<WindowStateWriter>();
+    saveTimer.setSingleShot(true);
+    saveTimer.setInterval(kDefaultSaveDelay);
+    connect(&saveTimer, &QTimer::timeout, this, &WindowStateStorePrivate::save);
+    if (const QCoreApplication * const app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, &WindowStateStorePrivate::flush);
+    }
+}
+
+WindowStateStorePrivate::~WindowStateStorePrivate()
+{
+    flush();
+}
+
+WindowStateStorePrivate *WindowStateStorePrivate::get(WindowStateStore *q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return nullptr;
+    }
+    return q->d_func();
+}
+
+const WindowStateStorePrivate *WindowStateStorePrivate::get(const WindowStateStore *q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return nullptr;
+    }
+    return q->d_func();
+}
+
+QString WindowStateStorePrivate::defaultFilePath()
+{
+    const QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    if (dirPath.isEmpty()) {
+        return QDir(QCoreApplication::applicationDirPath()).filePath(FRAMELESSHELPER_STRING_LITERAL(".framelesshelper.windowstate"));
+    }
+    return QDir(dirPath).filePath(FRAMELESSHELPER_STRING_LITERAL("framelesshelper.windowstate"));
+}
+
+QByteArray WindowStateStorePrivate::serialize(const WindowStateRecords &records)
+{
+    QByteArray data = {};
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(kStreamVersion);
+    stream << kFileMagic << kFileVersion << quint32(records.size());
+    for (auto it = records.cbegin(); it != records.cend(); ++it) {
+        const WindowStateRecord &record = it.value();
+        stream << it.key() << record.normalGeometry << quint8(record.state)
+               << record.screenName << record.screenGeometry;
+    }
+    return data;
+}
+
+std::optional<WindowStateRecords> WindowStateStorePrivate::deserialize(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return std::nullopt;
+    }
+    QDataStream stream(data);
+    stream.setVersion(kStreamVersion);
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if ((stream.status() != QDataStream::Ok) || (magic != kFileMagic) || (version != kFileVersion)) {
+        return std::nullopt;
+    }
+    WindowStateRecords records = {};
+    for (quint32 index = 0; index != count; ++index) {
+        QString id = {};
+        WindowStateRecord record = {};
+        quint8 state = 0;
+        stream >> id >> record.normalGeometry >> state >> record.screenName >> record.screenGeometry;
+        if (stream.status() != QDataStream::Ok) {
+            return std::nullopt;
+        }
+        record.state = sanitizeWindowState(static_cast<Qt::WindowState>(state));
+        records.insert(id, record);
+    }
+    return records;
+}
+
+QRect WindowStateStorePrivate::validateGeometry(const WindowStateRecord &record)
+{
+    if (!record.normalGeometry.isValid()) {
+        return {};
+    }
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    if (screens.isEmpty()) {
+        return {};
+    }
+    QRect geometry = record.normalGeometry;
+    QScreen *screen = nullptr;
+    if (!record.screenName.isEmpty()) {
+        // Several monitors of the same model may share one name, prefer the one which hasn't moved.
+        for (auto &&scr : screens) {
+            if (scr->name() != record.screenName) {
+                continue;
+            }
+            if (!screen || (scr->geometry() == record.screenGeometry)) {
+                screen = scr;
+            }
+        }
+    }
+    if (screen) {
+        // The screens may have been re-arranged, keep the window at the same place of its screen.
+        geometry.translate(screen->geometry().topLeft() - record.screenGeometry.topLeft());
+    } else {
+        for (auto &&scr : screens) {
+            if (scr->geometry().contains(geometry.center())) {
+                screen = scr;
+                break;
+            }
+        }
+        if (!screen) {
+            screen = QGuiApplication::primaryScreen();
+        }
+    }
+    Q_ASSERT(screen);
+    if (!screen) {
+        return {};
+    }
+    // Keep the whole window, and its title bar in particular, reachable.
+    const QRect available = screen->availableGeometry();
+    geometry.setSize(geometry.size().boundedTo(available.size()));
+    geometry.moveLeft(std::clamp(geometry.left(), available.left(), available.right() - geometry.width() + 1));
+    geometry.moveTop(std::clamp(geometry.top(), available.top(), available.bottom() - geometry.height() + 1));
+    return geometry;
+}
+
+void WindowStateStorePrivate::load()
+{
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    records.clear();
+    QFile file(filePath);
+    if (!file.exists()) {
+        return;
+    }
+    if (!file.open(QFile::ReadOnly)) {
+        WARNING << "Failed to open" << filePath << ':' << file.errorString();
+        return;
+    }
+    std::optional<WindowStateRecords> result = deserialize(file.readAll());
+    if (!result.has_value()) {
+        WARNING << filePath << "is corrupted or written by an incompatible version, ignoring it.";
+        return;
+    }
+    records = std::move(result.value());
+}
+
+void WindowStateStorePrivate::capture(const QObject *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    const QString id = trackedWindows.value(window);
+    if (id.isEmpty()) {
+        return;
+    }
+    const FramelessDataPtr data = FramelessManagerPrivate::getData(window);
+    if (!data || !data->callbacks) {
+        return;
+    }
+    const Qt::WindowState state = data->callbacks->getWindowState();
+    if (state == Qt::WindowMinimized) {
+        return;
+    }
+    load();
+    const WindowStateRecord oldRecord = records.value(id);
+    WindowStateRecord newRecord = oldRecord;
+    if (state == Qt::WindowNoState) {
+        newRecord.normalGeometry = QRect{ data->callbacks->getWindowPosition(), data->callbacks->getWindowSize() };
+    }
+    newRecord.state = sanitizeWindowState(state);
+    if (const QScreen * const screen = data->callbacks->getWindowScreen()) {
+        newRecord.screenName = screen->name();
+        newRecord.screenGeometry = screen->geometry();
+    }
+    if (records.contains(id) && isSameRecord(oldRecord, newRecord)) {
+        return;
+    }
+    records.insert(id, newRecord);
+    dirty = true;
+}
+
+void WindowStateStorePrivate::scheduleCapture(const QObject *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    changedWindows.insert(window);
+    // Restarted by every change, nothing happens until the user stops moving or resizing.
+    saveTimer.start();
+}
+
+void WindowStateStorePrivate::captureChangedWindows()
+{
+    // The window state settles down only after the geometry changes, reading everything
+    // at once avoids recording the maximized geometry as the normal one.
+    const QSet<const QObject *> windows = std::exchange(changedWindows, {});
+    for (auto &&window : std::as_const(windows)) {
+        capture(window);
+    }
+}
+
+void WindowStateStorePrivate::save()
+{
+    captureChangedWindows();
+    if (!dirty) {
+        return;
+    }
+    dirty = false;
+    postWrite(writer, filePath, serialize(records));
+}
+
+void WindowStateStorePrivate::flush()
+{
+    saveTimer.stop();
+    save();
+    flushWriter(writer);
+}
+
+void WindowStateStorePrivate::untrack(const QObject *window, const bool destroyed)
+{
+    Q_ASSERT(window);
+    if (!window || !trackedWindows.contains(window)) {
+        return;
+    }
+    if (destroyed) {
+        changedWindows.remove(window);
+    } else {
+        capture(window);
+        changedWindows.remove(window);
+        const auto object = const_cast<QObject *>(window);
+        object->removeEventFilter(this);
+        disconnect(object, &QObject::destroyed, this, nullptr);
+    }
+    trackedWindows.remove(window);
+}
+
+bool WindowStateStorePrivate::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if (!object || !event || !trackedWindows.contains(object)) {
+        return QObject::eventFilter(object, event);
+    }
+    switch (event->type()) {
+    case QEvent::Move:
+    case QEvent::Resize:
+    case QEvent::WindowStateChange:
+    case QEvent::ScreenChangeInternal:
+        scheduleCapture(object);
+        break;
+    case QEvent::Hide:
+        // The window may be destroyed right after being closed, don't lose its last state.
+        changedWindows.remove(object);
+        capture(object);
+        if (dirty) {
+            saveTimer.start();
+        }
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(object, event);
+}
+
+WindowStateStore::WindowStateStore(QObject *parent)
+    : QObject(parent), d_ptr(std::make_unique<WindowStateStorePrivate>(this))
+{
+}
+
+WindowStateStore::~WindowStateStore() = default;
+
+QString WindowStateStore::filePath() const
+{
+    Q_D(const WindowStateStore);
+    return d->filePath;
+}
+
+void WindowStateStore::setFilePath(const QString &value)
+{
+    Q_ASSERT(!value.isEmpty());
+    if (value.isEmpty()) {
+        return;
+    }
+    Q_D(WindowStateStore);
+    if (d->filePath == value) {
+        return;
+    }
+    // Everything known so far belongs to the old file.
+    d->flush();
+    d->filePath = value;
+    d->loaded = false;
+    d->records.clear();
+    for (auto it = d->trackedWindows.cbegin(); it != d->trackedWindows.cend(); ++it) {
+        d->scheduleCapture(it.key());
+    }
+    Q_EMIT filePathChanged();
+}
+
+int WindowStateStore::saveDelay() const
+{
+    Q_D(const WindowStateStore);
+    return d->saveTimer.interval();
+}
+
+void WindowStateStore::setSaveDelay(const int value)
+{
+    Q_ASSERT(value >= 0);
+    if (value < 0) {
+        return;
+    }
+    Q_D(WindowStateStore);
+    if (d->saveTimer.interval() == value) {
+        return;
+    }
+    d->saveTimer.setInterval(value);
+    Q_EMIT saveDelayChanged();
+}
+
+bool WindowStateStore::contains(const QString &id) const
+{
+    Q_ASSERT(!id.isEmpty());
+    if (id.isEmpty()) {
+        return false;
+    }
+    Q_D(const WindowStateStore);
+    const_cast<WindowStateStorePrivate *>(d)->load();
+    return d->records.contains(id);
+}
+
+bool WindowStateStore::restore(const QObject *window, const QString &id)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(!id.isEmpty());
+    if (!window || id.isEmpty()) {
+        return false;
+    }
+    const FramelessDataPtr data = FramelessManagerPrivate::getData(window);
+    if (!data || !data->callbacks) {
+        WARNING << window << "is not attached to any frameless helper yet.";
+        return false;
+    }
+    Q_D(WindowStateStore);
+    d->load();
+    const auto it = d->records.constFind(id);
+    if (it == d->records.constEnd()) {
+        return false;
+    }
+    const WindowStateRecord &record = it.value();
+    const QRect geometry = WindowStateStorePrivate::validateGeometry(record);
+    if (geometry.isValid()) {
+        data->callbacks->setWindowSize(geometry.size());
+        data->callbacks->setWindowPosition(geometry.topLeft());
+    }
+    if (record.state != Qt::WindowNoState) {
+        data->callbacks->setWindowState(record.state);
+    }
+    return true;
+}
+
+void WindowStateStore::track(const QObject *window, const QString &id)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(!id.isEmpty());
+    if (!window || id.isEmpty()) {
+        return;
+    }
+    Q_D(WindowStateStore);
+    if (d->trackedWindows.value(window) == id) {
+        return;
+    }
+    const bool tracked = d->trackedWindows.contains(window);
+    d->trackedWindows.insert(window, id);
+    if (!tracked) {
+        const auto object = const_cast<QObject *>(window);
+        object->installEventFilter(d);
+        connect(object, &QObject::destroyed, d, [d, window](){ d->untrack(window, true); });
+    }
+    d->scheduleCapture(window);
+}
+
+void WindowStateStore::untrack(const QObject *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    Q_D(WindowStateStore);
+    d->untrack(window, false);
+}
+
+void WindowStateStore::remove(const QString &id)
+{
+    Q_ASSERT(!id.isEmpty());
+    if (id.isEmpty()) {
+        return;
+    }
+    Q_D(WindowStateStore);
+    d->load();
+    if (!d->records.remove(id)) {
+        return;
+    }
+    d->dirty = true;
+    d->saveTimer.start();
+}
+
+void WindowStateStore::flush()
+{
+    Q_D(WindowStateStore);
+    d->flush();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/windowstatestore_p.h"
@@ -0,0 +1,225 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "x11windowstatemirror_p.h"
+
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+
+#include "framelessmanager_p.h"
+#include "framelesshelpercore_global_p.h"
+#include "framelesshelper_linux.h"
+#include "utils.h"
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qloggingcategory.h>
+#include <memory>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcX11WindowStateMirror, "wangwenx190.framelesshelper.core.x11windowstatemirror")
+#  define INFO qCInfo(lcX11WindowStateMirror)
+#  define DEBUG qCDebug(lcX11WindowStateMirror)
+#  define WARNING qCWarning(lcX11WindowStateMirror)
+#  define CRITICAL qCCritical(lcX11WindowStateMirror)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+// Large enough for all the states a window can be in.
+static constexpr const quint32 kMaximumWindowStateCount = 32;
+static constexpr const quint32 kFrameExtentsCount = 4;
+
+struct X11WindowStateMirrorInternal
+{
+    std::unique_ptr<X11WindowStateMirror> eventFilter = nullptr;
+};
+Q_GLOBAL_STATIC(X11WindowStateMirrorInternal, g_internalData)
+
+struct X11WindowStateAtoms
+{
+    xcb_atom_t state = XCB_NONE;
+    xcb_atom_t maximizedVertically = XCB_NONE;
+    xcb_atom_t maximizedHorizontally = XCB_NONE;
+    xcb_atom_t fullScreen = XCB_NONE;
+    xcb_atom_t hidden = XCB_NONE;
+    xcb_atom_t frameExtents = XCB_NONE;
+};
+
+[[nodiscard]] static inline QByteArray qtNativeEventType()
+{
+    static const auto result = FRAMELESSHELPER_BYTEARRAY_LITERAL("xcb_generic_event_t");
+    return result;
+}
+
+// Interned once, the atoms never change during the lifetime of the X server.
+[[nodiscard]] static inline const X11WindowStateAtoms &atoms()
+{
+    static const X11WindowStateAtoms result = {
+        Utils::internAtom(ATOM_NET_WM_STATE),
+        Utils::internAtom(ATOM_NET_WM_STATE_MAXIMIZED_VERT),
+        Utils::internAtom(ATOM_NET_WM_STATE_MAXIMIZED_HORZ),
+        Utils::internAtom(ATOM_NET_WM_STATE_FULLSCREEN),
+        Utils::internAtom(ATOM_NET_WM_STATE_HIDDEN),
+        Utils::internAtom(ATOM_NET_FRAME_EXTENTS)
+    };
+    return result;
+}
+
+// An empty property value means the window manager deleted the property.
+static inline void updateWindowState(X11WindowState &state, const QByteArray &value)
+{
+    state.maximizedVertically = false;
+    state.maximizedHorizontally = false;
+    state.fullScreen = false;
+    state.hidden = false;
+    const auto states = reinterpret_cast<const quint32 *>(value.constData());
+    const auto count = qsizetype(value.size() / qsizetype(sizeof(quint32)));
+    for (qsizetype index = 0; index != count; ++index) {
+        const xcb_atom_t atom = states[index];
+        if (atom == atoms().maximizedVertically) {
+            state.maximizedVertically = true;
+        } else if (atom == atoms().maximizedHorizontally) {
+            state.maximizedHorizontally = true;
+        } else if (atom == atoms().fullScreen) {
+            state.fullScreen = true;
+        } else if (atom == atoms().hidden) {
+            state.hidden = true;
+        }
+    }
+}
+
+static inline void updateFrameExtents(X11WindowState &state, const QByteArray &value)
+{
+    state.frameExtentsValid = true;
+    if (value.size() < qsizetype(kFrameExtentsCount * sizeof(quint32))) {
+        state.frameExtents = {};
+        return;
+    }
+    // The order is left, right, top, bottom.
+    const auto extents = reinterpret_cast<const quint32 *>(value.constData());
+    state.frameExtents = QMargins{ int(extents[0]), int(extents[2]), int(extents[1]), int(extents[3]) };
+}
+
+X11WindowStateMirror::X11WindowStateMirror() = default;
+
+X11WindowStateMirror::~X11WindowStateMirror() = default;
+
+void X11WindowStateMirror::addWindow(const QObject *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    const FramelessDataPtr data = FramelessManagerPrivate::getData(window);
+    if (!data || !data->windowId) {
+        return;
+    }
+    // Wayland and the other platforms have no X connection.
+    if (!Utils::x11_connection()) {
+        return;
+    }
+    if ((atoms().state == XCB_NONE) || (atoms().frameExtents == XCB_NONE)) {
+        WARNING << "Failed to retrieve the atoms of _NET_WM_STATE and _NET_FRAME_EXTENTS.";
+        return;
+    }
+    if (!data->x11WindowState.valid) {
+        updateWindowState(data->x11WindowState,
+            Utils::getWindowProperty(data->windowId, atoms().state, XCB_ATOM_ATOM, kMaximumWindowStateCount));
+        // The frame extents are fetched on the first read, most windows never need them.
+        data->x11WindowState.frameExtentsValid = false;
+        data->x11WindowState.valid = true;
+    }
+    if (!g_internalData()->eventFilter) {
+        g_internalData()->eventFilter = std::make_unique<X11WindowStateMirror>();
+        qApp->installNativeEventFilter(g_internalData()->eventFilter.get());
+    }
+}
+
+QMargins X11WindowStateMirror::frameExtents(const QObject *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return {};
+    }
+    const FramelessDataPtr data = FramelessManagerPrivate::getData(window);
+    if (!data || !data->windowId || !data->x11WindowState.valid) {
+        return {};
+    }
+    if (!data->x11WindowState.frameExtentsValid) {
+        updateFrameExtents(data->x11WindowState,
+            Utils::getWindowProperty(data->windowId, atoms().frameExtents, XCB_ATOM_CARDINAL, kFrameExtentsCount));
+    }
+    return data->x11WindowState.frameExtents;
+}
+
+bool X11WindowStateMirror::nativeEventFilter(const QByteArray &eventType, void *message, QT_NATIVE_EVENT_RESULT_TYPE *result)
+{
+    Q_UNUSED(result);
+    if ((eventType != qtNativeEventType()) || !message) {
+        return false;
+    }
+    const auto event = static_cast<const xcb_generic_event_t *>(message);
+    // The highest bit tells whether the event came from a SendEvent request.
+    if ((event->response_type & ~0x80) != XCB_PROPERTY_NOTIFY) {
+        return false;
+    }
+    const auto propertyEvent = static_cast<const xcb_property_notify_event_t *>(message);
+    const bool isState = (propertyEvent->atom == atoms().state);
+    const bool isFrameExtents = (propertyEvent->atom == atoms().frameExtents);
+    if ((!isState && !isFrameExtents) || (propertyEvent->window == XCB_WINDOW_NONE)) {
+        return false;
+    }
+    const auto windowId = WId(propertyEvent->window);
+    const QObject * const window = FramelessManagerPrivate::getWindow(windowId);
+    if (!window) {
+        return false;
+    }
+    const FramelessDataPtr data = FramelessManagerPrivate::getData(window);
+    if (!data || !data->x11WindowState.valid) {
+        return false;
+    }
+    // A deleted property has nothing to read, which saves us the round trip.
+    const bool deleted = (propertyEvent->state == XCB_PROPERTY_DELETE);
+    if (isState) {
+        updateWindowState(data->x11WindowState, deleted ? QByteArray{}
+            : Utils::getWindowProperty(windowId, atoms().state, XCB_ATOM_ATOM, kMaximumWindowStateCount));
+    } else if (deleted) {
+        updateFrameExtents(data->x11WindowState, {});
+    } else {
+        // Fetched again when somebody asks for them, the window manager tends to change
+        // them several times in a row while mapping or maximizing the window.
+        data->x11WindowState.frameExtentsValid = false;
+    }
+    // Qt needs to see them as well.
+    return false;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
@@ -28,6 +28,7 @@
 #include "quickimageitem_p.h"
 #if FRAMELESSHELPER_CONFIG(titlebar)
 #  include "quickchromepalette.h"
+#  include "quickcompacttitlebar_p.h"
 #endif
 #if FRAMELESSHELPER_CONFIG(mica_material)
 #  include "quickmicamaterial.h"
@@ -153,6 +154,7 @@ void FramelessHelperQuickRegisterTypes(QQmlEngine *engine)
 
 #if FRAMELESSHELPER_CONFIG(titlebar)
     qmlRegisterAnonymousType<QuickChromePalette>(QUICK_URI_SHORT);
+    qmlRegisterType<QuickCompactTitleBar>(QUICK_URI_EXPAND("CompactTitleBar"));
 #endif
 #if FRAMELESSHELPER_CONFIG(mica_material)
     qmlRegisterType<QuickMicaMaterial>(QUICK_URI_EXPAND("MicaMaterial"));
@@ -29,13 +29,13 @@
 
 #include "framelessquickhelper.h"
 #if FRAMELESSHELPER_CONFIG(border_painter)
-#  include "quickwindowborder.h"
+#  include "framelessquickhelper_p.h"
 #endif
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/framelesshelper_windows.h>
 #endif // Q_OS_WINDOWS
+#include <FramelessHelper/Core/utils.h>
 #include <QtCore/qloggingcategory.h>
-#include <QtQuick/private/qquickitem_p.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -65,6 +65,49 @@ FramelessQuickApplicationWindowPrivate::FramelessQuickApplicationWindowPrivate(F
 
 FramelessQuickApplicationWindowPrivate::~FramelessQuickApplicationWindowPrivate() = default;
 
+WindowStateFlags FramelessQuickApplicationWindowPrivate::currentWindowStateFlags() const
+{
+    Q_Q(const FramelessQuickApplicationWindow);
+    WindowStateFlags flags = {};
+    flags.setFlag(WindowStateFlag::Hidden, q->isHidden());
+    flags.setFlag(WindowStateFlag::Normal, q->isNormal());
+    flags.setFlag(WindowStateFlag::Minimized, q->isMinimized());
+    flags.setFlag(WindowStateFlag::Maximized, q->isMaximized());
+    flags.setFlag(WindowStateFlag::Zoomed, q->isZoomed());
+    flags.setFlag(WindowStateFlag::FullScreen, q->isFullScreen());
+    return flags;
+}
+
+void FramelessQuickApplicationWindowPrivate::emitWindowStateSignals()
+{
+    const WindowStateFlags flags = currentWindowStateFlags();
+    const WindowStateFlags changed = (flags ^ windowStateFlags);
+    if (!changed) {
+        return;
+    }
+    windowStateFlags = flags;
+    // Every notification re-evaluates all the bindings depending on it, skip the unchanged ones.
+    Q_Q(FramelessQuickApplicationWindow);
+    if (changed.testFlag(WindowStateFlag::Hidden)) {
+        Q_EMIT q->hiddenChanged();
+    }
+    if (changed.testFlag(WindowStateFlag::Normal)) {
+        Q_EMIT q->normalChanged();
+    }
+    if (changed.testFlag(WindowStateFlag::Minimized)) {
+        Q_EMIT q->minimizedChanged();
+    }
+    if (changed.testFlag(WindowStateFlag::Maximized)) {
+        Q_EMIT q->maximizedChanged();
+    }
+    if (changed.testFlag(WindowStateFlag::Zoomed)) {
+        Q_EMIT q->zoomedChanged();
+    }
+    if (changed.testFlag(WindowStateFlag::FullScreen)) {
+        Q_EMIT q->fullScreenChanged();
+    }
+}
+
 FramelessQuickApplicationWindowPrivate *FramelessQuickApplicationWindowPrivate::get(FramelessQuickApplicationWindow *pub)
 {
     Q_ASSERT(pub);
@@ -86,23 +129,22 @@ const FramelessQuickApplicationWindowPrivate *FramelessQuickApplicationWindowPri
 FramelessQuickApplicationWindow::FramelessQuickApplicationWindow(QWindow *parent)
     : QQuickApplicationWindow(parent), d_ptr(std::make_unique<FramelessQuickApplicationWindowPrivate>(this))
 {
-    QQuickItem * const rootItem = contentItem();
-    FramelessQuickHelper::get(rootItem)->extendsContentIntoTitleBar();
+    FramelessQuickHelper * const helper = FramelessQuickHelper::get(contentItem());
+    helper->extendsContentIntoTitleBar();
 #if FRAMELESSHELPER_CONFIG(border_painter)
-    Q_D(FramelessQuickApplicationWindow);
-    d->windowBorder = new QuickWindowBorder;
-    d->windowBorder->setParent(rootItem);
-    d->windowBorder->setParentItem(rootItem);
-    d->windowBorder->setZ(999); // Make sure it always stays on the top.
-    QQuickItemPrivate::get(d->windowBorder)->anchors()->setFill(rootItem);
+    // The window border is a window sized painted item, it's only created once the
+    // window is shown in the normal state and the border has something to draw.
+    connect(this, &FramelessQuickApplicationWindow::visibilityChanged, helper, [helper](){
+        FramelessQuickHelperPrivate::get(helper)->maybeCreateWindowBorder();
+    });
 #endif
+    {
+        Q_D(FramelessQuickApplicationWindow);
+        d->windowStateFlags = d->currentWindowStateFlags();
+    }
     connect(this, &FramelessQuickApplicationWindow::visibilityChanged, this, [this](){
-        Q_EMIT hiddenChanged();
-        Q_EMIT normalChanged();
-        Q_EMIT minimizedChanged();
-        Q_EMIT maximizedChanged();
-        Q_EMIT zoomedChanged();
-        Q_EMIT fullScreenChanged();
+        Q_D(FramelessQuickApplicationWindow);
+        d->emitWindowStateSignals();
     });
 }
 
@@ -174,6 +216,14 @@ void FramelessQuickApplicationWindow::toggleFullScreen()
 void FramelessQuickApplicationWindow::classBegin()
 {
     QQuickApplicationWindow::classBegin();
+    // QML creates the platform window only after the component is complete, so
+    // this is the last chance to set the flag without re-creating the window.
+    if (!handle() && Utils::shouldApplyFramelessWindowHint()) {
+        const Qt::WindowFlags windowFlags = flags();
+        if (!(windowFlags & Qt::FramelessWindowHint)) {
+            setFlags(windowFlags | Qt::FramelessWindowHint);
+        }
+    }
 }
 
 void FramelessQuickApplicationWindow::componentComplete()
@@ -29,12 +29,18 @@
 #endif
 #if FRAMELESSHELPER_CONFIG(border_painter)
 #  include "quickwindowborder.h"
+#  include <FramelessHelper/Core/windowborderpainter.h>
 #endif
+#include "quickwindowshadow_p.h"
+#include "quickperformanceoverlay_p.h"
+#include "hittestvisibleitemset_p.h"
 #include <FramelessHelper/Core/framelessmanager.h>
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessmanager_p.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
 #include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <FramelessHelper/Core/private/windowshadow_p.h>
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/private/winverhelper_p.h>
 #endif // Q_OS_WINDOWS
@@ -77,13 +83,22 @@ static constexpr const auto kRepaintTimerInterval = 300;
 struct FramelessQuickHelperExtraData : public FramelessExtraData
 {
     QPointer<QQuickItem> titleBarItem = nullptr;
-    QList<QPointer<QQuickItem>> hitTestVisibleItems = {};
+    HitTestVisibleItemSet hitTestVisibleItems{};
     QPointer<QQuickItem> windowIconButton = nullptr;
     QPointer<QQuickItem> contextHelpButton = nullptr;
     QPointer<QQuickItem> minimizeButton = nullptr;
     QPointer<QQuickItem> maximizeButton = nullptr;
     QPointer<QQuickItem> closeButton = nullptr;
     QList<QRect> hitTestVisibleRects = {};
+    // The decoration items are created on demand, remember them so that we
+    // don't need to search the whole item tree every time.
+#if FRAMELESSHELPER_CONFIG(mica_material)
+    QPointer<QuickMicaMaterial> micaMaterial = nullptr;
+#endif
+#if FRAMELESSHELPER_CONFIG(border_painter)
+    QPointer<QuickWindowBorder> windowBorder = nullptr;
+#endif
+    QPointer<QuickWindowShadow> windowShadow = nullptr;
 
     FramelessQuickHelperExtraData();
     ~FramelessQuickHelperExtraData() override;
@@ -176,6 +191,14 @@ void FramelessQuickHelperPrivate::attach()
     if (!window) {
         return;
     }
+    // Apply the frameless flag before winId() creates the platform window,
+    // otherwise it has to be re-created once the flag changes.
+    if (!window->handle() && Utils::shouldApplyFramelessWindowHint()) {
+        const Qt::WindowFlags flags = window->flags();
+        if (!(flags & Qt::FramelessWindowHint)) {
+            window->setFlags(flags | Qt::FramelessWindowHint);
+        }
+    }
     const WId windowId = window->winId();
 
     const FramelessDataPtr data = FramelessManagerPrivate::createData(window, windowId);
@@ -228,6 +251,22 @@ void FramelessQuickHelperPrivate::attach()
 
     std::ignore = FramelessManager::instance()->addWindow(window, windowId);
 
+    if (WindowShadow::isEnabled()) {
+        std::ignore = findOrCreateWindowShadow();
+    }
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+    if (PerformanceMonitor::isEnabled()) {
+        QQuickItem * const rootItem = window->contentItem();
+        if (!rootItem->findChild<QuickPerformanceOverlay *>()) {
+            const auto overlay = new QuickPerformanceOverlay;
+            overlay->setParent(rootItem);
+            overlay->setZ(999); // Make sure it always stays on the top.
+            overlay->setParentItem(rootItem);
+        }
+    }
+#endif
+
     // We have to wait for a little time before moving the top level window
     // , because the platform window may not finish initializing by the time
     // we reach here, and all the modifications from the Qt side will be lost
@@ -320,20 +359,28 @@ QuickMicaMaterial *FramelessQuickHelperPrivate::findOrCreateMicaMaterial() const
     if (!window) {
         return nullptr;
     }
-    QQuickItem * const rootItem = window->contentItem();
-    if (const auto item = rootItem->findChild<QuickMicaMaterial *>()) {
-        return item;
+    const FramelessQuickHelperExtraDataPtr extraData = tryGetExtraData(window, false);
+    if (extraData && extraData->micaMaterial) {
+        return extraData->micaMaterial;
     }
-    if (const auto item = window->findChild<QuickMicaMaterial *>()) {
-        return item;
+    QQuickItem * const rootItem = window->contentItem();
+    // Only search once, in case the user has declared one in QML already.
+    QuickMicaMaterial *item = rootItem->findChild<QuickMicaMaterial *>();
+    if (!item) {
+        item = window->findChild<QuickMicaMaterial *>();
     }
-    const auto item = new QuickMicaMaterial;
-    item->setParent(rootItem);
-    item->setParentItem(rootItem);
-    item->setZ(-999); // Make sure it always stays on the bottom.
+    if (!item) {
+        item = new QuickMicaMaterial;
+        item->setParent(rootItem);
+        item->setParentItem(rootItem);
+        item->setZ(-999); // Make sure it always stays on the bottom.
 #if FRAMELESSHELPER_CONFIG(private_qt)
-    QQuickItemPrivate::get(item)->anchors()->setFill(rootItem);
+        QQuickItemPrivate::get(item)->anchors()->setFill(rootItem);
 #endif
+    }
+    if (extraData) {
+        extraData->micaMaterial = item;
+    }
     return item;
 }
 #endif
@@ -346,24 +393,80 @@ QuickWindowBorder *FramelessQuickHelperPrivate::findOrCreateWindowBorder() const
     if (!window) {
         return nullptr;
     }
-    QQuickItem * const rootItem = window->contentItem();
-    if (const auto item = rootItem->findChild<QuickWindowBorder *>()) {
-        return item;
+    const FramelessQuickHelperExtraDataPtr extraData = tryGetExtraData(window, false);
+    if (extraData && extraData->windowBorder) {
+        return extraData->windowBorder;
     }
-    if (const auto item = window->findChild<QuickWindowBorder *>()) {
-        return item;
+    QQuickItem * const rootItem = window->contentItem();
+    // Only search once, in case the user has declared one in QML already.
+    QuickWindowBorder *item = rootItem->findChild<QuickWindowBorder *>();
+    if (!item) {
+        item = window->findChild<QuickWindowBorder *>();
     }
-    const auto item = new QuickWindowBorder;
-    item->setParent(rootItem);
-    item->setParentItem(rootItem);
-    item->setZ(999); // Make sure it always stays on the top.
+    if (!item) {
+        item = new QuickWindowBorder;
+        item->setParent(rootItem);
+        item->setParentItem(rootItem);
+        item->setZ(999); // Make sure it always stays on the top.
 #if FRAMELESSHELPER_CONFIG(private_qt)
-    QQuickItemPrivate::get(item)->anchors()->setFill(rootItem);
+        QQuickItemPrivate::get(item)->anchors()->setFill(rootItem);
 #endif
+    }
+    if (extraData) {
+        extraData->windowBorder = item;
+    }
     return item;
 }
+
+void FramelessQuickHelperPrivate::maybeCreateWindowBorder()
+{
+    Q_Q(FramelessQuickHelper);
+    const QQuickWindow * const window = q->window();
+    // The border is not drawn for maximized and full screen windows.
+    if (!window || (window->visibility() != QQuickWindow::Windowed)) {
+        return;
+    }
+    if (const FramelessQuickHelperExtraDataPtr extraData = tryGetExtraData(window, false)) {
+        if (extraData->windowBorder) {
+            return;
+        }
+    }
+    // A default border draws nothing but the native one, don't create a window
+    // sized item for nothing if the platform doesn't have any.
+    const WindowBorderPainter painter{};
+    if ((painter.nativeThickness() <= 0) || !painter.nativeEdges()) {
+        return;
+    }
+    std::ignore = findOrCreateWindowBorder();
+}
 #endif
 
+QuickWindowShadow *FramelessQuickHelperPrivate::findOrCreateWindowShadow() const
+{
+    Q_Q(const FramelessQuickHelper);
+    const QQuickWindow * const window = q->window();
+    if (!window) {
+        return nullptr;
+    }
+    const FramelessQuickHelperExtraDataPtr extraData = tryGetExtraData(window, false);
+    if (extraData && extraData->windowShadow) {
+        return extraData->windowShadow;
+    }
+    QQuickItem * const rootItem = window->contentItem();
+    QuickWindowShadow *item = rootItem->findChild<QuickWindowShadow *>();
+    if (!item) {
+        item = new QuickWindowShadow;
+        item->setParent(rootItem);
+        item->setZ(-999); // Make sure it always stays at the bottom.
+        // Setting the parent item binds the window and moves the content item inwards.
+        item->setParentItem(rootItem);
+    }
+    if (extraData) {
+        extraData->windowShadow = item;
+    }
+    return item;
+}
+
 FramelessQuickHelper *FramelessQuickHelperPrivate::findOrCreateFramelessHelper(QObject *object)
 {
     Q_ASSERT(object);
@@ -566,12 +669,8 @@ bool FramelessQuickHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) c
             region -= mapItemGeometryToScene(button);
         }
     }
-    if (!extraData->hitTestVisibleItems.isEmpty()) {
-        for (auto &&item : std::as_const(extraData->hitTestVisibleItems)) {
-            if (item && item->isVisible() && item->isEnabled()) {
-                region -= mapItemGeometryToScene(item);
-            }
-        }
+    for (auto &&item : std::as_const(extraData->hitTestVisibleItems.activeItems())) {
+        region -= mapItemGeometryToScene(item);
     }
     if (!extraData->hitTestVisibleRects.isEmpty()) {
         for (auto &&rect : std::as_const(extraData->hitTestVisibleRects)) {
@@ -705,9 +804,9 @@ void FramelessQuickHelper::setHitTestVisible_item(QQuickItem *item, const bool v
         return;
     }
     if (visible) {
-        extraData->hitTestVisibleItems.append(item);
+        extraData->hitTestVisibleItems.insert(item);
     } else {
-        extraData->hitTestVisibleItems.removeAll(item);
+        extraData->hitTestVisibleItems.remove(item);
     }
 }
 
@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "hittestvisibleitemset_p.h"
+#include <QtQuick/qquickitem.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+HitTestVisibleItemSet::HitTestVisibleItemSet(QObject *parent) : QObject(parent)
+{
+}
+
+HitTestVisibleItemSet::~HitTestVisibleItemSet() = default;
+
+void HitTestVisibleItemSet::insert(QQuickItem *item)
+{
+    Q_ASSERT(item);
+    if (!item || m_items.contains(item)) {
+        return;
+    }
+    m_items.insert(item);
+    // Both are about the effective state, which includes the ancestors.
+    connect(item, &QQuickItem::visibleChanged, this, [this, item](){ updateActiveState(item); });
+    connect(item, &QQuickItem::enabledChanged, this, [this, item](){ updateActiveState(item); });
+    connect(item, &QObject::destroyed, this, [this](QObject *object){
+        // Only the address is left at this point.
+        m_items.remove(object);
+        m_activeItems.remove(static_cast<QQuickItem *>(object));
+    });
+    updateActiveState(item);
+}
+
+void HitTestVisibleItemSet::remove(QQuickItem *item)
+{
+    Q_ASSERT(item);
+    if (!item || !m_items.remove(item)) {
+        return;
+    }
+    m_activeItems.remove(item);
+    disconnect(item, nullptr, this, nullptr);
+}
+
+const QSet<QQuickItem *> &HitTestVisibleItemSet::activeItems() const
+{
+    return m_activeItems;
+}
+
+void HitTestVisibleItemSet::updateActiveState(QQuickItem *item)
+{
+    if (item->isVisible() && item->isEnabled()) {
+        m_activeItems.insert(item);
+    } else {
+        m_activeItems.remove(item);
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,707 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "quickcompacttitlebar_p.h"
+
+#if FRAMELESSHELPER_CONFIG(titlebar)
+
+#include "framelessquickhelper.h"
+#if (FRAMELESSHELPER_CONFIG(private_qt) && FRAMELESSHELPER_CONFIG(window))
+#  include "framelessquickwindow_p.h"
+#  if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+#    include "framelessquickapplicationwindow_p.h"
+#  endif
+#endif
+#include <FramelessHelper/Core/private/framelessmanager_p.h>
+#include <FramelessHelper/Core/private/clickdisambiguator_p.h>
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
+#include <FramelessHelper/Core/utils.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qfontmetrics.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qicon.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgimagenode.h>
+#include <QtQuick/qsgrectanglenode.h>
+#include <QtQuick/qsgtexture.h>
+#include <memory>
+#include <vector>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcQuickCompactTitleBar, "wangwenx190.framelesshelper.quick.quickcompacttitlebar")
+#  define INFO qCInfo(lcQuickCompactTitleBar)
+#  define DEBUG qCDebug(lcQuickCompactTitleBar)
+#  define WARNING qCWarning(lcQuickCompactTitleBar)
+#  define CRITICAL qCCritical(lcQuickCompactTitleBar)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+// An image node which is only attached to the tree while it has something to show,
+// image nodes without a texture must never reach the renderer.
+class TextureSlot
+{
+public:
+    explicit TextureSlot(QSGNode *parent, QQuickWindow *window) : m_parent(parent)
+    {
+        Q_ASSERT(m_parent);
+        Q_ASSERT(window);
+        m_node = window->createImageNode();
+        m_node->setFiltering(QSGTexture::Linear);
+    }
+
+    ~TextureSlot()
+    {
+        // The node is owned by the parent while it's attached.
+        if (!m_attached) {
+            delete m_node;
+        }
+    }
+
+    void update(QQuickWindow *window, const QImage &image, const QRectF &rect)
+    {
+        if (image.isNull() || rect.isEmpty()) {
+            if (m_attached) {
+                m_parent->removeChildNode(m_node);
+                m_attached = false;
+            }
+            return;
+        }
+        if (!m_texture || (m_imageKey != image.cacheKey())) {
+            m_texture.reset(window->createTextureFromImage(image));
+            m_imageKey = image.cacheKey();
+            m_node->setTexture(m_texture.get());
+        }
+        m_node->setRect(rect);
+        if (!m_attached) {
+            m_parent->appendChildNode(m_node);
+            m_attached = true;
+        }
+    }
+
+private:
+    QSGNode *m_parent = nullptr;
+    QSGImageNode *m_node = nullptr;
+    std::unique_ptr<QSGTexture> m_texture = nullptr;
+    qint64 m_imageKey = 0;
+    bool m_attached = false;
+};
+
+class CompactTitleBarNode : public QSGNode
+{
+public:
+    explicit CompactTitleBarNode(QQuickWindow *window, const std::size_t buttonCount)
+    {
+        Q_ASSERT(window);
+        background = window->createRectangleNode();
+        appendChildNode(background);
+        // Fixed containers keep the painting order stable when the image nodes come and go.
+        appendChildNode(&iconContainer);
+        appendChildNode(&titleContainer);
+        icon = std::make_unique<TextureSlot>(&iconContainer, window);
+        title = std::make_unique<TextureSlot>(&titleContainer, window);
+        for (std::size_t index = 0; index != buttonCount; ++index) {
+            ButtonNodes buttonNodes = {};
+            buttonNodes.background = window->createRectangleNode();
+            buttonNodes.container = std::make_unique<QSGNode>();
+            buttonNodes.container->appendChildNode(buttonNodes.background);
+            buttonNodes.glyph = std::make_unique<TextureSlot>(buttonNodes.container.get(), window);
+            appendChildNode(buttonNodes.container.get());
+            buttons.push_back(std::move(buttonNodes));
+        }
+    }
+
+    ~CompactTitleBarNode() override
+    {
+        // The slots must go first, detached image nodes are owned by them.
+        icon.reset();
+        title.reset();
+        for (auto &&buttonNodes : buttons) {
+            buttonNodes.glyph.reset();
+            removeChildNode(buttonNodes.container.get());
+        }
+        removeChildNode(&iconContainer);
+        removeChildNode(&titleContainer);
+    }
+
+    struct ButtonNodes
+    {
+        std::unique_ptr<QSGNode> container = nullptr;
+        QSGRectangleNode *background = nullptr;
+        std::unique_ptr<TextureSlot> glyph = nullptr;
+    };
+
+    QSGRectangleNode *background = nullptr;
+    QSGNode iconContainer = {};
+    QSGNode titleContainer = {};
+    std::unique_ptr<TextureSlot> icon = nullptr;
+    std::unique_ptr<TextureSlot> title = nullptr;
+    std::vector<ButtonNodes> buttons = {};
+};
+
+QuickCompactTitleBar::QuickCompactTitleBar(QQuickItem *parent) : QQuickItem(parent)
+{
+    initialize();
+}
+
+QuickCompactTitleBar::~QuickCompactTitleBar() = default;
+
+Qt::Alignment QuickCompactTitleBar::titleLabelAlignment() const
+{
+    return m_labelAlignment;
+}
+
+void QuickCompactTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
+{
+    if (m_labelAlignment == value) {
+        return;
+    }
+    m_labelAlignment = value;
+    polish();
+    Q_EMIT titleLabelAlignmentChanged();
+}
+
+bool QuickCompactTitleBar::isExtended() const
+{
+    return m_extended;
+}
+
+void QuickCompactTitleBar::setExtended(const bool value)
+{
+    if (m_extended == value) {
+        return;
+    }
+    m_extended = value;
+    setHeight(m_extended ? kDefaultExtendedTitleBarHeight : kDefaultTitleBarHeight);
+    Q_EMIT extendedChanged();
+}
+
+bool QuickCompactTitleBar::isHideWhenClose() const
+{
+    return m_hideWhenClose;
+}
+
+void QuickCompactTitleBar::setHideWhenClose(const bool value)
+{
+    if (m_hideWhenClose == value) {
+        return;
+    }
+    m_hideWhenClose = value;
+    Q_EMIT hideWhenCloseChanged();
+}
+
+QuickChromePalette *QuickCompactTitleBar::chromePalette() const
+{
+    return m_chromePalette;
+}
+
+bool QuickCompactTitleBar::windowIconVisible() const
+{
+    return m_windowIconVisible;
+}
+
+void QuickCompactTitleBar::setWindowIconVisible(const bool value)
+{
+    if (m_windowIconVisible == value) {
+        return;
+    }
+    m_windowIconVisible = value;
+    updateLayout();
+    Q_EMIT windowIconVisibleChanged();
+}
+
+void QuickCompactTitleBar::initialize()
+{
+    FramelessManagerPrivate::initializeIconFont();
+
+    setFlag(ItemHasContents);
+    setAcceptHoverEvents(true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+
+    m_iconClickHandler = new ClickDisambiguator(this);
+
+    m_chromePalette = new QuickChromePalette(this);
+    connect(m_chromePalette, &ChromePalette::titleBarColorChanged, this, &QuickCompactTitleBar::polish);
+    connect(m_chromePalette, &ChromePalette::chromeButtonColorChanged, this, &QuickCompactTitleBar::polish);
+
+#if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    m_buttons.at(0).type = SystemButtonType::Minimize;
+    m_buttons.at(1).type = SystemButtonType::Maximize;
+    m_buttons.at(2).type = SystemButtonType::Close;
+#endif
+
+#ifdef Q_OS_MACOS
+    m_labelAlignment = Qt::AlignCenter;
+#else // !Q_OS_MACOS
+    m_labelAlignment = (Qt::AlignLeft | Qt::AlignVCenter);
+#endif // Q_OS_MACOS
+
+    connect(this, &QuickCompactTitleBar::widthChanged, this, &QuickCompactTitleBar::updateLayout);
+    connect(this, &QuickCompactTitleBar::heightChanged, this, &QuickCompactTitleBar::updateLayout);
+    setHeight(kDefaultTitleBarHeight);
+}
+
+void QuickCompactTitleBar::rebindWindow()
+{
+    for (auto &&connection : std::as_const(m_connections)) {
+        disconnect(connection);
+    }
+    m_connections.clear();
+    // The rectangles belong to the previous window, they are meaningless now.
+    m_hitTestRects.clear();
+    m_window = window();
+    if (!m_window) {
+        return;
+    }
+    m_connections.append(connect(m_window, &QQuickWindow::activeChanged, this, &QuickCompactTitleBar::polish));
+    m_connections.append(connect(m_window, &QQuickWindow::windowTitleChanged, this, &QuickCompactTitleBar::polish));
+    m_connections.append(connect(m_window, &QQuickWindow::visibilityChanged, this, &QuickCompactTitleBar::updateLayout));
+    updateLayout();
+}
+
+void QuickCompactTitleBar::updateLayout()
+{
+    const qreal w = width();
+    const qreal h = height();
+    qreal right = w;
+    // The system buttons are right aligned, from the close button to the minimize button.
+    for (auto it = m_buttons.rbegin(); it != m_buttons.rend(); ++it) {
+        const QSizeF buttonSize = kDefaultSystemButtonSize;
+        right -= buttonSize.width();
+        it->rect = QRectF(QPointF(right, 0), QSizeF(buttonSize.width(), h));
+    }
+    qreal left = 0;
+    if (m_windowIconVisible) {
+        const QSizeF iconSize = kDefaultWindowIconSize;
+        m_iconRect = QRectF(QPointF(kDefaultTitleBarContentsMargin, ((h - iconSize.height()) / qreal(2))), iconSize);
+        left = m_iconRect.right();
+    } else {
+        m_iconRect = {};
+    }
+    left += kDefaultTitleBarContentsMargin;
+    right -= kDefaultTitleBarContentsMargin;
+    m_titleRect = ((right > left) ? QRectF(QPointF(left, 0), QSizeF((right - left), h)) : QRectF{});
+    updateHitTestRects();
+    polish();
+}
+
+void QuickCompactTitleBar::updateHitTestRects()
+{
+    if (!m_window) {
+        return;
+    }
+    QList<QRect> rects = {};
+    for (auto &&button : std::as_const(m_buttons)) {
+        rects.append(mapRectToScene(button.rect).toRect());
+    }
+    if (m_windowIconVisible && !m_iconRect.isEmpty()) {
+        rects.append(mapRectToScene(m_iconRect).toRect());
+    }
+    if (rects == m_hitTestRects) {
+        return;
+    }
+    // The button areas must not be treated as the draggable title bar area,
+    // otherwise the window system eats all the mouse events.
+    FramelessQuickHelper * const helper = FramelessQuickHelper::get(this);
+    for (auto &&rect : std::as_const(m_hitTestRects)) {
+        if (!rect.isEmpty()) {
+            helper->setHitTestVisible_rect(rect, false);
+        }
+    }
+    for (auto &&rect : std::as_const(rects)) {
+        if (!rect.isEmpty()) {
+            helper->setHitTestVisible_rect(rect, true);
+        }
+    }
+    m_hitTestRects = rects;
+}
+
+bool QuickCompactTitleBar::isWindowActive() const
+{
+    return (m_window && m_window->isActive());
+}
+
+QColor QuickCompactTitleBar::buttonBackgroundColor(const Button &button) const
+{
+    const bool close = (button.type == SystemButtonType::Close);
+    switch (button.state) {
+    case ButtonState::Pressed:
+        return (close ? m_chromePalette->closeButtonPressColor() : m_chromePalette->chromeButtonPressColor());
+    case ButtonState::Hovered:
+        return (close ? m_chromePalette->closeButtonHoverColor() : m_chromePalette->chromeButtonHoverColor());
+    case ButtonState::Normal:
+        break;
+    }
+    return (close ? m_chromePalette->closeButtonNormalColor() : m_chromePalette->chromeButtonNormalColor());
+}
+
+QColor QuickCompactTitleBar::buttonForegroundColor(const Button &button) const
+{
+    const bool hover = (button.state != ButtonState::Normal);
+    if ((button.type == SystemButtonType::Close) && hover) {
+        return kDefaultWhiteColor;
+    }
+    if (!hover && !isWindowActive()) {
+        return m_chromePalette->titleBarInactiveForegroundColor();
+    }
+    return m_chromePalette->titleBarActiveForegroundColor();
+}
+
+QImage QuickCompactTitleBar::renderText(const QString &text, const QFont &font, const QColor &color,
+    const QSizeF &size, const Qt::Alignment alignment) const
+{
+    if (text.isEmpty() || size.isEmpty()) {
+        return {};
+    }
+    const qreal dpr = (m_window ? m_window->effectiveDevicePixelRatio() : qreal(1));
+    QImage image((size * dpr).toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    image.fill(kDefaultTransparentColor);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font);
+    painter.setPen(color);
+    const QString elidedText = QFontMetricsF(font).elidedText(text, Qt::ElideRight, size.width());
+    painter.drawText(QRectF(QPointF(0, 0), size), int(alignment), elidedText);
+    return image;
+}
+
+void QuickCompactTitleBar::updatePolish()
+{
+    QQuickItem::updatePolish();
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(window(), PerformanceComponent::TitleBar);
+    // Rasterize on the GUI thread, the render thread only uploads the result. Each image is
+    // only rebuilt when its input changes, otherwise the texture of the last frame is reused.
+    const qreal dpr = (m_window ? m_window->effectiveDevicePixelRatio() : qreal(1));
+    const bool active = isWindowActive();
+    const bool maximized = (m_window && (m_window->visibility() == QWindow::Maximized));
+
+    const QString title = (m_window ? m_window->title() : QString());
+    const QColor titleColor = (active ? m_chromePalette->titleBarActiveForegroundColor()
+        : m_chromePalette->titleBarInactiveForegroundColor());
+    const Qt::Alignment titleAlignment = ((m_labelAlignment & Qt::AlignHorizontal_Mask) | Qt::AlignVCenter);
+    const QSizeF titleSize = m_titleRect.size();
+    if ((title != m_titleText) || (titleColor != m_titleColor) || (titleSize != m_titleSize)
+        || !qFuzzyCompare(dpr, m_titleDevicePixelRatio) || (titleAlignment != m_titleAlignment)) {
+        QFont font = QGuiApplication::font();
+        font.setPointSize(kDefaultTitleBarFontPointSize);
+        m_titleImage = renderText(title, font, titleColor, titleSize, titleAlignment);
+        m_titleText = title;
+        m_titleColor = titleColor;
+        m_titleSize = titleSize;
+        m_titleDevicePixelRatio = dpr;
+        m_titleAlignment = titleAlignment;
+    }
+
+    if (m_windowIconVisible && m_window) {
+        const QIcon icon = m_window->icon();
+        const QSize pixelSize = (m_iconRect.size() * dpr).toSize();
+        if (icon.isNull()) {
+            m_iconImage = {};
+            m_iconKey = 0;
+        } else if ((m_iconPixelSize != pixelSize) || (m_iconKey != icon.cacheKey())) {
+            m_iconImage = icon.pixmap(pixelSize).toImage();
+            m_iconKey = icon.cacheKey();
+            m_iconPixelSize = pixelSize;
+        }
+    } else {
+        m_iconImage = {};
+        m_iconKey = 0;
+    }
+
+    for (auto &&button : m_buttons) {
+        const SystemButtonType type = (((button.type == SystemButtonType::Maximize) && maximized)
+            ? SystemButtonType::Restore : button.type);
+        const QColor color = buttonForegroundColor(button);
+        if ((type == button.glyphType) && (color == button.glyphColor)
+            && qFuzzyCompare(dpr, button.glyphDevicePixelRatio)) {
+            continue;
+        }
+        button.glyph = renderText(Utils::getSystemButtonGlyph(type), FramelessManagerPrivate::getIconFont(),
+            color, kDefaultSystemButtonSize, Qt::AlignCenter);
+        button.glyphType = type;
+        button.glyphColor = color;
+        button.glyphDevicePixelRatio = dpr;
+    }
+    update();
+}
+
+QSGNode *QuickCompactTitleBar::updatePaintNode(QSGNode *old, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    QQuickWindow * const w = window();
+    if (!w || (width() <= 0) || (height() <= 0)) {
+        delete old;
+        return nullptr;
+    }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(w, PerformanceComponent::TitleBar);
+    auto node = static_cast<CompactTitleBarNode *>(old);
+    if (!node) {
+        node = new CompactTitleBarNode(w, m_buttons.size());
+    }
+    node->background->setRect(QRectF(QPointF(0, 0), size()));
+    node->background->setColor(isWindowActive() ? m_chromePalette->titleBarActiveBackgroundColor()
+        : m_chromePalette->titleBarInactiveBackgroundColor());
+    node->icon->update(w, m_iconImage, m_iconRect);
+    node->title->update(w, m_titleImage, m_titleRect);
+    for (std::size_t index = 0; index != m_buttons.size(); ++index) {
+        const Button &button = m_buttons.at(index);
+        CompactTitleBarNode::ButtonNodes &buttonNodes = node->buttons.at(index);
+        buttonNodes.background->setRect(button.rect);
+        buttonNodes.background->setColor(buttonBackgroundColor(button));
+        const QSizeF glyphSize = kDefaultSystemButtonSize;
+        const QRectF glyphRect = { (button.rect.center() - QPointF((glyphSize.width() / qreal(2)), (glyphSize.height() / qreal(2)))), glyphSize };
+        buttonNodes.glyph->update(w, button.glyph, glyphRect);
+    }
+    return node;
+}
+
+int QuickCompactTitleBar::buttonAt(const QPointF &pos) const
+{
+    for (std::size_t index = 0; index != m_buttons.size(); ++index) {
+        if (m_buttons.at(index).rect.contains(pos)) {
+            return int(index);
+        }
+    }
+    return -1;
+}
+
+bool QuickCompactTitleBar::isInWindowIconArea(const QPointF &pos) const
+{
+    return (m_windowIconVisible && !m_iconImage.isNull() && m_iconRect.contains(pos));
+}
+
+void QuickCompactTitleBar::setHoveredButton(const int index)
+{
+    if (m_hoveredButton == index) {
+        return;
+    }
+    m_hoveredButton = index;
+    updateButtonStates();
+}
+
+void QuickCompactTitleBar::setPressedButton(const int index)
+{
+    if (m_pressedButton == index) {
+        return;
+    }
+    m_pressedButton = index;
+    updateButtonStates();
+}
+
+void QuickCompactTitleBar::updateButtonStates()
+{
+    bool changed = false;
+    for (int index = 0; index != int(m_buttons.size()); ++index) {
+        Button &button = m_buttons.at(std::size_t(index));
+        ButtonState state = ButtonState::Normal;
+        // A pressed button only looks pressed while the cursor is still above it.
+        if ((m_pressedButton == index) && (m_hoveredButton == index)) {
+            state = ButtonState::Pressed;
+        } else if ((m_hoveredButton == index) && (m_pressedButton < 0)) {
+            state = ButtonState::Hovered;
+        }
+        if (button.state != state) {
+            button.state = state;
+            changed = true;
+        }
+    }
+    if (changed) {
+        // The glyph color of the close button depends on the state as well.
+        polish();
+    }
+}
+
+void QuickCompactTitleBar::triggerButton(const SystemButtonType type)
+{
+    QQuickWindow * const w = window();
+    if (!w) {
+        return;
+    }
+    switch (type) {
+    case SystemButtonType::Minimize:
+#if (FRAMELESSHELPER_CONFIG(private_qt) && FRAMELESSHELPER_CONFIG(window))
+        if (const auto _w = qobject_cast<FramelessQuickWindow *>(w)) {
+            _w->showMinimized2();
+            break;
+        }
+#  if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        if (const auto _w2 = qobject_cast<FramelessQuickApplicationWindow *>(w)) {
+            _w2->showMinimized2();
+            break;
+        }
+#  endif
+#endif
+        w->setVisibility(QQuickWindow::Minimized);
+        break;
+    case SystemButtonType::Maximize:
+    case SystemButtonType::Restore:
+        w->setVisibility((w->visibility() == QQuickWindow::Maximized) ? QQuickWindow::Windowed : QQuickWindow::Maximized);
+        break;
+    case SystemButtonType::Close:
+        if (m_hideWhenClose) {
+            w->hide();
+        } else {
+            w->close();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void QuickCompactTitleBar::hoverEnterEvent(QHoverEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    setHoveredButton(buttonAt(event->position()));
+#else
+    setHoveredButton(buttonAt(event->posF()));
+#endif
+    QQuickItem::hoverEnterEvent(event);
+}
+
+void QuickCompactTitleBar::hoverMoveEvent(QHoverEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    setHoveredButton(buttonAt(event->position()));
+#else
+    setHoveredButton(buttonAt(event->posF()));
+#endif
+    QQuickItem::hoverMoveEvent(event);
+}
+
+void QuickCompactTitleBar::hoverLeaveEvent(QHoverEvent *event)
+{
+    setHoveredButton(-1);
+    QQuickItem::hoverLeaveEvent(event);
+}
+
+void QuickCompactTitleBar::mousePressEvent(QMouseEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->position();
+#else
+    const QPointF pos = event->localPos();
+#endif
+    const int index = buttonAt(pos);
+    if ((event->button() != Qt::LeftButton) || ((index < 0) && !isInWindowIconArea(pos))) {
+        // Let the title bar area do its usual work, such as moving the window.
+        event->ignore();
+        return;
+    }
+    if (index < 0) {
+        m_iconClickHandler->press(event->button(), event->timestamp());
+    }
+    setHoveredButton(index);
+    setPressedButton(index);
+    event->accept();
+}
+
+void QuickCompactTitleBar::mouseMoveEvent(QMouseEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    setHoveredButton(buttonAt(event->position()));
+#else
+    setHoveredButton(buttonAt(event->localPos()));
+#endif
+    event->accept();
+}
+
+void QuickCompactTitleBar::mouseReleaseEvent(QMouseEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->position();
+#else
+    const QPointF pos = event->localPos();
+#endif
+    const int pressed = m_pressedButton;
+    const int index = buttonAt(pos);
+    setPressedButton(-1);
+    setHoveredButton(index);
+    event->accept();
+    if ((pressed >= 0) && (pressed == index)) {
+        triggerButton(m_buttons.at(std::size_t(index)).type);
+        return;
+    }
+    if ((pressed < 0) && isInWindowIconArea(pos)) {
+        // Only wait for as long as a double click is still possible.
+        m_iconClickHandler->release(event->button(), event->timestamp(), [this](){
+            FramelessQuickHelper::get(this)->showSystemMenu(mapToGlobal(QPointF(0, height())).toPoint());
+        });
+    }
+}
+
+void QuickCompactTitleBar::mouseDoubleClickEvent(QMouseEvent *event)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->position();
+#else
+    const QPointF pos = event->localPos();
+#endif
+    if ((event->button() == Qt::LeftButton) && isInWindowIconArea(pos)) {
+        if (QQuickWindow * const w = window()) {
+            // Don't show the system menu anymore, it would prevent the window from closing.
+            m_iconClickHandler->doubleClick();
+            w->close();
+        }
+        event->accept();
+        return;
+    }
+    // Double clicking a system button is just another click.
+    if (buttonAt(pos) >= 0) {
+        mousePressEvent(event);
+        return;
+    }
+    event->ignore();
+}
+
+void QuickCompactTitleBar::mouseUngrabEvent()
+{
+    setPressedButton(-1);
+    QQuickItem::mouseUngrabEvent();
+}
+
+void QuickCompactTitleBar::itemChange(const ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if ((change == ItemSceneChange) && value.window) {
+        rebindWindow();
+    } else if ((change == ItemVisibleHasChanged) && value.boolValue) {
+        updateLayout();
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif
@@ -0,0 +1,171 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "quickdecorationtexturecache_p.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qimage.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgrendererinterface.h>
+#include <QtQuick/qsgtexture.h>
+#include <map>
+#include <tuple>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcQuickDecorationTextureCache, "wangwenx190.framelesshelper.quick.quickdecorationtexturecache")
+#  define INFO qCInfo(lcQuickDecorationTextureCache)
+#  define DEBUG qCDebug(lcQuickDecorationTextureCache)
+#  define WARNING qCWarning(lcQuickDecorationTextureCache)
+#  define CRITICAL qCCritical(lcQuickDecorationTextureCache)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+// Render context, content type, content key.
+using TextureKey = std::tuple<const void *, quint8, quint64>;
+
+struct TextureEntry
+{
+    QSGTexture *texture = nullptr;
+    int refCount = 0;
+};
+
+struct TextureCacheData
+{
+    QMutex mutex{};
+    std::map<TextureKey, TextureEntry> entries = {};
+    QHash<const QSGTexture *, TextureKey> keys = {};
+    QuickDecorationTextureCache::Statistics statistics = {};
+};
+
+Q_GLOBAL_STATIC(TextureCacheData, g_textureCacheData)
+
+[[nodiscard]] static inline const void *renderContextKey(QQuickWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return nullptr;
+    }
+    const QSGRendererInterface * const rendererInterface = window->rendererInterface();
+    if (!rendererInterface) {
+        return window;
+    }
+    if (rendererInterface->graphicsApi() == QSGRendererInterface::Software) {
+        return nullptr;
+    }
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    if (const void * const rhi = rendererInterface->getResource(window, QSGRendererInterface::RhiResource)) {
+        return rhi;
+    }
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    if (rendererInterface->graphicsApi() == QSGRendererInterface::OpenGL) {
+        if (const void * const context = window->openglContext()) {
+            return context;
+        }
+    }
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    // We don't know which windows can share textures with each other, don't share at all.
+    return window;
+}
+
+QSGTexture *QuickDecorationTextureCache::acquire(QQuickWindow *window, const Content content,
+    const quint64 key, const ImageProvider &provider)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(provider);
+    if (!window || !provider) {
+        return nullptr;
+    }
+    const TextureKey textureKey = { renderContextKey(window), quint8(content), key };
+    // Keep holding the lock while uploading, so that the render threads never
+    // upload the same content twice.
+    const QMutexLocker locker(&g_textureCacheData()->mutex);
+    const auto it = g_textureCacheData()->entries.find(textureKey);
+    if (it != g_textureCacheData()->entries.end()) {
+        ++it->second.refCount;
+        ++g_textureCacheData()->statistics.hits;
+        return it->second.texture;
+    }
+    const QImage image = provider();
+    if (image.isNull()) {
+        return nullptr;
+    }
+    QSGTexture * const texture = window->createTextureFromImage(image);
+    if (!texture) {
+        WARNING << "Failed to create the decoration texture for" << window;
+        return nullptr;
+    }
+    g_textureCacheData()->entries.insert({ textureKey, TextureEntry{ texture, 1 } });
+    g_textureCacheData()->keys.insert(texture, textureKey);
+    ++g_textureCacheData()->statistics.uploads;
+    ++g_textureCacheData()->statistics.textures;
+    DEBUG << "Uploaded a decoration texture of" << image.size() << "for content" << quint8(content);
+    return texture;
+}
+
+void QuickDecorationTextureCache::release(QSGTexture *texture)
+{
+    if (!texture) {
+        return;
+    }
+    const QMutexLocker locker(&g_textureCacheData()->mutex);
+    const auto keyIt = g_textureCacheData()->keys.find(texture);
+    if (keyIt == g_textureCacheData()->keys.end()) {
+        WARNING << "Releasing a texture which doesn't belong to the decoration texture cache.";
+        return;
+    }
+    const auto it = g_textureCacheData()->entries.find(keyIt.value());
+    Q_ASSERT(it != g_textureCacheData()->entries.end());
+    if (--it->second.refCount > 0) {
+        return;
+    }
+    g_textureCacheData()->entries.erase(it);
+    g_textureCacheData()->keys.erase(keyIt);
+    --g_textureCacheData()->statistics.textures;
+    delete texture;
+}
+
+QuickDecorationTextureCache::Statistics QuickDecorationTextureCache::statistics()
+{
+    const QMutexLocker locker(&g_textureCacheData()->mutex);
+    return g_textureCacheData()->statistics;
+}
+
+void QuickDecorationTextureCache::resetStatistics()
+{
+    const QMutexLocker locker(&g_textureCacheData()->mutex);
+    // The live texture count is a state rather than a counter.
+    g_textureCacheData()->statistics.uploads = 0;
+    g_textureCacheData()->statistics.hits = 0;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
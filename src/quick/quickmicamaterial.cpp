@@ -27,9 +27,20 @@
 
 #if FRAMELESSHELPER_CONFIG(mica_material)
 
+#include "quickdecorationtexturecache_p.h"
 #include <FramelessHelper/Core/micamaterial.h>
+#include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtGui/qpainter.h>
 #include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgimagenode.h>
+#include <QtQuick/qsgrectanglenode.h>
+#include <QtQuick/qsgtexture.h>
+#include <functional>
+#include <utility>
+#include <vector>
 #if FRAMELESSHELPER_CONFIG(private_qt)
 #  include <QtQuick/private/qquickitem_p.h>
 #  include <QtQuick/private/qquickanchors_p.h>
@@ -52,6 +63,97 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+// The material tile is tiny, repeat it into a larger texture so that fewer nodes
+// are needed to cover the window. Must be a multiple of the tile size.
+static constexpr const QSize kMicaTileTextureSize = { 256, 256 };
+
+class MicaMaterialNode : public QSGNode
+{
+public:
+    explicit MicaMaterialNode()
+    {
+        // The pieces of each layer never overlap, only the layers have to keep their order.
+        appendChildNode(wallpaperLayer);
+        appendChildNode(fillLayer);
+        appendChildNode(tileLayer);
+    }
+
+    ~MicaMaterialNode() override
+    {
+        // The layers and their pieces are owned by us and deleted by QSGNode.
+        QuickDecorationTextureCache::release(wallpaperTexture);
+        QuickDecorationTextureCache::release(tileTexture);
+    }
+
+    // Only goes to the texture cache if the content changed, which is rare compared
+    // to the window moving around. Returns whether the texture has changed.
+    static bool updateTexture(QQuickWindow *window, QSGTexture *&texture, quint64 &textureKey,
+        const QuickDecorationTextureCache::Content content, const quint64 key,
+        const QuickDecorationTextureCache::ImageProvider &provider)
+    {
+        if (textureKey == key) {
+            return false;
+        }
+        QuickDecorationTextureCache::release(texture);
+        texture = (key ? QuickDecorationTextureCache::acquire(window, content, key, provider) : nullptr);
+        textureKey = key;
+        return true;
+    }
+
+    // Nodes are only created or deleted when the number of pieces changes, which happens
+    // when the item is resized or crosses the edges of the wallpaper, not on every move.
+    static void resizeLayer(QSGNode *layer, const int count, const std::function<QSGNode *()> &create)
+    {
+        Q_ASSERT(layer);
+        Q_ASSERT(create);
+        if (!layer || !create) {
+            return;
+        }
+        while (layer->childCount() > count) {
+            QSGNode * const child = layer->lastChild();
+            layer->removeChildNode(child);
+            delete child;
+        }
+        while (layer->childCount() < count) {
+            layer->appendChildNode(create());
+        }
+    }
+
+    static void updateImageNodes(QQuickWindow *window, QSGNode *layer, QSGTexture *texture,
+        const bool textureChanged, const std::vector<std::pair<QRectF, QRectF>> &pieces)
+    {
+        Q_ASSERT(window);
+        Q_ASSERT(layer);
+        if (!window || !layer) {
+            return;
+        }
+        resizeLayer(layer, (texture ? int(pieces.size()) : 0), [window]() -> QSGNode * {
+            QSGImageNode * const imageNode = window->createImageNode();
+            imageNode->setFiltering(QSGTexture::Nearest);
+            return imageNode;
+        });
+        auto piece = pieces.cbegin();
+        for (QSGNode *child = layer->firstChild(); child; child = child->nextSibling(), ++piece) {
+            const auto imageNode = static_cast<QSGImageNode *>(child);
+            // The address of a released texture may be taken by the new one.
+            if (textureChanged || (imageNode->texture() != texture)) {
+                imageNode->setTexture(texture);
+            }
+            // These are no-ops if nothing has changed.
+            imageNode->setRect(piece->first);
+            imageNode->setSourceRect(piece->second);
+        }
+    }
+
+    QSGNode *wallpaperLayer = new QSGNode;
+    QSGNode *fillLayer = new QSGNode;
+    QSGNode *tileLayer = new QSGNode;
+    QSGTexture *wallpaperTexture = nullptr;
+    quint64 wallpaperKey = 0;
+    QSGTexture *tileTexture = nullptr;
+    quint64 tileKey = 0;
+};
+
 QuickMicaMaterialPrivate::QuickMicaMaterialPrivate(QuickMicaMaterial *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -124,7 +226,9 @@ void QuickMicaMaterialPrivate::rebindWindow()
     q->setParent(rootItem);
     q->setParentItem(rootItem);
 #if FRAMELESSHELPER_CONFIG(private_qt)
-    QQuickItemPrivate::get(q)->anchors()->setFill(rootItem);
+    if (!resourcesReleased) {
+        QQuickItemPrivate::get(q)->anchors()->setFill(rootItem);
+    }
 #endif // FRAMELESSHELPER_QUICK_NO_PRIVATE
     q->setZ(-999); // Make sure we always stays on the bottom most place.
     if (rootWindowXChangedConnection) {
@@ -139,9 +243,43 @@ void QuickMicaMaterialPrivate::rebindWindow()
         disconnect(rootWindowActiveChangedConnection);
         rootWindowActiveChangedConnection = {};
     }
+    if (rootWindowVisibilityChangedConnection) {
+        disconnect(rootWindowVisibilityChangedConnection);
+        rootWindowVisibilityChangedConnection = {};
+    }
     rootWindowXChangedConnection = connect(window, &QQuickWindow::xChanged, q, [q](){ q->update(); });
     rootWindowYChangedConnection = connect(window, &QQuickWindow::yChanged, q, [q](){ q->update(); });
     rootWindowActiveChangedConnection = connect(window, &QQuickWindow::activeChanged, q, [q](){ q->update(); });
+    rootWindowVisibilityChangedConnection = connect(window, &QQuickWindow::visibilityChanged,
+        this, &QuickMicaMaterialPrivate::updateResources);
+    updateResources();
+}
+
+void QuickMicaMaterialPrivate::updateResources()
+{
+#if FRAMELESSHELPER_CONFIG(private_qt)
+    Q_Q(QuickMicaMaterial);
+    const QQuickWindow * const window = q->window();
+    if (!window) {
+        return;
+    }
+    const QWindow::Visibility visibility = window->visibility();
+    const bool release = ((visibility == QWindow::Hidden) || (visibility == QWindow::Minimized));
+    if (resourcesReleased == release) {
+        return;
+    }
+    resourcesReleased = release;
+    QQuickAnchors * const anchors = QQuickItemPrivate::get(q)->anchors();
+    // Nobody can see a hidden or minimized window, but the item still holds on to its
+    // nodes and shared textures. Once it becomes empty, its paint node is destroyed and
+    // the textures are released with it.
+    if (release) {
+        anchors->resetFill();
+        q->setSize({});
+    } else if (QQuickItem * const parentItem = q->parentItem()) {
+        anchors->setFill(parentItem);
+    }
+#endif // FRAMELESSHELPER_CONFIG(private_qt)
 }
 
 QuickMicaMaterial::QuickMicaMaterial(QQuickItem *parent)
@@ -158,6 +296,7 @@ void QuickMicaMaterial::paint(QPainter *painter)
         return;
     }
     Q_D(QuickMicaMaterial);
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(window(), PerformanceComponent::MicaMaterial);
     const bool isActive = window() ? window()->isActive() : false;
     const QPoint originPoint = mapToGlobal(QPointF{ 0, 0 }).toPoint();
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
@@ -168,6 +307,109 @@ void QuickMicaMaterial::paint(QPainter *painter)
     d->micaMaterial->paint(painter, QRect{ originPoint, s }, isActive);
 }
 
+QSGNode *QuickMicaMaterial::updatePaintNode(QSGNode *old, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    Q_D(QuickMicaMaterial);
+    QQuickWindow * const w = window();
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+    const QSize s = size().toSize();
+#else // (QT_VERSION < QT_VERSION_CHECK(5, 10, 0))
+    const QSize s = QSizeF{ width(), height() }.toSize();
+#endif // (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+    // Same as QQuickPaintedItem, an empty item releases everything it holds.
+    if (!w || s.isEmpty()) {
+        delete old;
+        return nullptr;
+    }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(w, PerformanceComponent::MicaMaterial);
+    // paint() is never called since we build the nodes ourselves, the quality
+    // governor is fed from here instead.
+    QElapsedTimer paintTimer{};
+    paintTimer.start();
+    // Instead of painting a window sized texture and uploading it again each time
+    // the window moves, we compose the material from textures which are shared by
+    // all the mica materials, only the node geometry changes when the window moves.
+    auto node = static_cast<MicaMaterialNode *>(old);
+    if (!node) {
+        node = new MicaMaterialNode;
+    }
+    MicaMaterialPrivate * const material = MicaMaterialPrivate::get(d->micaMaterial);
+    material->prepareGraphicsResources();
+    const bool active = w->isActive();
+    const MicaQuality quality = material->quality;
+    const QRect mappedRect = material->mapToWallpaper(QRect{ mapToGlobal(QPointF{ 0, 0 }).toPoint(), s });
+    const QSize wallpaperSize = material->wallpaperSize;
+
+    const quint64 wallpaperKey = ((active && (quality != MicaQuality::Solid)) ? MicaMaterialPrivate::wallpaperKey(quality) : 0);
+    const bool wallpaperChanged = MicaMaterialNode::updateTexture(w, node->wallpaperTexture, node->wallpaperKey,
+        QuickDecorationTextureCache::Content::MicaWallpaper, wallpaperKey,
+        [quality]() -> QImage { return MicaMaterialPrivate::wallpaperImage(quality); });
+    std::vector<std::pair<QRectF, QRectF>> wallpaperPieces = {};
+    if (node->wallpaperTexture && !wallpaperSize.isEmpty()) {
+        // The reduced wallpaper is smaller than the area it covers.
+        const QSize textureSize = node->wallpaperTexture->textureSize();
+        const qreal xRatio = (qreal(textureSize.width()) / qreal(wallpaperSize.width()));
+        const qreal yRatio = (qreal(textureSize.height()) / qreal(wallpaperSize.height()));
+        const auto addPiece = [&wallpaperPieces, xRatio, yRatio](const QRect &target, const QPoint &source) -> void {
+            if (target.isEmpty()) {
+                return;
+            }
+            wallpaperPieces.emplace_back(QRectF(target), QRectF{ source.x() * xRatio, source.y() * yRatio,
+                target.width() * xRatio, target.height() * yRatio });
+        };
+        // The window may cross the edges of the wallpaper, the rest of it wraps around.
+        const int leftWidth = qMin(mappedRect.width(), wallpaperSize.width() - mappedRect.x());
+        const int topHeight = qMin(mappedRect.height(), wallpaperSize.height() - mappedRect.y());
+        const int rightWidth = (mappedRect.width() - leftWidth);
+        const int bottomHeight = (mappedRect.height() - topHeight);
+        addPiece(QRect{ 0, 0, leftWidth, topHeight }, mappedRect.topLeft());
+        addPiece(QRect{ leftWidth, 0, rightWidth, topHeight }, QPoint{ 0, mappedRect.y() });
+        addPiece(QRect{ 0, topHeight, leftWidth, bottomHeight }, QPoint{ mappedRect.x(), 0 });
+        addPiece(QRect{ leftWidth, topHeight, rightWidth, bottomHeight }, QPoint{ 0, 0 });
+    }
+    MicaMaterialNode::updateImageNodes(w, node->wallpaperLayer, node->wallpaperTexture, wallpaperChanged, wallpaperPieces);
+
+    const QRect fillRect = { QPoint{ 0, 0 }, mappedRect.size() };
+    const QBrush brush = material->materialBrush(active, quality);
+    const bool textured = (brush.style() == Qt::TexturePattern);
+    bool tileChanged = false;
+    if (textured) {
+        const QImage tile = brush.textureImage();
+        tileChanged = MicaMaterialNode::updateTexture(w, node->tileTexture, node->tileKey,
+            QuickDecorationTextureCache::Content::MicaTile, quint64(tile.cacheKey()),
+            [tile]() -> QImage {
+                QImage image(kMicaTileTextureSize, QImage::Format_ARGB32_Premultiplied);
+                image.fill(Qt::transparent);
+                QPainter painter(&image);
+                painter.fillRect(QRect{ QPoint{ 0, 0 }, image.size() }, QBrush(tile));
+                return image;
+            });
+    } else {
+        tileChanged = MicaMaterialNode::updateTexture(w, node->tileTexture, node->tileKey,
+            QuickDecorationTextureCache::Content::MicaTile, 0, {});
+    }
+    MicaMaterialNode::resizeLayer(node->fillLayer, (textured ? 0 : 1),
+        [w]() -> QSGNode * { return w->createRectangleNode(); });
+    if (const auto rectangleNode = static_cast<QSGRectangleNode *>(node->fillLayer->firstChild())) {
+        rectangleNode->setRect(QRectF(fillRect));
+        rectangleNode->setColor(brush.color());
+    }
+    std::vector<std::pair<QRectF, QRectF>> tilePieces = {};
+    const QSize tileSize = (node->tileTexture ? node->tileTexture->textureSize() : QSize{});
+    if (!tileSize.isEmpty()) {
+        for (int y = 0; y < fillRect.height(); y += tileSize.height()) {
+            for (int x = 0; x < fillRect.width(); x += tileSize.width()) {
+                const QSize pieceSize = { qMin(tileSize.width(), fillRect.width() - x), qMin(tileSize.height(), fillRect.height() - y) };
+                tilePieces.emplace_back(QRectF{ QPointF(x, y), QSizeF(pieceSize) }, QRectF{ QPointF{ 0, 0 }, QSizeF(pieceSize) });
+            }
+        }
+    }
+    MicaMaterialNode::updateImageNodes(w, node->tileLayer, node->tileTexture, tileChanged, tilePieces);
+    material->reportPaintCost(paintTimer.nsecsElapsed());
+    return node;
+}
+
 QColor QuickMicaMaterial::tintColor() const
 {
     Q_D(const QuickMicaMaterial);
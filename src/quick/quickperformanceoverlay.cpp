@@ -0,0 +1,169 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "quickperformanceoverlay_p.h"
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpainter.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgimagenode.h>
+#include <QtQuick/qsgtexture.h>
+#include <memory>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcQuickPerformanceOverlay, "wangwenx190.framelesshelper.quick.quickperformanceoverlay")
+#  define INFO qCInfo(lcQuickPerformanceOverlay)
+#  define DEBUG qCDebug(lcQuickPerformanceOverlay)
+#  define WARNING qCWarning(lcQuickPerformanceOverlay)
+#  define CRITICAL qCCritical(lcQuickPerformanceOverlay)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+// Keep it away from the title bar and the rounded window corners.
+static constexpr const qreal kOverlayMargin = 12;
+
+class PerformanceOverlayNode : public QSGNode
+{
+public:
+    explicit PerformanceOverlayNode(QQuickWindow *window)
+    {
+        Q_ASSERT(window);
+        image = window->createImageNode();
+        appendChildNode(image);
+    }
+    ~PerformanceOverlayNode() override = default;
+
+    // The image node is owned by this node, the texture is owned by us.
+    QSGImageNode *image = nullptr;
+    std::unique_ptr<QSGTexture> texture = nullptr;
+};
+
+QuickPerformanceOverlay::QuickPerformanceOverlay(QQuickItem *parent) : QQuickItem(parent)
+{
+    setFlag(ItemHasContents);
+    // Never steal the mouse events from the window contents.
+    setAcceptedMouseButtons(Qt::NoButton);
+    setAcceptHoverEvents(false);
+    setSize(QSizeF(PerformanceMonitor::overlaySize()));
+    m_refreshTimer.setInterval(PerformanceMonitor::overlayRefreshInterval());
+    connect(&m_refreshTimer, &QTimer::timeout, this, &QuickPerformanceOverlay::update);
+    m_refreshTimer.start();
+}
+
+QuickPerformanceOverlay::~QuickPerformanceOverlay()
+{
+    for (auto &&connection : std::as_const(m_connections)) {
+        disconnect(connection);
+    }
+    if (m_recordedWindow) {
+        PerformanceMonitor::removeWindow(m_recordedWindow);
+    }
+}
+
+QSGNode *QuickPerformanceOverlay::updatePaintNode(QSGNode *old, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    QQuickWindow * const w = window();
+    const QSize overlaySize = size().toSize();
+    if (!w || overlaySize.isEmpty() || !isVisible()) {
+        delete old;
+        return nullptr;
+    }
+    auto node = static_cast<PerformanceOverlayNode *>(old);
+    if (!node) {
+        node = new PerformanceOverlayNode(w);
+    }
+    // The overlay is tiny, simply paint it again on every refresh.
+    const qreal dpr = w->effectiveDevicePixelRatio();
+    QImage image(overlaySize * dpr, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        PerformanceMonitor::paintOverlay(&painter, QRect(QPoint(0, 0), overlaySize), PerformanceMonitor::snapshot(w));
+    }
+    node->texture.reset(w->createTextureFromImage(image));
+    node->image->setTexture(node->texture.get());
+    node->image->setRect(QRectF(QPointF(0, 0), QSizeF(overlaySize)));
+    return node;
+}
+
+void QuickPerformanceOverlay::itemChange(const ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if (change == ItemSceneChange) {
+        rebindWindow();
+    }
+}
+
+void QuickPerformanceOverlay::rebindWindow()
+{
+    for (auto &&connection : std::as_const(m_connections)) {
+        disconnect(connection);
+    }
+    m_connections.clear();
+    if (m_recordedWindow) {
+        PerformanceMonitor::removeWindow(m_recordedWindow);
+        m_recordedWindow = nullptr;
+    }
+    m_window = window();
+    if (!m_window) {
+        return;
+    }
+    m_recordedWindow = m_window;
+    // Emitted from the render thread, the monitor is thread safe.
+    QQuickWindow * const w = m_window;
+    m_connections.append(connect(m_window, &QQuickWindow::frameSwapped, m_window,
+        [w](){ PerformanceMonitor::recordFrame(w); }, Qt::DirectConnection));
+    if (QQuickItem * const parent = parentItem()) {
+        m_connections.append(connect(parent, &QQuickItem::widthChanged, this, &QuickPerformanceOverlay::updateLayout));
+        m_connections.append(connect(parent, &QQuickItem::heightChanged, this, &QuickPerformanceOverlay::updateLayout));
+    }
+    updateLayout();
+}
+
+void QuickPerformanceOverlay::updateLayout()
+{
+    const QQuickItem * const parent = parentItem();
+    if (!parent) {
+        return;
+    }
+    setPosition(QPointF((parent->width() - width() - kOverlayMargin), (parent->height() - height() - kOverlayMargin)));
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(performance_overlay)
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Quick/private/quickperformanceoverlay_p.h"
@@ -35,7 +35,8 @@
 #  include "framelessquickwindow_p.h"
 #  include "framelessquickapplicationwindow_p.h"
 #endif
-#include <QtCore/qtimer.h>
+#include <FramelessHelper/Core/private/clickdisambiguator_p.h>
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qevent.h>
 #include <QtQuick/private/qquickitem_p.h>
@@ -79,6 +80,15 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
         return;
     }
     m_labelAlignment = value;
+    updateTitleLabelAnchors();
+    Q_EMIT titleLabelAlignmentChanged();
+}
+
+void QuickStandardTitleBar::updateTitleLabelAnchors()
+{
+    if (!m_windowTitleLabel) {
+        return;
+    }
     QQuickAnchors * const labelAnchors = QQuickItemPrivate::get(m_windowTitleLabel)->anchors();
     labelAnchors->resetFill();
     labelAnchors->resetCenterIn();
@@ -93,7 +103,7 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
     const QQuickItemPrivate * const titleBarPriv = QQuickItemPrivate::get(this);
     labelAnchors->setVerticalCenter(titleBarPriv->verticalCenter());
     if ((m_labelAlignment & Qt::AlignLeft) || (m_labelAlignment & Qt::AlignRight) || (m_labelAlignment & Qt::AlignHCenter)) {
-        if (m_windowIcon->isVisible()) {
+        if (m_windowIcon && m_windowIcon->isVisible()) {
             labelAnchors->setLeft(QQuickItemPrivate::get(m_windowIcon)->right());
         } else {
             labelAnchors->setLeft(titleBarPriv->left());
@@ -102,7 +112,11 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
 #ifdef Q_OS_MACOS
         labelAnchors->setRight(titleBarPriv->right());
 #elif FRAMELESSHELPER_CONFIG(system_button)
-        labelAnchors->setRight(QQuickItemPrivate::get(m_systemButtonsRow)->left());
+        if (m_systemButtonsRow) {
+            labelAnchors->setRight(QQuickItemPrivate::get(m_systemButtonsRow)->left());
+        } else {
+            labelAnchors->setRight(titleBarPriv->right());
+        }
 #endif
         labelAnchors->setRightMargin(kDefaultTitleBarContentsMargin);
         if (m_labelAlignment & Qt::AlignLeft) {
@@ -117,27 +131,30 @@ void QuickStandardTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
         labelAnchors->setLeft(titleBarPriv->left());
         m_windowTitleLabel->setHAlign(QQuickLabel::AlignLeft);
     }
-    Q_EMIT titleLabelAlignmentChanged();
 }
 
 QQuickLabel *QuickStandardTitleBar::titleLabel() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->initializeTitleLabel();
     return m_windowTitleLabel;
 }
 
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
 QuickStandardSystemButton *QuickStandardTitleBar::minimizeButton() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->initializeSystemButtons();
     return m_minimizeButton;
 }
 
 QuickStandardSystemButton *QuickStandardTitleBar::maximizeButton() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->initializeSystemButtons();
     return m_maximizeButton;
 }
 
 QuickStandardSystemButton *QuickStandardTitleBar::closeButton() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->initializeSystemButtons();
     return m_closeButton;
 }
 #endif
@@ -178,6 +195,9 @@ QuickChromePalette *QuickStandardTitleBar::chromePalette() const
 
 QSizeF QuickStandardTitleBar::windowIconSize() const
 {
+    if (!m_windowIcon) {
+        return m_windowIconSize;
+    }
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
     return m_windowIcon->size();
 #else
@@ -194,6 +214,11 @@ void QuickStandardTitleBar::setWindowIconSize(const QSizeF &value)
     if (windowIconSize() == value) {
         return;
     }
+    m_windowIconSize = value;
+    if (!m_windowIcon) {
+        Q_EMIT windowIconSizeChanged();
+        return;
+    }
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
     m_windowIcon->setSize(value);
 #else
@@ -204,17 +229,18 @@ void QuickStandardTitleBar::setWindowIconSize(const QSizeF &value)
 
 bool QuickStandardTitleBar::windowIconVisible() const
 {
-    return m_windowIcon->isVisible();
+    return (m_windowIcon && m_windowIcon->isVisible());
 }
 
 void QuickStandardTitleBar::setWindowIconVisible(const bool value)
 {
-    if (m_windowIcon->isVisible() == value) {
+    if (windowIconVisible() == value) {
         return;
     }
+    initializeWindowIcon();
     m_windowIcon->setVisible(value);
 #ifndef Q_OS_MACOS
-    if (m_labelAlignment & Qt::AlignLeft) {
+    if (m_windowTitleLabel && (m_labelAlignment & Qt::AlignLeft)) {
         QQuickAnchors * const labelAnchors = QQuickItemPrivate::get(m_windowTitleLabel)->anchors();
         if (value) {
             labelAnchors->setLeft(QQuickItemPrivate::get(m_windowIcon)->right());
@@ -228,6 +254,7 @@ void QuickStandardTitleBar::setWindowIconVisible(const bool value)
 
 QVariant QuickStandardTitleBar::windowIcon() const
 {
+    const_cast<QuickStandardTitleBar *>(this)->initializeWindowIcon();
     return m_windowIcon->source();
 }
 
@@ -237,6 +264,7 @@ void QuickStandardTitleBar::setWindowIcon(const QVariant &value)
     if (!value.isValid()) {
         return;
     }
+    initializeWindowIcon();
     if (m_windowIcon->source() == value) {
         return;
     }
@@ -246,6 +274,9 @@ void QuickStandardTitleBar::setWindowIcon(const QVariant &value)
 void QuickStandardTitleBar::updateMaximizeButton()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
+    if (!m_maximizeButton) {
+        return;
+    }
     const QQuickWindow * const w = window();
     if (!w) {
         return;
@@ -258,6 +289,9 @@ void QuickStandardTitleBar::updateMaximizeButton()
 
 void QuickStandardTitleBar::updateTitleLabelText()
 {
+    if (!m_windowTitleLabel) {
+        return;
+    }
     const QQuickWindow * const w = window();
     if (!w) {
         return;
@@ -271,6 +305,7 @@ void QuickStandardTitleBar::updateTitleBarColor()
     if (!w) {
         return;
     }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(w, PerformanceComponent::TitleBar);
     const bool active = w->isActive();
     const QColor backgroundColor = (active ?
         m_chromePalette->titleBarActiveBackgroundColor() :
@@ -279,16 +314,22 @@ void QuickStandardTitleBar::updateTitleBarColor()
         m_chromePalette->titleBarActiveForegroundColor() :
         m_chromePalette->titleBarInactiveForegroundColor());
     setColor(backgroundColor);
-    m_windowTitleLabel->setColor(foregroundColor);
+    if (m_windowTitleLabel) {
+        m_windowTitleLabel->setColor(foregroundColor);
+    }
 }
 
 void QuickStandardTitleBar::updateChromeButtonColor()
 {
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    if (!m_minimizeButton) {
+        return;
+    }
     const QQuickWindow * const w = window();
     if (!w) {
         return;
     }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(w, PerformanceComponent::TitleBar);
     const QColor activeForeground = m_chromePalette->titleBarActiveForegroundColor();
     const QColor inactiveForeground = m_chromePalette->titleBarInactiveForegroundColor();
     const QColor normal = m_chromePalette->chromeButtonNormalColor();
@@ -362,6 +403,9 @@ void QuickStandardTitleBar::clickCloseButton()
 void QuickStandardTitleBar::retranslateUi()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
+    if (!m_minimizeButton) {
+        return;
+    }
     qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_minimizeButton))->setText(tr("Minimize"));
     qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_maximizeButton))->setText([this]() -> QString {
         if (const QQuickWindow * const w = window()) {
@@ -377,6 +421,9 @@ void QuickStandardTitleBar::retranslateUi()
 
 void QuickStandardTitleBar::updateWindowIcon()
 {
+    if (!m_windowIcon) {
+        return;
+    }
     // The user has set an icon explicitly, don't override it.
     if (m_windowIcon->source().isValid()) {
         return;
@@ -406,30 +453,21 @@ bool QuickStandardTitleBar::mouseEventHandler(QMouseEvent *event)
 #endif
     const bool interestArea = isInTitleBarIconArea(scenePos);
     switch (event->type()) {
+    case QEvent::MouseButtonPress:
+        if (interestArea) {
+            m_iconClickHandler->press(button, event->timestamp());
+        }
+        break;
     case QEvent::MouseButtonRelease:
         if (interestArea) {
             // Sadly the mouse release events are always triggered before the
             // mouse double click events, and if we intercept the mouse release
-            // events here, we'll never get the double click events afterwards,
-            // so we have to wait for a little bit to make sure the double
-            // click events are handled first, before we actually handle the
-            // mouse release events here.
-            // We need to wait long enough because the time interval between these
-            // events is really really short, if the delay time is not long enough,
-            // we still can't trigger the double click event due to we have handled
-            // the mouse release events here already. But we also can't wait too
-            // long, otherwise the system menu will show up too late, which is not
-            // a good user experience. In my experiments, I found that 150ms is
-            // the minimum value we can use here.
+            // events here, we'll never get the double click events afterwards.
+            // The click handler only delays the system menu for as long as a
+            // double click is still possible.
             // We need a copy of the "scenePos" variable here, otherwise it will
             // soon fall out of scope when the lambda function actually runs.
-            QTimer::singleShot(150, this, [this, button, scenePos](){
-                // The close event is already triggered, don't try to show the
-                // system menu anymore, otherwise it will prevent our window
-                // from closing.
-                if (m_closeTriggered) {
-                    return;
-                }
+            m_iconClickHandler->release(button, event->timestamp(), [this, button, scenePos](){
                 FramelessQuickHelper::get(this)->showSystemMenu([this, button, &scenePos]() -> QPoint {
                     QPoint pos = scenePos;
                     if (button == Qt::LeftButton) {
@@ -444,7 +482,9 @@ bool QuickStandardTitleBar::mouseEventHandler(QMouseEvent *event)
     case QEvent::MouseButtonDblClick:
         if (QQuickWindow * const w = window()) {
             if ((button == Qt::LeftButton) && interestArea) {
-                m_closeTriggered = true;
+                // Don't try to show the system menu anymore, otherwise it will
+                // prevent our window from closing.
+                m_iconClickHandler->doubleClick();
                 w->close();
                 // Eat this event, we have handled it here.
                 event->accept();
@@ -466,6 +506,9 @@ QRect QuickStandardTitleBar::windowIconRect() const
     const qreal y = ((height() - size.height()) / qreal(2));
     return QRectF(QPointF(kDefaultTitleBarContentsMargin, y), size).toRect();
 #else
+    if (!m_windowIcon) {
+        return {};
+    }
     return QRectF(QPointF(m_windowIcon->x(), m_windowIcon->y()), windowIconSize()).toRect();
 #endif
 }
@@ -493,6 +536,7 @@ void QuickStandardTitleBar::initialize()
     setAntialiasing(true);
 
     m_chromePalette = new QuickChromePalette(this);
+    m_iconClickHandler = new ClickDisambiguator(this);
     connect(m_chromePalette, &ChromePalette::titleBarColorChanged,
         this, &QuickStandardTitleBar::updateTitleBarColor);
     connect(m_chromePalette, &ChromePalette::chromeButtonColorChanged,
@@ -503,16 +547,36 @@ void QuickStandardTitleBar::initialize()
     b->setColor(kDefaultTransparentColor);
     setHeight(kDefaultTitleBarHeight);
 
-    m_windowTitleLabel = new QQuickLabel(this);
-    m_windowTitleLabel->setMaximumLineCount(1);
-    m_windowTitleLabel->setElideMode(QQuickText::ElideRight);
-    QFont f = m_windowTitleLabel->font();
-    f.setPointSize(kDefaultTitleBarFontPointSize);
-    m_windowTitleLabel->setFont(f);
+    // The title label, the window icon and the system buttons are created lazily, either
+    // when the title bar becomes visible for the first time or when they are accessed
+    // through the public interface, because hidden windows don't need any of them.
+    m_windowIconSize = kDefaultWindowIconSize;
+#ifdef Q_OS_MACOS
+    setTitleLabelAlignment(Qt::AlignCenter);
+#else // !Q_OS_MACOS
+    setTitleLabelAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+#endif // Q_OS_MACOS
+    updateAll();
+}
 
+void QuickStandardTitleBar::initializeWindowIcon()
+{
+    if (m_windowIcon) {
+        return;
+    }
+#ifdef Q_OS_MACOS
+    // The window icon is anchored to the title label on macOS.
+    initializeTitleLabel();
+#endif // Q_OS_MACOS
     const QQuickItemPrivate * const thisPriv = QQuickItemPrivate::get(this);
-
     m_windowIcon = new QuickImageItem(this);
+    m_windowIcon->setVisible(false);
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+    m_windowIcon->setSize(m_windowIconSize);
+#else
+    m_windowIcon->setWidth(m_windowIconSize.width());
+    m_windowIcon->setHeight(m_windowIconSize.height());
+#endif
     QQuickAnchors * const iconAnchors = QQuickItemPrivate::get(m_windowIcon)->anchors();
     iconAnchors->setVerticalCenter(thisPriv->verticalCenter());
 #ifdef Q_OS_MACOS
@@ -527,8 +591,32 @@ void QuickStandardTitleBar::initialize()
     connect(m_windowIcon, &QuickImageItem::sourceChanged, this, &QuickStandardTitleBar::windowIconChanged);
     connect(m_windowIcon, &QuickImageItem::widthChanged, this, &QuickStandardTitleBar::windowIconSizeChanged);
     connect(m_windowIcon, &QuickImageItem::heightChanged, this, &QuickStandardTitleBar::windowIconSizeChanged);
+    updateWindowIcon();
+}
+
+void QuickStandardTitleBar::initializeTitleLabel()
+{
+    if (m_windowTitleLabel) {
+        return;
+    }
+    m_windowTitleLabel = new QQuickLabel(this);
+    m_windowTitleLabel->setMaximumLineCount(1);
+    m_windowTitleLabel->setElideMode(QQuickText::ElideRight);
+    QFont f = m_windowTitleLabel->font();
+    f.setPointSize(kDefaultTitleBarFontPointSize);
+    m_windowTitleLabel->setFont(f);
+    updateTitleLabelAnchors();
+    updateTitleLabelText();
+    updateTitleBarColor();
+}
 
+void QuickStandardTitleBar::initializeSystemButtons()
+{
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    if (m_systemButtonsRow) {
+        return;
+    }
+    const QQuickItemPrivate * const thisPriv = QQuickItemPrivate::get(this);
     m_systemButtonsRow = new QQuickRow(this);
     QQuickAnchors * const rowAnchors = QQuickItemPrivate::get(m_systemButtonsRow)->anchors();
     rowAnchors->setTop(thisPriv->top());
@@ -539,17 +627,26 @@ void QuickStandardTitleBar::initialize()
     connect(m_maximizeButton, &QuickStandardSystemButton::clicked, this, &QuickStandardTitleBar::clickMaximizeButton);
     m_closeButton = new QuickStandardSystemButton(QuickGlobal::SystemButtonType::Close, m_systemButtonsRow);
     connect(m_closeButton, &QuickStandardSystemButton::clicked, this, &QuickStandardTitleBar::clickCloseButton);
+    // The title label is anchored to the left edge of the system buttons.
+    updateTitleLabelAnchors();
+    retranslateUi();
+    updateMaximizeButton();
+    updateChromeButtonColor();
 #endif
+}
 
-    setWindowIconSize(kDefaultWindowIconSize);
-    setWindowIconVisible(false);
-#ifdef Q_OS_MACOS
-    setTitleLabelAlignment(Qt::AlignCenter);
-#else // !Q_OS_MACOS
-    setTitleLabelAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-#endif // Q_OS_MACOS
-    retranslateUi();
-    updateAll();
+void QuickStandardTitleBar::initializeChildrenIfVisible()
+{
+    const QQuickWindow * const w = window();
+    if (!w || !w->isVisible() || !isVisible()) {
+        return;
+    }
+    if (m_windowVisibleChangeConnection) {
+        disconnect(m_windowVisibleChangeConnection);
+        m_windowVisibleChangeConnection = {};
+    }
+    initializeTitleLabel();
+    initializeSystemButtons();
 }
 
 void QuickStandardTitleBar::itemChange(const ItemChange change, const ItemChangeData &value)
@@ -574,11 +671,19 @@ void QuickStandardTitleBar::itemChange(const ItemChange change, const ItemChange
             updateChromeButtonColor();
         });
         m_windowTitleChangeConnection = connect(value.window, &QQuickWindow::windowTitleChanged, this, &QuickStandardTitleBar::updateTitleLabelText);
+        if (m_windowVisibleChangeConnection) {
+            disconnect(m_windowVisibleChangeConnection);
+            m_windowVisibleChangeConnection = {};
+        }
+        m_windowVisibleChangeConnection = connect(value.window, &QQuickWindow::visibleChanged, this, &QuickStandardTitleBar::initializeChildrenIfVisible);
         updateAll();
         value.window->installEventFilter(this);
         // The window has changed, we need to re-add or re-remove the window icon rect to
         // the hit test visible whitelist. This is different with Qt Widgets.
         FramelessQuickHelper::get(this)->setHitTestVisible_rect(windowIconRect(), windowIconVisible_real());
+        initializeChildrenIfVisible();
+    } else if ((change == ItemVisibleHasChanged) && value.boolValue) {
+        initializeChildrenIfVisible();
     }
 }
 
@@ -28,10 +28,12 @@
 #if FRAMELESSHELPER_CONFIG(border_painter)
 
 #include <FramelessHelper/Core/windowborderpainter.h>
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtQuick/qquickwindow.h>
 #if FRAMELESSHELPER_CONFIG(private_qt)
 #  include <QtQuick/private/qquickitem_p.h>
+#  include <QtQuick/private/qquickanchors_p.h>
 #endif
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -124,8 +126,37 @@ void QuickWindowBorderPrivate::update()
     if (!window) {
         return;
     }
+    // Nothing to draw for maximized and full screen windows, or without any visible edge.
+    bool visible = ((window->visibility() == QQuickWindow::Windowed) && (borderPainter->thickness() > 0));
+    if (!borderPainter->edges()) {
+        visible = false;
+    }
+    setResourcesReleased(!visible);
+    q->setVisible(visible);
     q->update();
-    q->setVisible(window->visibility() == QQuickWindow::Windowed);
+}
+
+void QuickWindowBorderPrivate::setResourcesReleased(const bool value)
+{
+#if FRAMELESSHELPER_CONFIG(private_qt)
+    if (resourcesReleased == value) {
+        return;
+    }
+    resourcesReleased = value;
+    Q_Q(QuickWindowBorder);
+    QQuickItem * const parentItem = q->parentItem();
+    QQuickAnchors * const anchors = QQuickItemPrivate::get(q)->anchors();
+    // An invisible painted item still holds on to its window sized texture. Once it
+    // becomes empty, QQuickPaintedItem destroys its paint node and the texture with it.
+    if (value) {
+        anchors->resetFill();
+        q->setSize({});
+    } else if (parentItem) {
+        anchors->setFill(parentItem);
+    }
+#else // !FRAMELESSHELPER_CONFIG(private_qt)
+    Q_UNUSED(value);
+#endif // FRAMELESSHELPER_CONFIG(private_qt)
 }
 
 void QuickWindowBorderPrivate::initialize()
@@ -149,6 +180,10 @@ void QuickWindowBorderPrivate::initialize()
     connect(borderPainter, &WindowBorderPainter::nativeBorderChanged,
         q, &QuickWindowBorder::nativeBorderChanged);
     connect(borderPainter, &WindowBorderPainter::shouldRepaint, q, [q](){ q->update(); });
+    // The visibility depends on these as well.
+    connect(borderPainter, &WindowBorderPainter::thicknessChanged, this, &QuickWindowBorderPrivate::update);
+    connect(borderPainter, &WindowBorderPainter::edgesChanged, this, &QuickWindowBorderPrivate::update);
+    connect(borderPainter, &WindowBorderPainter::nativeBorderChanged, this, &QuickWindowBorderPrivate::update);
 }
 
 void QuickWindowBorderPrivate::rebindWindow()
@@ -162,7 +197,9 @@ void QuickWindowBorderPrivate::rebindWindow()
     q->setParent(rootItem);
     q->setParentItem(rootItem);
 #if FRAMELESSHELPER_CONFIG(private_qt)
-    QQuickItemPrivate::get(q)->anchors()->setFill(rootItem);
+    if (!resourcesReleased) {
+        QQuickItemPrivate::get(q)->anchors()->setFill(rootItem);
+    }
 #endif
     q->setZ(999); // Make sure we always stays on the top most place.
     if (activeChangeConnection) {
@@ -177,6 +214,7 @@ void QuickWindowBorderPrivate::rebindWindow()
         this, &QuickWindowBorderPrivate::update);
     visibilityChangeConnection = connect(window, &QQuickWindow::visibilityChanged,
         this, &QuickWindowBorderPrivate::update);
+    update();
 }
 
 QuickWindowBorder::QuickWindowBorder(QQuickItem *parent)
@@ -193,6 +231,7 @@ void QuickWindowBorder::paint(QPainter *painter)
         return;
     }
     Q_D(QuickWindowBorder);
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(window(), PerformanceComponent::WindowBorder);
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
     const QSize s = size().toSize();
 #else
@@ -0,0 +1,171 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "quickwindowshadow_p.h"
+#include <FramelessHelper/Core/private/windowshadow_p.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgimagenode.h>
+#include <QtQuick/qsgtexture.h>
+#include <array>
+#include <memory>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcQuickWindowShadow, "wangwenx190.framelesshelper.quick.quickwindowshadow")
+#  define INFO qCInfo(lcQuickWindowShadow)
+#  define DEBUG qCDebug(lcQuickWindowShadow)
+#  define WARNING qCWarning(lcQuickWindowShadow)
+#  define CRITICAL qCCritical(lcQuickWindowShadow)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+class WindowShadowNode : public QSGNode
+{
+public:
+    explicit WindowShadowNode(QQuickWindow *window)
+    {
+        Q_ASSERT(window);
+        for (auto &&node : slices) {
+            node = window->createImageNode();
+            // The middle slices are 1px wide, stretching them must not sample the neighbours.
+            node->setFiltering(QSGTexture::Nearest);
+            appendChildNode(node);
+        }
+    }
+    ~WindowShadowNode() override = default;
+
+    // The image nodes are owned by this node, the texture is owned by us.
+    std::array<QSGImageNode *, 8> slices = {};
+    std::unique_ptr<QSGTexture> texture = nullptr;
+    qint64 imageKey = 0;
+};
+
+QuickWindowShadow::QuickWindowShadow(QQuickItem *parent) : QQuickItem(parent)
+{
+    setFlag(ItemHasContents);
+    // Never steal the mouse events from the window contents.
+    setAcceptedMouseButtons(Qt::NoButton);
+    setAcceptHoverEvents(false);
+}
+
+QuickWindowShadow::~QuickWindowShadow() = default;
+
+QSGNode *QuickWindowShadow::updatePaintNode(QSGNode *old, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    QQuickWindow * const w = window();
+    const QSize windowSize = size().toSize();
+    if (!w || windowSize.isEmpty() || !isVisible()) {
+        delete old;
+        return nullptr;
+    }
+    auto node = static_cast<WindowShadowNode *>(old);
+    if (!node) {
+        node = new WindowShadowNode(w);
+    }
+    const WindowShadow::Parameters params = WindowShadow::defaultParameters(w->isActive(), w->effectiveDevicePixelRatio());
+    const QImage image = WindowShadow::texture(params);
+    if (image.isNull()) {
+        delete node;
+        return nullptr;
+    }
+    // The texture only changes when the window activation state or the DPR changes.
+    if (!node->texture || (node->imageKey != image.cacheKey())) {
+        node->texture.reset(w->createTextureFromImage(image));
+        node->imageKey = image.cacheKey();
+        for (auto &&slice : node->slices) {
+            slice->setTexture(node->texture.get());
+        }
+    }
+    const WindowShadow::Slices slices = WindowShadow::slices(params, windowSize);
+    for (std::size_t index = 0; index != slices.size(); ++index) {
+        QSGImageNode * const slice = node->slices.at(index);
+        slice->setSourceRect(QRectF(slices.at(index).source));
+        slice->setRect(slices.at(index).target);
+    }
+    return node;
+}
+
+void QuickWindowShadow::itemChange(const ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if ((change == ItemSceneChange) && value.window) {
+        rebindWindow();
+    }
+}
+
+void QuickWindowShadow::rebindWindow()
+{
+    for (auto &&connection : std::as_const(m_connections)) {
+        disconnect(connection);
+    }
+    m_connections.clear();
+    m_window = window();
+    if (!m_window) {
+        return;
+    }
+    QQuickItem * const contentItem = m_window->contentItem();
+    m_connections.append(connect(m_window, &QQuickWindow::widthChanged, this, &QuickWindowShadow::updateLayout));
+    m_connections.append(connect(m_window, &QQuickWindow::heightChanged, this, &QuickWindowShadow::updateLayout));
+    m_connections.append(connect(m_window, &QQuickWindow::visibilityChanged, this, &QuickWindowShadow::updateLayout));
+    m_connections.append(connect(m_window, &QQuickWindow::activeChanged, this, &QuickWindowShadow::update));
+    // QQuickWindow resizes the content item to the window size on every resize event,
+    // we need to inset it again after that.
+    m_connections.append(connect(contentItem, &QQuickItem::widthChanged, this, &QuickWindowShadow::updateLayout));
+    m_connections.append(connect(contentItem, &QQuickItem::heightChanged, this, &QuickWindowShadow::updateLayout));
+    updateLayout();
+}
+
+void QuickWindowShadow::updateLayout()
+{
+    if (!m_window) {
+        return;
+    }
+    QQuickItem * const contentItem = m_window->contentItem();
+    const bool visible = (WindowShadow::isEnabled() && (m_window->visibility() == QWindow::Windowed));
+    const QMargins margins = (visible ? WindowShadow::margins(
+        WindowShadow::defaultParameters(true, m_window->effectiveDevicePixelRatio())) : QMargins{});
+    const QSizeF windowSize = m_window->size();
+    const QSizeF contentSize = { (windowSize.width() - margins.left() - margins.right()),
+        (windowSize.height() - margins.top() - margins.bottom()) };
+    // Both are no-ops if nothing has changed, which also stops the recursion.
+    contentItem->setPosition(QPointF(margins.left(), margins.top()));
+    contentItem->setSize(contentSize);
+    // We are a child of the content item, cover the whole window.
+    setPosition(QPointF(-margins.left(), -margins.top()));
+    setSize(windowSize);
+    setVisible(visible);
+    update();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
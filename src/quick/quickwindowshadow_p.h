@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Quick/private/quickwindowshadow_p.h"
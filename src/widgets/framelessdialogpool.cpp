@@ -0,0 +1,529 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessdialogpool.h"
+#include "framelessdialogpool_p.h"
+
+#if FRAMELESSHELPER_CONFIG(window)
+
+#include "framelessdialog.h"
+#include "framelesswidgetshelper.h"
+#include <FramelessHelper/Core/framelessmanager.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qwindow.h>
+#include <QtGui/qscreen.h>
+#include <QtGui/qguiapplication.h>
+#include <QtWidgets/qboxlayout.h>
+#include <algorithm>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+#if FRAMELESSHELPER_CONFIG(debug_output)
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcFramelessDialogPool, "wangwenx190.framelesshelper.widgets.framelessdialogpool")
+#  define INFO qCInfo(lcFramelessDialogPool)
+#  define DEBUG qCDebug(lcFramelessDialogPool)
+#  define WARNING qCWarning(lcFramelessDialogPool)
+#  define CRITICAL qCCritical(lcFramelessDialogPool)
+#else
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#endif
+
+using namespace Global;
+
+static inline void removeDeadEntries(QList<FramelessDialogPoolPrivate::Entry> &list)
+{
+    const auto isDead = [](const FramelessDialogPoolPrivate::Entry &entry) -> bool { return entry.dialog.isNull(); };
+    list.erase(std::remove_if(list.begin(), list.end(), isDead), list.end());
+}
+
+[[nodiscard]] static inline qsizetype indexOfDialog(const QList<FramelessDialogPoolPrivate::Entry> &list, const FramelessDialog *dialog)
+{
+    for (qsizetype index = 0; index != list.size(); ++index) {
+        if (list.at(index).dialog == dialog) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+static inline void centerOverWindow(QWidget *dialog, const QWidget *parentWindow)
+{
+    Q_ASSERT(dialog);
+    Q_ASSERT(parentWindow);
+    if (!dialog || !parentWindow) {
+        return;
+    }
+    // Same as what QDialog does for a dialog which has a parent widget: center it over
+    // the parent window but keep it inside the available geometry of the parent's screen.
+    QRect rect = dialog->frameGeometry();
+    rect.moveCenter(parentWindow->frameGeometry().center());
+    const QWindow *parentHandle = parentWindow->windowHandle();
+    if (const QScreen *screen = (parentHandle ? parentHandle->screen() : nullptr)) {
+        const QRect available = screen->availableGeometry();
+        if (rect.right() > available.right()) {
+            rect.moveRight(available.right());
+        }
+        if (rect.bottom() > available.bottom()) {
+            rect.moveBottom(available.bottom());
+        }
+        if (rect.left() < available.left()) {
+            rect.moveLeft(available.left());
+        }
+        if (rect.top() < available.top()) {
+            rect.moveTop(available.top());
+        }
+    }
+    dialog->move(rect.topLeft());
+}
+
+FramelessDialogPoolPrivate::FramelessDialogPoolPrivate(FramelessDialogPool *q) : QObject(q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return;
+    }
+    q_ptr = q;
+    // Only warm up once the event loop has nothing more important to do.
+    warmUpTimer.setSingleShot(true);
+    warmUpTimer.setInterval(0);
+    connect(&warmUpTimer, &QTimer::timeout, this, &FramelessDialogPoolPrivate::warmUpOne);
+    // The idle dialogs were created for the old theme and the old screen setup, it's
+    // cheaper and much safer to re-create them than to patch them up one by one.
+    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged,
+        this, &FramelessDialogPoolPrivate::invalidate);
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, &FramelessDialogPoolPrivate::invalidate);
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, &FramelessDialogPoolPrivate::invalidate);
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &FramelessDialogPoolPrivate::invalidate);
+}
+
+FramelessDialogPoolPrivate::~FramelessDialogPoolPrivate()
+{
+    warmUpTimer.stop();
+    for (auto &&entry : std::as_const(warmingDialogs)) {
+        delete entry.dialog.data();
+    }
+    for (auto &&entry : std::as_const(idleDialogs)) {
+        delete entry.dialog.data();
+    }
+    // The dialogs which are still in use belong to their users from now on.
+    for (auto &&entry : std::as_const(loanedDialogs)) {
+        if (FramelessDialog *dialog = entry.dialog.data()) {
+            dialog->removeEventFilter(this);
+            dialog->setAttribute(Qt::WA_DeleteOnClose);
+        }
+    }
+}
+
+FramelessDialogPoolPrivate *FramelessDialogPoolPrivate::get(FramelessDialogPool *pub)
+{
+    Q_ASSERT(pub);
+    if (!pub) {
+        return nullptr;
+    }
+    return pub->d_func();
+}
+
+const FramelessDialogPoolPrivate *FramelessDialogPoolPrivate::get(const FramelessDialogPool *pub)
+{
+    Q_ASSERT(pub);
+    if (!pub) {
+        return nullptr;
+    }
+    return pub->d_func();
+}
+
+FramelessDialog *FramelessDialogPoolPrivate::createDialog()
+{
+    // FramelessDialog creates its native window and registers itself to
+    // FramelessManager in its constructor, which is the expensive part.
+    const auto dialog = new FramelessDialog;
+    dialog->setAttribute(Qt::WA_DeleteOnClose, false);
+    const auto layout = new QVBoxLayout(dialog);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    return dialog;
+}
+
+FramelessDialog *FramelessDialogPoolPrivate::takeIdleDialog()
+{
+    purgeDeadEntries();
+    while (!idleDialogs.isEmpty()) {
+        const Entry entry = idleDialogs.takeLast();
+        if (entry.generation == generation) {
+            return entry.dialog.data();
+        }
+        delete entry.dialog.data();
+    }
+    return nullptr;
+}
+
+qint64 FramelessDialogPoolPrivate::idleMemoryCost() const
+{
+    qint64 cost = 0;
+    for (auto &&entry : std::as_const(idleDialogs)) {
+        cost += estimateMemoryCost(entry.dialog);
+    }
+    for (auto &&entry : std::as_const(warmingDialogs)) {
+        cost += estimateMemoryCost(entry.dialog);
+    }
+    return cost;
+}
+
+qint64 FramelessDialogPoolPrivate::estimateMemoryCost(const QWidget *widget)
+{
+    if (!widget) {
+        return 0;
+    }
+    // The backing store is by far the biggest thing a hidden window holds on to.
+    const qreal dpr = widget->devicePixelRatioF();
+    const QSize size = widget->size();
+    return qint64(qreal(size.width()) * dpr) * qint64(qreal(size.height()) * dpr) * 4;
+}
+
+void FramelessDialogPoolPrivate::scheduleWarmUp()
+{
+    if (!warmUpTimer.isActive()) {
+        warmUpTimer.start();
+    }
+}
+
+void FramelessDialogPoolPrivate::warmUpOne()
+{
+    purgeDeadEntries();
+    const auto pending = std::count_if(warmingDialogs.cbegin(), warmingDialogs.cend(),
+        [this](const Entry &entry) -> bool { return (entry.generation == generation); });
+    if ((idleDialogs.size() + pending) >= capacity) {
+        return;
+    }
+    // Don't create more windows than the memory limit can hold. A fresh dialog
+    // has the default size, so measure one of its siblings if there are any.
+    const qint64 extraCost = [this]() -> qint64 {
+        if (!idleDialogs.isEmpty()) {
+            return estimateMemoryCost(idleDialogs.constLast().dialog);
+        }
+        return (qint64(kDefaultWindowSize.width()) * qint64(kDefaultWindowSize.height()) * 4);
+    }();
+    if ((idleMemoryCost() + extraCost) > memoryLimit) {
+        DEBUG << "The memory limit has been reached, stop warming up.";
+        return;
+    }
+    FramelessDialog *dialog = createDialog();
+    warmingDialogs.append(Entry{ dialog, generation });
+    // The dialog can't be handed out before the platform window finishes its
+    // initialization, otherwise QPA would reset our geometry changes.
+    FramelessWidgetsHelper *helper = FramelessWidgetsHelper::get(dialog);
+    if (helper->isReady()) {
+        handleDialogReady();
+    } else {
+        connect(helper, &FramelessWidgetsHelper::ready, this,
+            &FramelessDialogPoolPrivate::handleDialogReady, Qt::UniqueConnection);
+    }
+}
+
+void FramelessDialogPoolPrivate::handleDialogReady()
+{
+    Q_Q(FramelessDialogPool);
+    bool changed = false;
+    for (qsizetype index = warmingDialogs.size() - 1; index >= 0; --index) {
+        const Entry entry = warmingDialogs.at(index);
+        if (!entry.dialog) {
+            warmingDialogs.removeAt(index);
+            continue;
+        }
+        if (!FramelessWidgetsHelper::get(entry.dialog)->isReady()) {
+            continue;
+        }
+        warmingDialogs.removeAt(index);
+        if (entry.generation != generation) {
+            delete entry.dialog.data();
+            continue;
+        }
+        idleDialogs.append(entry);
+        changed = true;
+    }
+    if (!changed) {
+        return;
+    }
+    Q_EMIT q->availableCountChanged();
+    // Keep going until the pool is full, one dialog per event loop iteration.
+    scheduleWarmUp();
+}
+
+void FramelessDialogPoolPrivate::recycle(FramelessDialog *dialog)
+{
+    Q_ASSERT(dialog);
+    if (!dialog) {
+        return;
+    }
+    const qsizetype index = indexOfDialog(loanedDialogs, dialog);
+    if (index < 0) {
+        return;
+    }
+    Entry entry = loanedDialogs.takeAt(index);
+    dialog->removeEventFilter(this);
+    if (dialog->isVisible()) {
+        dialog->hide();
+    }
+    purgeDeadEntries();
+    if ((entry.generation != generation) || (idleDialogs.size() >= capacity)
+        || ((idleMemoryCost() + estimateMemoryCost(dialog)) > memoryLimit)) {
+        dialog->deleteLater();
+        return;
+    }
+    // Throw away the previous content and everything else the user may have changed.
+    // The user may have taken the content back, it's none of our business then.
+    if (QWidget *content = entry.content.data(); content && (content->parentWidget() == dialog)) {
+        if (QLayout *layout = dialog->layout()) {
+            layout->removeWidget(content);
+        }
+        content->hide();
+        content->deleteLater();
+    }
+    if (QWindow *window = dialog->windowHandle()) {
+        window->setTransientParent(nullptr);
+    }
+    dialog->setWindowTitle({});
+    dialog->setWindowModality(Qt::NonModal);
+    dialog->setResult(0);
+    // Let QDialog re-calculate the size and the position when it's shown next time.
+    dialog->setAttribute(Qt::WA_Resized, false);
+    dialog->setAttribute(Qt::WA_Moved, false);
+    entry.content = nullptr;
+    entry.parentWindow = nullptr;
+    idleDialogs.append(entry);
+    Q_Q(FramelessDialogPool);
+    Q_EMIT q->availableCountChanged();
+}
+
+void FramelessDialogPoolPrivate::dropIdleDialogs()
+{
+    warmUpTimer.stop();
+    // The dialogs still waiting for the platform window and the ones in use are
+    // dropped once they become ready or come back.
+    ++generation;
+    const bool changed = !idleDialogs.isEmpty();
+    for (auto &&entry : std::as_const(idleDialogs)) {
+        if (entry.dialog) {
+            entry.dialog->deleteLater();
+        }
+    }
+    idleDialogs.clear();
+    if (changed) {
+        Q_Q(FramelessDialogPool);
+        Q_EMIT q->availableCountChanged();
+    }
+}
+
+void FramelessDialogPoolPrivate::purgeDeadEntries()
+{
+    removeDeadEntries(warmingDialogs);
+    removeDeadEntries(idleDialogs);
+    removeDeadEntries(loanedDialogs);
+}
+
+void FramelessDialogPoolPrivate::invalidate()
+{
+    dropIdleDialogs();
+    scheduleWarmUp();
+}
+
+bool FramelessDialogPoolPrivate::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if (!object || !event) {
+        return false;
+    }
+    // QDialog centers a dialog without a parent widget on the screen right before showing
+    // it, and the size may have changed since acquire(), put it back over the parent window.
+    if ((event->type() == QEvent::Show) && !event->spontaneous() && object->isWidgetType()) {
+        const auto dialog = qobject_cast<FramelessDialog *>(object);
+        const qsizetype index = (dialog ? indexOfDialog(loanedDialogs, dialog) : -1);
+        if ((index >= 0) && !dialog->testAttribute(Qt::WA_Moved)) {
+            if (const QWidget *parentWindow = loanedDialogs.at(index).parentWindow.data()) {
+                centerOverWindow(dialog, parentWindow);
+            }
+        }
+    }
+    // A spontaneous hide event is sent when the dialog gets minimized, it's still in use.
+    if ((event->type() == QEvent::Hide) && !event->spontaneous() && object->isWidgetType()) {
+        const QPointer<FramelessDialog> dialog = qobject_cast<FramelessDialog *>(object);
+        if (dialog) {
+            // Don't pull the rug out from under QDialog::exec() and the signal handlers
+            // of finished()/accepted()/rejected(), recycle it after they are done.
+            QTimer::singleShot(0, this, [this, dialog](){
+                if (dialog && !dialog->isVisible()) {
+                    recycle(dialog);
+                }
+            });
+        }
+    }
+    return QObject::eventFilter(object, event);
+}
+
+FramelessDialogPool::FramelessDialogPool(QObject *parent)
+    : QObject(parent), d_ptr(std::make_unique<FramelessDialogPoolPrivate>(this))
+{
+}
+
+FramelessDialogPool::~FramelessDialogPool() = default;
+
+int FramelessDialogPool::capacity() const
+{
+    Q_D(const FramelessDialogPool);
+    return d->capacity;
+}
+
+void FramelessDialogPool::setCapacity(const int value)
+{
+    Q_ASSERT(value >= 0);
+    if (value < 0) {
+        return;
+    }
+    Q_D(FramelessDialogPool);
+    if (d->capacity == value) {
+        return;
+    }
+    d->capacity = value;
+    bool changed = false;
+    while (d->idleDialogs.size() > value) {
+        const FramelessDialogPoolPrivate::Entry entry = d->idleDialogs.takeFirst();
+        if (entry.dialog) {
+            entry.dialog->deleteLater();
+        }
+        changed = true;
+    }
+    d->scheduleWarmUp();
+    Q_EMIT capacityChanged();
+    if (changed) {
+        Q_EMIT availableCountChanged();
+    }
+}
+
+qint64 FramelessDialogPool::memoryLimit() const
+{
+    Q_D(const FramelessDialogPool);
+    return d->memoryLimit;
+}
+
+void FramelessDialogPool::setMemoryLimit(const qint64 value)
+{
+    Q_ASSERT(value >= 0);
+    if (value < 0) {
+        return;
+    }
+    Q_D(FramelessDialogPool);
+    if (d->memoryLimit == value) {
+        return;
+    }
+    d->memoryLimit = value;
+    d->purgeDeadEntries();
+    bool changed = false;
+    while (!d->idleDialogs.isEmpty() && (d->idleMemoryCost() > value)) {
+        const FramelessDialogPoolPrivate::Entry entry = d->idleDialogs.takeFirst();
+        entry.dialog->deleteLater();
+        changed = true;
+    }
+    d->scheduleWarmUp();
+    Q_EMIT memoryLimitChanged();
+    if (changed) {
+        Q_EMIT availableCountChanged();
+    }
+}
+
+int FramelessDialogPool::availableCount() const
+{
+    Q_D(const FramelessDialogPool);
+    int count = 0;
+    for (auto &&entry : std::as_const(d->idleDialogs)) {
+        if (entry.dialog && (entry.generation == d->generation)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+FramelessDialog *FramelessDialogPool::acquire(QWidget *content, QWidget *parent)
+{
+    Q_D(FramelessDialogPool);
+    FramelessDialog *dialog = d->takeIdleDialog();
+    if (dialog) {
+        Q_EMIT availableCountChanged();
+    } else {
+        DEBUG << "The pool is empty, creating a new dialog on demand.";
+        dialog = d->createDialog();
+    }
+    QWidget *parentWindow = (parent ? parent->window() : nullptr);
+    d->loanedDialogs.append(FramelessDialogPoolPrivate::Entry{ dialog, d->generation, content, parentWindow });
+    dialog->installEventFilter(d);
+    if (content) {
+        dialog->layout()->addWidget(content);
+        content->show();
+    }
+    // Re-parenting a top level widget may re-create its native window, which is exactly
+    // what we are trying to avoid, so only the transient parent is changed here. It's
+    // what the window manager uses for stacking and modality anyway. The position is
+    // ours to take care of, QDialog only centers dialogs over their parent widget.
+    if (parentWindow) {
+        if (QWindow *handle = dialog->windowHandle()) {
+            handle->setTransientParent(parentWindow->windowHandle());
+        }
+        centerOverWindow(dialog, parentWindow);
+        // Still let QDialog (and us) re-calculate the position once it gets shown.
+        dialog->setAttribute(Qt::WA_Moved, false);
+    }
+    // Refill the pool in the background.
+    d->scheduleWarmUp();
+    return dialog;
+}
+
+void FramelessDialogPool::release(FramelessDialog *dialog)
+{
+    Q_ASSERT(dialog);
+    if (!dialog) {
+        return;
+    }
+    Q_D(FramelessDialogPool);
+    d->recycle(dialog);
+}
+
+void FramelessDialogPool::warmUp()
+{
+    Q_D(FramelessDialogPool);
+    d->scheduleWarmUp();
+}
+
+void FramelessDialogPool::clear()
+{
+    Q_D(FramelessDialogPool);
+    d->dropIdleDialogs();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif
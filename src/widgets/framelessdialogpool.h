@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Widgets/framelessdialogpool.h"
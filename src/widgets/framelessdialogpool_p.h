@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Widgets/private/framelessdialogpool_p.h"
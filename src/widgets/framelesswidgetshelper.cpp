@@ -33,6 +33,7 @@
 #  include "framelessdialog_p.h"
 #endif
 #include "widgetssharedhelper_p.h"
+#include "hittestvisiblewidgetset_p.h"
 #include <FramelessHelper/Core/framelessmanager.h>
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessmanager_p.h>
@@ -76,7 +77,7 @@ static constexpr const auto kRepaintTimerInterval = 300;
 struct FramelessWidgetsHelperExtraData : public FramelessExtraData
 {
     QPointer<QWidget> titleBarWidget = nullptr;
-    QList<QPointer<QWidget>> hitTestVisibleWidgets = {};
+    HitTestVisibleWidgetSet hitTestVisibleWidgets{};
     QPointer<QWidget> windowIconButton = nullptr;
     QPointer<QWidget> contextHelpButton = nullptr;
     QPointer<QWidget> minimizeButton = nullptr;
@@ -182,7 +183,10 @@ static inline void forceWidgetRepaint(QWidget *widget)
     // Try to force the widget to repaint itself, in case:
     //   (1) It's a child widget;
     //   (2) It's a top level window but not minimized/maximized/fullscreen.
-    if (!widget->isWindow() || !(widget->windowState() & (Qt::WindowMinimized | Qt::WindowMaximized | Qt::WindowFullScreen))) {
+    // Ask the window manager's view first, resizing a window which is actually maximized
+    // only makes the window manager correct us again.
+    if (!widget->isWindow() || (FramelessManagerPrivate::mirroredWindowState(widget).value_or(
+            Utils::windowStatesToWindowState(widget->windowState())) == Qt::WindowNoState)) {
         // A widget will most likely repaint itself if it's size is changed.
         if (!isWidgetFixedSize(widget)) {
             const QSize originalSize = widget->size();
@@ -420,6 +424,15 @@ void FramelessWidgetsHelperPrivate::attach()
         window->setAttribute(Qt::WA_NativeWindow);
     }
 
+    // Apply the frameless flag before winId() creates the native window, changing
+    // it afterwards hides the widget and makes Qt re-create the platform window.
+    if (!window->testAttribute(Qt::WA_WState_Created) && Utils::shouldApplyFramelessWindowHint()) {
+        const Qt::WindowFlags flags = window->windowFlags();
+        if (!(flags & Qt::FramelessWindowHint)) {
+            window->setWindowFlags(flags | Qt::FramelessWindowHint);
+        }
+    }
+
     const WId windowId = window->winId();
     const FramelessDataPtr data = FramelessManagerPrivate::createData(window, windowId);
     Q_ASSERT(data);
@@ -628,12 +641,8 @@ bool FramelessWidgetsHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos)
             region -= mapWidgetGeometryToScene(button);
         }
     }
-    if (!extraData->hitTestVisibleWidgets.isEmpty()) {
-        for (auto &&widget : std::as_const(extraData->hitTestVisibleWidgets)) {
-            if (widget && widget->isVisible() && widget->isEnabled()) {
-                region -= mapWidgetGeometryToScene(widget);
-            }
-        }
+    for (auto &&widget : std::as_const(extraData->hitTestVisibleWidgets.activeWidgets())) {
+        region -= mapWidgetGeometryToScene(widget);
     }
     if (!extraData->hitTestVisibleRects.isEmpty()) {
         for (auto &&rect : std::as_const(extraData->hitTestVisibleRects)) {
@@ -665,7 +674,9 @@ bool FramelessWidgetsHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) c
         return ((pos.x() < kDefaultResizeBorderThickness)
                 || (pos.x() >= (window->width() - kDefaultResizeBorderThickness)));
     }();
-    return ((Utils::windowStatesToWindowState(window->windowState()) == Qt::WindowNoState) && withinFrameBorder);
+    const Qt::WindowState state = FramelessManagerPrivate::mirroredWindowState(window).value_or(
+        Utils::windowStatesToWindowState(window->windowState()));
+    return ((state == Qt::WindowNoState) && withinFrameBorder);
 }
 
 void FramelessWidgetsHelperPrivate::setSystemButtonState(const SystemButtonType button, const ButtonState state)
@@ -979,9 +990,9 @@ void FramelessWidgetsHelper::setHitTestVisible(QWidget *widget, const bool visib
         return;
     }
     if (visible) {
-        extraData->hitTestVisibleWidgets.append(widget);
+        extraData->hitTestVisibleWidgets.insert(widget);
     } else {
-        extraData->hitTestVisibleWidgets.removeAll(widget);
+        extraData->hitTestVisibleWidgets.remove(widget);
     }
 }
 
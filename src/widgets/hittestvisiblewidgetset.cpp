@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "hittestvisiblewidgetset_p.h"
+#include <QtCore/qcoreevent.h>
+#include <QtWidgets/qwidget.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+HitTestVisibleWidgetSet::HitTestVisibleWidgetSet(QObject *parent) : QObject(parent)
+{
+}
+
+HitTestVisibleWidgetSet::~HitTestVisibleWidgetSet() = default;
+
+void HitTestVisibleWidgetSet::insert(QWidget *widget)
+{
+    Q_ASSERT(widget);
+    if (!widget || m_widgets.contains(widget)) {
+        return;
+    }
+    m_widgets.insert(widget);
+    widget->installEventFilter(this);
+    connect(widget, &QObject::destroyed, this, [this](QObject *object){
+        // Only the address is left at this point.
+        m_widgets.remove(object);
+        m_activeWidgets.remove(static_cast<QWidget *>(object));
+    });
+    updateActiveState(widget, widget->isVisible());
+}
+
+void HitTestVisibleWidgetSet::remove(QWidget *widget)
+{
+    Q_ASSERT(widget);
+    if (!widget || !m_widgets.remove(widget)) {
+        return;
+    }
+    m_activeWidgets.remove(widget);
+    widget->removeEventFilter(this);
+    disconnect(widget, nullptr, this, nullptr);
+}
+
+const QSet<QWidget *> &HitTestVisibleWidgetSet::activeWidgets() const
+{
+    return m_activeWidgets;
+}
+
+bool HitTestVisibleWidgetSet::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if (!object || !event || !object->isWidgetType()) {
+        return false;
+    }
+    const auto widget = static_cast<QWidget *>(object);
+    // These are also sent when an ancestor is shown, hidden, enabled or disabled.
+    switch (event->type()) {
+    case QEvent::Show:
+        updateActiveState(widget, true);
+        break;
+    case QEvent::Hide:
+        updateActiveState(widget, false);
+        break;
+    case QEvent::EnabledChange:
+        updateActiveState(widget, widget->isVisible());
+        break;
+    default:
+        break;
+    }
+    return false;
+}
+
+void HitTestVisibleWidgetSet::updateActiveState(QWidget *widget, const bool visible)
+{
+    if (visible && widget->isEnabled()) {
+        m_activeWidgets.insert(widget);
+    } else {
+        m_activeWidgets.remove(widget);
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "performanceoverlaywidget_p.h"
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
+#include <QtGui/qpainter.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+PerformanceOverlayWidget::PerformanceOverlayWidget(QWidget *window) : QWidget(window)
+{
+    Q_ASSERT(window);
+    m_window = window;
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setFocusPolicy(Qt::NoFocus);
+    resize(PerformanceMonitor::overlaySize());
+    m_refreshTimer.setInterval(PerformanceMonitor::overlayRefreshInterval());
+    connect(&m_refreshTimer, &QTimer::timeout, this, [this](){ update(); });
+    m_refreshTimer.start();
+}
+
+PerformanceOverlayWidget::~PerformanceOverlayWidget()
+{
+    // The window is going away, or it doesn't want the overlay anymore.
+    if (m_window) {
+        PerformanceMonitor::removeWindow(m_window);
+    }
+}
+
+void PerformanceOverlayWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    if (!m_window) {
+        return;
+    }
+    QPainter painter(this);
+    PerformanceMonitor::paintOverlay(&painter, rect(), PerformanceMonitor::snapshot(m_window));
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#endif // FRAMELESSHELPER_CONFIG(performance_overlay)
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Widgets/private/performanceoverlaywidget_p.h"
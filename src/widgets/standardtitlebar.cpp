@@ -32,6 +32,9 @@
 #endif
 #include "framelesswidgetshelper.h"
 #include <FramelessHelper/Core/utils.h>
+#include <FramelessHelper/Core/private/clickdisambiguator_p.h>
+#include <FramelessHelper/Core/private/framelessmanager_p.h>
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
 #include <QtCore/qcoreevent.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qloggingcategory.h>
@@ -155,7 +158,7 @@ StandardTitleBarPrivate::FontMetrics StandardTitleBarPrivate::titleLabelSize() c
 int StandardTitleBarPrivate::titleLabelMaxWidth() const
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && !defined(Q_OS_MACOS))
-    const int chromeButtonAreaWidth = (closeButton->x() + closeButton->width() - minimizeButton->x());
+    const int chromeButtonAreaWidth = (closeButton ? (closeButton->x() + closeButton->width() - minimizeButton->x()) : 0);
 #else
     static constexpr const int chromeButtonAreaWidth = 70;
 #endif
@@ -190,29 +193,23 @@ bool StandardTitleBarPrivate::mouseEventHandler(QMouseEvent *event)
 #  endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     const bool interestArea = isInTitleBarIconArea(scenePos);
     switch (event->type()) {
+    case QEvent::MouseButtonPress:
+        if (interestArea) {
+            iconClickHandler->press(button, event->timestamp());
+        }
+        break;
     case QEvent::MouseButtonRelease:
         // We need a valid top level widget here.
         if (window && interestArea) {
             // Sadly the mouse release events are always triggered before the
             // mouse double click events, and if we intercept the mouse release
-            // events here, we'll never get the double click events afterwards,
-            // so we have to wait for a little bit to make sure the double
-            // click events are handled first, before we actually handle the
-            // mouse release events here.
-            // We need to wait long enough because the time interval between these
-            // events is really really short, if the delay time is not long enough,
-            // we still can't trigger the double click event due to we have handled
-            // the mouse release events here already. But we also can't wait too
-            // long, otherwise the system menu will show up too late, which is not
-            // a good user experience. In my experiments, I found that 150ms is
-            // the minimum value we can use here.
+            // events here, we'll never get the double click events afterwards.
+            // The click handler only delays the system menu for as long as a
+            // double click is still possible.
             // We need a copy of the "scenePos" variable here, otherwise it will
             // soon fall out of scope when the lambda function actually runs.
-            QTimer::singleShot(150, this, [this, button, q, scenePos](){
-                // The close event is already triggered, don't try to show the
-                // system menu anymore, otherwise it will prevent our window
-                // from closing.
-                if (closeTriggered) {
+            iconClickHandler->release(button, event->timestamp(), [this, button, q, scenePos](){
+                if (!window) {
                     return;
                 }
                 // Please refer to the comments in StandardTitleBarPrivate::setWindowIconVisible().
@@ -230,7 +227,9 @@ bool StandardTitleBarPrivate::mouseEventHandler(QMouseEvent *event)
     case QEvent::MouseButtonDblClick:
         // We need a valid top level widget here.
         if (window && (button == Qt::LeftButton) && interestArea) {
-            closeTriggered = true;
+            // Don't try to show the system menu anymore, otherwise it will
+            // prevent our window from closing.
+            iconClickHandler->doubleClick();
             window->close();
             // Eat this event, we have handled it here.
             event->accept();
@@ -294,7 +293,12 @@ bool StandardTitleBarPrivate::isInTitleBarIconArea(const QPoint &pos) const
 void StandardTitleBarPrivate::updateMaximizeButton()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
-    const bool max = window->isMaximized();
+    if (!maximizeButton) {
+        return;
+    }
+    // The window manager may not agree with Qt yet, the button should follow the former.
+    const bool max = (FramelessManagerPrivate::mirroredWindowState(window).value_or(
+        Utils::windowStatesToWindowState(window->windowState())) == Qt::WindowMaximized);
     maximizeButton->setButtonType(max ? SystemButtonType::Restore : SystemButtonType::Maximize);
     maximizeButton->setToolTip(max ? tr("Restore") : tr("Maximize"));
 #endif
@@ -309,6 +313,9 @@ void StandardTitleBarPrivate::updateTitleBarColor()
 void StandardTitleBarPrivate::updateChromeButtonColor()
 {
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
+    if (!minimizeButton) {
+        return;
+    }
     const bool active = window->isActiveWindow();
     const QColor activeForeground = chromePalette->titleBarActiveForegroundColor();
     const QColor inactiveForeground = chromePalette->titleBarInactiveForegroundColor();
@@ -339,6 +346,9 @@ void StandardTitleBarPrivate::updateChromeButtonColor()
 void StandardTitleBarPrivate::retranslateUi()
 {
 #if (FRAMELESSHELPER_CONFIG(system_button) && defined(Q_OS_LINUX))
+    if (!minimizeButton) {
+        return;
+    }
     minimizeButton->setToolTip(tr("Minimize"));
     maximizeButton->setToolTip(window->isMaximized() ? tr("Restore") : tr("Maximize"));
     closeButton->setToolTip(tr("Close"));
@@ -356,6 +366,15 @@ bool StandardTitleBarPrivate::eventFilter(QObject *object, QEvent *event)
         return QObject::eventFilter(object, event);
     }
     const auto widget = qobject_cast<QWidget *>(object);
+    if (widget == q_ptr) {
+        // The title bar is about to be shown for the first time, this is the last
+        // chance to create the child controls before they need to be visible.
+        if (event->type() == QEvent::Polish) {
+            initializeChildren();
+            q_ptr->removeEventFilter(this);
+        }
+        return QObject::eventFilter(object, event);
+    }
     if (!widget->isWindow() || (widget != window)) {
         return QObject::eventFilter(object, event);
     }
@@ -381,6 +400,7 @@ void StandardTitleBarPrivate::initialize()
     Q_Q(StandardTitleBar);
     window = q->window();
     chromePalette = new ChromePalette(this);
+    iconClickHandler = new ClickDisambiguator(this);
     connect(chromePalette, &ChromePalette::titleBarColorChanged,
         this, &StandardTitleBarPrivate::updateTitleBarColor);
     connect(chromePalette, &ChromePalette::chromeButtonColorChanged,
@@ -393,6 +413,22 @@ void StandardTitleBarPrivate::initialize()
         Q_UNUSED(title);
         q->update();
     });
+    updateTitleBarColor();
+    window->installEventFilter(this);
+    // The child controls are not needed until the title bar becomes visible, many
+    // applications create lots of hidden frameless windows at startup, so we only
+    // create them when they are shown or accessed for the first time.
+    q->installEventFilter(this);
+}
+
+void StandardTitleBarPrivate::initializeChildren()
+{
+    if (childrenInitialized) {
+        return;
+    }
+    childrenInitialized = true;
+    Q_Q(StandardTitleBar);
+    Q_UNUSED(q);
 #ifdef Q_OS_MACOS
     const auto titleBarLayout = new QHBoxLayout(q);
     titleBarLayout->setSpacing(0);
@@ -401,7 +437,6 @@ void StandardTitleBarPrivate::initialize()
     minimizeButton = new StandardSystemButton(SystemButtonType::Minimize, q);
     connect(minimizeButton, &StandardSystemButton::clicked, window, &QWidget::showMinimized);
     maximizeButton = new StandardSystemButton(SystemButtonType::Maximize, q);
-    updateMaximizeButton();
     connect(maximizeButton, &StandardSystemButton::clicked, this, [this](){
         if (window->isMaximized()) {
             window->showNormal();
@@ -442,10 +477,9 @@ void StandardTitleBarPrivate::initialize()
     titleBarLayout->addStretch();
     titleBarLayout->addLayout(systemButtonsOuterLayout);
 #endif
+    updateMaximizeButton();
     retranslateUi();
-    updateTitleBarColor();
     updateChromeButtonColor();
-    window->installEventFilter(this);
 }
 
 StandardTitleBar::StandardTitleBar(QWidget *parent)
@@ -466,22 +500,32 @@ StandardTitleBar::~StandardTitleBar() = default;
 StandardSystemButton *StandardTitleBar::minimizeButton() const
 {
     Q_D(const StandardTitleBar);
+    const_cast<StandardTitleBarPrivate *>(d)->initializeChildren();
     return d->minimizeButton;
 }
 
 StandardSystemButton *StandardTitleBar::maximizeButton() const
 {
     Q_D(const StandardTitleBar);
+    const_cast<StandardTitleBarPrivate *>(d)->initializeChildren();
     return d->maximizeButton;
 }
 
 StandardSystemButton *StandardTitleBar::closeButton() const
 {
     Q_D(const StandardTitleBar);
+    const_cast<StandardTitleBarPrivate *>(d)->initializeChildren();
     return d->closeButton;
 }
 #endif
 
+void StandardTitleBar::mousePressEvent(QMouseEvent *event)
+{
+    QWidget::mousePressEvent(event);
+    Q_D(StandardTitleBar);
+    std::ignore = d->mouseEventHandler(event);
+}
+
 void StandardTitleBar::mouseReleaseEvent(QMouseEvent *event)
 {
     QWidget::mouseReleaseEvent(event);
@@ -562,6 +606,7 @@ void StandardTitleBar::paintEvent(QPaintEvent *event)
     if (!d->window) {
         return;
     }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(d->window, PerformanceComponent::TitleBar);
     const bool active = d->window->isActiveWindow();
     const QColor backgroundColor = (active ?
         d->chromePalette->titleBarActiveBackgroundColor() :
@@ -588,7 +633,9 @@ void StandardTitleBar::paintEvent(QPaintEvent *event)
                 } else if (d->labelAlignment & Qt::AlignRight) {
                     x = (titleBarWidth - kDefaultTitleBarContentsMargin - labelSize.width);
 #if (!defined(Q_OS_MACOS) && FRAMELESSHELPER_CONFIG(system_button))
-                    x -= (titleBarWidth - d->minimizeButton->x());
+                    if (d->minimizeButton) {
+                        x -= (titleBarWidth - d->minimizeButton->x());
+                    }
 #endif
                 } else if (d->labelAlignment & Qt::AlignHCenter) {
                     x = std::round(qreal(titleBarWidth - labelSize.width) / qreal(2));
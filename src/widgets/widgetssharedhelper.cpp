@@ -23,6 +23,7 @@
  */
 
 #include "widgetssharedhelper_p.h"
+#include "performanceoverlaywidget_p.h"
 #if FRAMELESSHELPER_CONFIG(mica_material)
 #  include <FramelessHelper/Core/micamaterial.h>
 #  include <FramelessHelper/Core/private/micamaterial_p.h>
@@ -32,12 +33,17 @@
 #endif
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
+#include <FramelessHelper/Core/private/framelessmanager_p.h>
+#include <FramelessHelper/Core/private/roundedcorners_p.h>
+#include <FramelessHelper/Core/private/windowshadow_p.h>
+#include <FramelessHelper/Core/private/performancemonitor_p.h>
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/private/winverhelper_p.h>
 #endif // Q_OS_WINDOWS
 #include <QtCore/qcoreevent.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qpainter.h>
+#include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
 #include <QtWidgets/qwidget.h>
 
@@ -58,6 +64,23 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+#if FRAMELESSHELPER_CONFIG(mica_material)
+[[nodiscard]] static inline bool isOpaqueWidget(const QWidget *widget)
+{
+    Q_ASSERT(widget);
+    if (!widget) {
+        return false;
+    }
+    if (widget->testAttribute(Qt::WA_TranslucentBackground)) {
+        return false;
+    }
+    if (widget->testAttribute(Qt::WA_OpaquePaintEvent)) {
+        return true;
+    }
+    return (widget->autoFillBackground() && widget->palette().brush(widget->backgroundRole()).isOpaque());
+}
+#endif
+
 WidgetsSharedHelper::WidgetsSharedHelper(QObject *parent) : QObject(parent)
 {
 }
@@ -99,8 +122,18 @@ void WidgetsSharedHelper::setup(QWidget *widget)
                 m_targetWidget->update();
             }
         });
+#endif
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+    if (PerformanceMonitor::isEnabled()) {
+        delete m_performanceOverlay.data();
+        const auto overlay = new PerformanceOverlayWidget(m_targetWidget);
+        m_performanceOverlay = overlay;
+        updatePerformanceOverlay();
+        overlay->show();
+    }
 #endif
     m_targetWidget->installEventFilter(this);
+    m_windowStateFlags = currentWindowStateFlags();
     updateContentsMargins();
     m_targetWidget->update();
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
@@ -163,6 +196,37 @@ bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
     }
     const auto widget = qobject_cast<QWidget *>(object);
     if (widget != m_targetWidget) {
+        // We are only watching the other widgets of the window, to know when the part
+        // covered by the opaque ones changes.
+        switch (event->type()) {
+#if FRAMELESSHELPER_CONFIG(mica_material)
+        case QEvent::ChildAdded:
+        case QEvent::ChildRemoved:
+        case QEvent::ChildPolished:
+            if (static_cast<QChildEvent *>(event)->child()->isWidgetType()) {
+                m_micaRegionDirty = true;
+            }
+            break;
+        case QEvent::Move:
+        case QEvent::Resize:
+        case QEvent::Show:
+        case QEvent::Hide:
+        case QEvent::ParentChange:
+        case QEvent::PaletteChange:
+            m_micaRegionDirty = true;
+            break;
+        case QEvent::Paint:
+            // Toggling autoFillBackground or WA_OpaquePaintEvent doesn't send any event,
+            // but it repaints the widget. We have painted already, so paint once more.
+            if (!m_micaRegionDirty && (isOpaqueWidget(widget) != m_opaqueWidgets.contains(widget))) {
+                m_micaRegionDirty = true;
+                m_targetWidget->update();
+            }
+            break;
+#endif
+        default:
+            break;
+        }
         return QObject::eventFilter(object, event);
     }
     switch (event->type()) {
@@ -173,21 +237,66 @@ bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
         m_targetWidget->update();
         break;
     case QEvent::Paint: {
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+        if (m_performanceOverlay) {
+            PerformanceMonitor::recordFrame(m_targetWidget);
+        }
+#endif
+        if (shouldPaintShadow()) {
+            QPainter painter(m_targetWidget);
+            paintShadow(&painter);
+        }
 #if FRAMELESSHELPER_CONFIG(mica_material)
-        repaintMica();
+        repaintMica(static_cast<QPaintEvent *>(event)->region());
 #endif
 #if FRAMELESSHELPER_CONFIG(border_painter)
         repaintBorder();
 #endif
+        if (shouldEraseCorners()) {
+            eraseCorners();
+        }
     } break;
+    case QEvent::ChildAdded:
+    case QEvent::ChildRemoved:
+    case QEvent::ChildPolished:
+    case QEvent::LayoutRequest:
+#if FRAMELESSHELPER_CONFIG(mica_material)
+        m_micaRegionDirty = true;
+#endif
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+        // The new children are stacked on top of us.
+        if (m_performanceOverlay && (event->type() == QEvent::ChildAdded)) {
+            m_performanceOverlay->raise();
+        }
+#endif
+        break;
     case QEvent::WindowStateChange:
         if (event->type() == QEvent::WindowStateChange) {
+#if FRAMELESSHELPER_CONFIG(mica_material)
+            // The shadow margins depend on the window state.
+            m_micaRegionDirty = true;
+#endif
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+            updatePerformanceOverlay();
+#endif
             updateContentsMargins();
             emitCustomWindowStateSignals();
         }
         break;
+    case QEvent::Show:
+    case QEvent::Hide:
+        emitCustomWindowStateSignals();
+        break;
     case QEvent::Move:
     case QEvent::Resize:
+        if (event->type() == QEvent::Resize) {
+#if FRAMELESSHELPER_CONFIG(mica_material)
+            m_micaRegionDirty = true;
+#endif
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+            updatePerformanceOverlay();
+#endif
+        }
 #if FRAMELESSHELPER_CONFIG(mica_material)
         if (m_micaEnabled) {
             m_targetWidget->update();
@@ -201,43 +310,216 @@ bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
 }
 
 #if FRAMELESSHELPER_CONFIG(mica_material)
-void WidgetsSharedHelper::repaintMica()
+void WidgetsSharedHelper::repaintMica(const QRegion &exposedRegion)
 {
     if (!m_micaEnabled) {
         return;
     }
+    if (m_micaRegionDirty) {
+        updateMicaRegion();
+    }
+    // Keep the shadow area transparent.
+    const QRect contentRect = m_targetWidget->rect().marginsRemoved(shadowMargins());
+    // Everything else would be overdrawn by the opaque children right away.
+    const QRegion clip = m_micaRegion.intersected(exposedRegion).translated(-contentRect.topLeft());
+    if (clip.isEmpty()) {
+        return;
+    }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(m_targetWidget, PerformanceComponent::MicaMaterial);
     QPainter painter(m_targetWidget);
-    const QRect rect = { m_targetWidget->mapToGlobal(QPoint(0, 0)), m_targetWidget->size() };
-    m_micaMaterial->paint(&painter, rect, m_targetWidget->isActiveWindow());
+    painter.translate(contentRect.topLeft());
+    const QRect rect = { m_targetWidget->mapToGlobal(contentRect.topLeft()), contentRect.size() };
+    m_micaMaterial->paint(&painter, rect, clip, m_targetWidget->isActiveWindow());
+}
+
+void WidgetsSharedHelper::updateMicaRegion()
+{
+    m_micaRegionDirty = false;
+    for (auto &&widget : std::as_const(m_watchedWidgets)) {
+        if (widget) {
+            widget->removeEventFilter(this);
+        }
+    }
+    m_watchedWidgets.clear();
+    m_opaqueWidgets.clear();
+    m_micaRegion = m_targetWidget->rect().marginsRemoved(shadowMargins());
+    const QList<QWidget *> children = m_targetWidget->findChildren<QWidget *>();
+    for (auto &&child : std::as_const(children)) {
+        if (child->window() != m_targetWidget) {
+            continue;
+        }
+        // Watch the transparent ones as well: new widgets may be added into them, and
+        // a splitter moving its transparent panes around moves the opaque widgets inside.
+        // Also watch the hidden ones, we need to know when they show up again.
+        child->installEventFilter(this);
+        m_watchedWidgets.append(child);
+        if (!isOpaqueWidget(child)) {
+            continue;
+        }
+        m_opaqueWidgets.append(child);
+        if (!child->isVisibleTo(m_targetWidget)) {
+            continue;
+        }
+        // The visible region is clipped by the ancestors, which matters for the
+        // contents of the scroll areas.
+        m_micaRegion -= child->visibleRegion().translated(child->mapTo(m_targetWidget, QPoint(0, 0)));
+    }
+}
+#endif
+
+#if FRAMELESSHELPER_CONFIG(performance_overlay)
+void WidgetsSharedHelper::updatePerformanceOverlay()
+{
+    if (!m_performanceOverlay) {
+        return;
+    }
+    // Keep it away from the title bar and the rounded window corners.
+    static constexpr const int kOverlayMargin = 12;
+    const QRect contentRect = m_targetWidget->rect().marginsRemoved(shadowMargins());
+    const QSize overlaySize = m_performanceOverlay->size();
+    m_performanceOverlay->move(contentRect.right() + 1 - kOverlayMargin - overlaySize.width(),
+        contentRect.bottom() + 1 - kOverlayMargin - overlaySize.height());
+    m_performanceOverlay->raise();
 }
 #endif
 
 #if FRAMELESSHELPER_CONFIG(border_painter)
 void WidgetsSharedHelper::repaintBorder()
 {
-    if (Utils::windowStatesToWindowState(m_targetWidget->windowState()) != Qt::WindowNoState) {
+    if (FramelessManagerPrivate::mirroredWindowState(m_targetWidget).value_or(
+            Utils::windowStatesToWindowState(m_targetWidget->windowState())) != Qt::WindowNoState) {
         return;
     }
+    FRAMELESSHELPER_PERFORMANCE_SCOPE(m_targetWidget, PerformanceComponent::WindowBorder);
+    const QRect contentRect = m_targetWidget->rect().marginsRemoved(shadowMargins());
     QPainter painter(m_targetWidget);
-    m_borderPainter->paint(&painter, m_targetWidget->size(), m_targetWidget->isActiveWindow());
+    painter.translate(contentRect.topLeft());
+    m_borderPainter->paint(&painter, contentRect.size(), m_targetWidget->isActiveWindow());
 }
 #endif
 
+WindowStateFlags WidgetsSharedHelper::currentWindowStateFlags() const
+{
+    if (!m_targetWidget) {
+        return {};
+    }
+    // Same as the "hidden", "normal" and "zoomed" properties of FramelessWidget and FramelessMainWindow.
+    WindowStateFlags flags = {};
+    flags.setFlag(WindowStateFlag::Hidden, m_targetWidget->isHidden());
+    flags.setFlag(WindowStateFlag::Normal, (Utils::windowStatesToWindowState(m_targetWidget->windowState()) == Qt::WindowNoState));
+    flags.setFlag(WindowStateFlag::Zoomed, (m_targetWidget->isMaximized() || m_targetWidget->isFullScreen()));
+    return flags;
+}
+
 void WidgetsSharedHelper::emitCustomWindowStateSignals()
 {
+    const WindowStateFlags flags = currentWindowStateFlags();
+    const WindowStateFlags changed = (flags ^ m_windowStateFlags);
+    if (!changed) {
+        return;
+    }
+    m_windowStateFlags = flags;
     const QMetaObject * const mo = m_targetWidget->metaObject();
     if (!mo) {
         return;
     }
-    if (const int idx = mo->indexOfSignal(QMetaObject::normalizedSignature("hiddenChanged()").constData()); idx >= 0) {
-        QMetaObject::invokeMethod(m_targetWidget, "hiddenChanged");
+    // Every notification re-evaluates all the slots depending on it, skip the unchanged ones.
+    if (changed.testFlag(WindowStateFlag::Hidden)) {
+        if (const int idx = mo->indexOfSignal(QMetaObject::normalizedSignature("hiddenChanged()").constData()); idx >= 0) {
+            QMetaObject::invokeMethod(m_targetWidget, "hiddenChanged");
+        }
+    }
+    if (changed.testFlag(WindowStateFlag::Normal)) {
+        if (const int idx = mo->indexOfSignal(QMetaObject::normalizedSignature("normalChanged()").constData()); idx >= 0) {
+            QMetaObject::invokeMethod(m_targetWidget, "normalChanged");
+        }
+    }
+    if (changed.testFlag(WindowStateFlag::Zoomed)) {
+        if (const int idx = mo->indexOfSignal(QMetaObject::normalizedSignature("zoomedChanged()").constData()); idx >= 0) {
+            QMetaObject::invokeMethod(m_targetWidget, "zoomedChanged");
+        }
+    }
+}
+
+bool WidgetsSharedHelper::shouldEraseCorners() const
+{
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    if (RoundedCorners::radius() <= 0) {
+        return false;
+    }
+    // The window shape always cuts the corners, but it's aliased. Smoothing its edge
+    // needs both the alpha channel and the compositing manager.
+    if (!m_targetWidget->testAttribute(Qt::WA_TranslucentBackground) || !Utils::x11_isCompositingManagerRunning()) {
+        return false;
+    }
+    return (Utils::windowStatesToWindowState(m_targetWidget->windowState()) == Qt::WindowNoState);
+#else // !Q_OS_LINUX
+    return false;
+#endif // Q_OS_LINUX
+}
+
+void WidgetsSharedHelper::eraseCorners()
+{
+    // Runs after everything we paint ourselves. The child widgets are painted on top of it
+    // later, the aliased window shape cuts their corners off, see FramelessHelperQt.
+    const QRect contentRect = m_targetWidget->rect().marginsRemoved(shadowMargins());
+    QPainter painter(m_targetWidget);
+    painter.save();
+    painter.translate(contentRect.topLeft());
+    RoundedCorners::eraseCorners(&painter, contentRect.size(), RoundedCorners::radius());
+    painter.restore();
+    if (shouldPaintShadow()) {
+        // The corners have been cut out of the shadow as well, put it back underneath.
+        QRegion clip = {};
+        for (auto &&corner : cornerRects()) {
+            clip += corner;
+        }
+        painter.setClipRegion(clip);
+        painter.setCompositionMode(QPainter::CompositionMode_DestinationOver);
+        paintShadow(&painter);
+    }
+}
+
+bool WidgetsSharedHelper::shouldPaintShadow() const
+{
+    // The shadow area must be transparent, we can't change the window surface format
+    // after the window has been created, so we rely on the user to request it.
+    if (!WindowShadow::isEnabled() || !m_targetWidget->testAttribute(Qt::WA_TranslucentBackground)) {
+        return false;
     }
-    if (const int idx = mo->indexOfSignal(QMetaObject::normalizedSignature("normalChanged()").constData()); idx >= 0) {
-        QMetaObject::invokeMethod(m_targetWidget, "normalChanged");
+    return (Utils::windowStatesToWindowState(m_targetWidget->windowState()) == Qt::WindowNoState);
+}
+
+QMargins WidgetsSharedHelper::shadowMargins() const
+{
+    if (!shouldPaintShadow()) {
+        return {};
     }
-    if (const int idx = mo->indexOfSignal(QMetaObject::normalizedSignature("zoomedChanged()").constData()); idx >= 0) {
-        QMetaObject::invokeMethod(m_targetWidget, "zoomedChanged");
+    return WindowShadow::margins(WindowShadow::defaultParameters(true, m_targetWidget->devicePixelRatioF()));
+}
+
+std::array<QRect, 4> WidgetsSharedHelper::cornerRects() const
+{
+    const QRect contentRect = m_targetWidget->rect().marginsRemoved(shadowMargins());
+    const int radius = RoundedCorners::radius();
+    const int left = contentRect.left();
+    const int top = contentRect.top();
+    const int right = (contentRect.right() + 1 - radius);
+    const int bottom = (contentRect.bottom() + 1 - radius);
+    return {
+        QRect(left, top, radius, radius), QRect(right, top, radius, radius),
+        QRect(left, bottom, radius, radius), QRect(right, bottom, radius, radius)
+    };
+}
+
+void WidgetsSharedHelper::paintShadow(QPainter *painter) const
+{
+    Q_ASSERT(painter);
+    if (!painter) {
+        return;
     }
+    const auto params = WindowShadow::defaultParameters(m_targetWidget->isActiveWindow(), m_targetWidget->devicePixelRatioF());
+    WindowShadow::paint(painter, m_targetWidget->size(), params);
 }
 
 void WidgetsSharedHelper::handleScreenChanged(QScreen *screen)
@@ -288,6 +570,11 @@ void WidgetsSharedHelper::updateContentsMargins()
         return {0, kDefaultWindowFrameBorderThickness, 0, 0};
     }();
     m_targetWidget->setContentsMargins(margins);
+#elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+    // Keep the layout out of the client side shadow area.
+    if (WindowShadow::isEnabled()) {
+        m_targetWidget->setContentsMargins(shadowMargins());
+    }
 #endif
 }
 
@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qstylehints.h>
+#include <FramelessHelper/Core/private/clickdisambiguator_p.h>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_ClickDisambiguator : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void calculateDelay_data();
+    void calculateDelay();
+    void longPressFiresImmediately();
+    void doubleClickCancelsSingleClick();
+    void otherButtonsFireImmediately();
+};
+
+void tst_ClickDisambiguator::calculateDelay_data()
+{
+    QTest::addColumn<int>("button");
+    QTest::addColumn<quint64>("pressTimestamp");
+    QTest::addColumn<quint64>("releaseTimestamp");
+    QTest::addColumn<int>("doubleClickInterval");
+    QTest::addColumn<int>("delay");
+
+    const int left = int(Qt::LeftButton);
+    const int right = int(Qt::RightButton);
+
+    QTest::newRow("quick-click") << left << quint64(1000) << quint64(1080) << 400 << 320;
+    QTest::newRow("instant-click") << left << quint64(1000) << quint64(1000) << 400 << 400;
+    QTest::newRow("just-before-deadline") << left << quint64(1000) << quint64(1399) << 400 << 1;
+    QTest::newRow("at-deadline") << left << quint64(1000) << quint64(1400) << 400 << 0;
+    QTest::newRow("long-press") << left << quint64(1000) << quint64(5000) << 400 << 0;
+    QTest::newRow("right-button") << right << quint64(1000) << quint64(1080) << 400 << 0;
+    QTest::newRow("no-double-click") << left << quint64(1000) << quint64(1080) << 0 << 0;
+    QTest::newRow("negative-interval") << left << quint64(1000) << quint64(1080) << -1 << 0;
+    QTest::newRow("large-timestamps") << left << quint64(0xFFFFFFFF00) << quint64(0xFFFFFFFF64) << 500 << 400;
+}
+
+void tst_ClickDisambiguator::calculateDelay()
+{
+    QFETCH(int, button);
+    QFETCH(quint64, pressTimestamp);
+    QFETCH(quint64, releaseTimestamp);
+    QFETCH(int, doubleClickInterval);
+    QFETCH(int, delay);
+
+    QCOMPARE(ClickDisambiguator::calculateDelay(Qt::MouseButton(button), pressTimestamp,
+        releaseTimestamp, doubleClickInterval), delay);
+}
+
+void tst_ClickDisambiguator::longPressFiresImmediately()
+{
+    const quint64 interval = quint64(QGuiApplication::styleHints()->mouseDoubleClickInterval());
+    ClickDisambiguator disambiguator;
+    int fired = 0;
+    disambiguator.press(Qt::LeftButton, 1000);
+    disambiguator.release(Qt::LeftButton, (1000 + interval), [&fired](){ ++fired; });
+    QCOMPARE(fired, 1);
+    QVERIFY(!disambiguator.isPending());
+}
+
+void tst_ClickDisambiguator::doubleClickCancelsSingleClick()
+{
+    if (QGuiApplication::styleHints()->mouseDoubleClickInterval() <= 0) {
+        QSKIP("Double clicks are disabled on this platform.");
+    }
+    ClickDisambiguator disambiguator;
+    int fired = 0;
+    const auto callback = [&fired](){ ++fired; };
+    disambiguator.press(Qt::LeftButton, 1000);
+    disambiguator.release(Qt::LeftButton, 1010, callback);
+    QCOMPARE(fired, 0);
+    QVERIFY(disambiguator.isPending());
+    // Second press, then QPA reports the double click before the second release.
+    disambiguator.press(Qt::LeftButton, 1020);
+    disambiguator.doubleClick();
+    QVERIFY(!disambiguator.isPending());
+    disambiguator.release(Qt::LeftButton, 1030, callback);
+    QVERIFY(!disambiguator.isPending());
+    QTest::qWait(QGuiApplication::styleHints()->mouseDoubleClickInterval() + 50);
+    QCOMPARE(fired, 0);
+
+    // The state is reset afterwards, the next single click works again.
+    disambiguator.press(Qt::LeftButton, 5000);
+    disambiguator.release(Qt::LeftButton, 5010, callback);
+    QVERIFY(disambiguator.isPending());
+    QTRY_COMPARE(fired, 1);
+}
+
+void tst_ClickDisambiguator::otherButtonsFireImmediately()
+{
+    ClickDisambiguator disambiguator;
+    int fired = 0;
+    disambiguator.press(Qt::RightButton, 1000);
+    disambiguator.release(Qt::RightButton, 1010, [&fired](){ ++fired; });
+    QCOMPARE(fired, 1);
+    QVERIFY(!disambiguator.isPending());
+}
+
+QTEST_MAIN(tst_ClickDisambiguator)
+
+#include "tst_clickdisambiguator.moc"
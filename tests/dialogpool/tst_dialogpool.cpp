@@ -0,0 +1,146 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qscreen.h>
+#include <QtWidgets/qwidget.h>
+#include <FramelessHelper/Widgets/framelessdialog.h>
+#include <FramelessHelper/Widgets/framelessdialogpool.h>
+#include <memory>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_DialogPool : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void recycleDestroysOnlyTheContent();
+    void contentTakenBack();
+    void centeredOverParent();
+
+private:
+    // Runs the deleteLater() calls made by the pool.
+    static void flushDeferredDeletes();
+
+private:
+    std::unique_ptr<FramelessDialogPool> m_pool = nullptr;
+};
+
+void tst_DialogPool::flushDeferredDeletes()
+{
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QCoreApplication::processEvents();
+}
+
+void tst_DialogPool::init()
+{
+    m_pool = std::make_unique<FramelessDialogPool>();
+    m_pool->setCapacity(1);
+    m_pool->warmUp();
+    QTRY_COMPARE(m_pool->availableCount(), 1);
+}
+
+void tst_DialogPool::cleanup()
+{
+    m_pool.reset();
+    flushDeferredDeletes();
+}
+
+void tst_DialogPool::recycleDestroysOnlyTheContent()
+{
+    const QPointer<QWidget> content = new QWidget;
+    const QPointer<FramelessDialog> dialog = m_pool->acquire(content);
+    QVERIFY(dialog);
+    QCOMPARE(content->parentWidget(), static_cast<QWidget *>(dialog.data()));
+    // Children the dialog owns by itself, like the performance overlay.
+    const QPointer<QWidget> overlay = new QWidget(dialog);
+    overlay->setObjectName(FRAMELESSHELPER_STRING_LITERAL("PerformanceOverlay"));
+    dialog->show();
+    QVERIFY(QTest::qWaitForWindowExposed(dialog.data()));
+
+    QSignalSpy availableSpy(m_pool.get(), &FramelessDialogPool::availableCountChanged);
+    dialog->hide();
+    QTRY_COMPARE(m_pool->availableCount(), 1);
+    QVERIFY(availableSpy.count() >= 1);
+    flushDeferredDeletes();
+    QVERIFY(content.isNull());
+    QVERIFY(!overlay.isNull());
+    QVERIFY(!dialog.isNull());
+
+    // The same dialog is handed out again, without the old content.
+    const QPointer<QWidget> newContent = new QWidget;
+    QCOMPARE(m_pool->acquire(newContent), dialog.data());
+    QCOMPARE(newContent->parentWidget(), static_cast<QWidget *>(dialog.data()));
+    QVERIFY(!overlay.isNull());
+    m_pool->release(dialog);
+    flushDeferredDeletes();
+    QVERIFY(newContent.isNull());
+}
+
+void tst_DialogPool::contentTakenBack()
+{
+    const auto content = std::make_unique<QWidget>();
+    FramelessDialog * const dialog = m_pool->acquire(content.get());
+    QVERIFY(dialog);
+    content->setParent(nullptr);
+    m_pool->release(dialog);
+    flushDeferredDeletes();
+    // Still alive, the unique_ptr would crash on a double delete otherwise.
+    QVERIFY(content->parentWidget() == nullptr);
+    QCOMPARE(m_pool->availableCount(), 1);
+}
+
+void tst_DialogPool::centeredOverParent()
+{
+    auto parent = std::make_unique<QWidget>();
+    const QRect available = QGuiApplication::primaryScreen()->availableGeometry();
+    parent->setGeometry(QRect(available.topLeft() + QPoint(50, 50), QSize(600, 400)));
+    parent->show();
+    QVERIFY(QTest::qWaitForWindowExposed(parent.get()));
+
+    const QPointer<FramelessDialog> dialog = m_pool->acquire(nullptr, parent.get());
+    QVERIFY(dialog);
+    // Resized after being handed out, it's centered again when shown.
+    dialog->resize(300, 200);
+    dialog->show();
+    QVERIFY(QTest::qWaitForWindowExposed(dialog.data()));
+    const QPoint offset = (dialog->frameGeometry().center() - parent->frameGeometry().center());
+    QVERIFY2(offset.manhattanLength() <= 2, qPrintable(FRAMELESSHELPER_STRING_LITERAL("Off by %1, %2").arg(offset.x()).arg(offset.y())));
+
+    // Not a real parent, the dialog outlives it.
+    parent.reset();
+    flushDeferredDeletes();
+    QVERIFY(!dialog.isNull());
+    dialog->hide();
+    QTRY_COMPARE(m_pool->availableCount(), 1);
+}
+
+QTEST_MAIN(tst_DialogPool)
+
+#include "tst_dialogpool.moc"
@@ -0,0 +1,175 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <FramelessHelper/Core/private/hittestengine_p.h>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_HitTestEngine : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void zones_data();
+    void zones();
+    void notResizable();
+    void smallWindow();
+    void unchangedGeometry();
+    void cursorShapeForEdges_data();
+    void cursorShapeForEdges();
+    void benchmarkEdgesAt();
+    void benchmarkSetGeometry();
+
+private:
+    [[nodiscard]] static HitTestEngine::Geometry defaultGeometry()
+    {
+        HitTestEngine::Geometry geometry = {};
+        geometry.windowSize = QSize(800, 600);
+        geometry.horizontalBorderThickness = 8;
+        geometry.verticalBorderThickness = 8;
+        geometry.cornerExtent = 16;
+        geometry.resizable = true;
+        return geometry;
+    }
+};
+
+void tst_HitTestEngine::zones_data()
+{
+    QTest::addColumn<QPoint>("pos");
+    QTest::addColumn<int>("edges");
+    QTest::addColumn<Qt::CursorShape>("cursor");
+
+    QTest::newRow("client") << QPoint(400, 300) << int(Qt::Edges{}) << Qt::ArrowCursor;
+    QTest::newRow("top-left") << QPoint(0, 0) << int(Qt::TopEdge | Qt::LeftEdge) << Qt::SizeFDiagCursor;
+    QTest::newRow("top-right") << QPoint(799, 0) << int(Qt::TopEdge | Qt::RightEdge) << Qt::SizeBDiagCursor;
+    QTest::newRow("bottom-left") << QPoint(0, 599) << int(Qt::BottomEdge | Qt::LeftEdge) << Qt::SizeBDiagCursor;
+    QTest::newRow("bottom-right") << QPoint(799, 599) << int(Qt::BottomEdge | Qt::RightEdge) << Qt::SizeFDiagCursor;
+    QTest::newRow("top") << QPoint(400, 0) << int(Qt::Edges(Qt::TopEdge)) << Qt::SizeVerCursor;
+    QTest::newRow("bottom") << QPoint(400, 595) << int(Qt::Edges(Qt::BottomEdge)) << Qt::SizeVerCursor;
+    QTest::newRow("left") << QPoint(0, 300) << int(Qt::Edges(Qt::LeftEdge)) << Qt::SizeHorCursor;
+    QTest::newRow("right") << QPoint(795, 300) << int(Qt::Edges(Qt::RightEdge)) << Qt::SizeHorCursor;
+    // The corner extent makes the corners wider than the vertical borders.
+    QTest::newRow("corner-extent") << QPoint(12, 2) << int(Qt::TopEdge | Qt::LeftEdge) << Qt::SizeFDiagCursor;
+    QTest::newRow("beside-left-edge") << QPoint(12, 300) << int(Qt::Edges{}) << Qt::ArrowCursor;
+    QTest::newRow("first-client-pixel") << QPoint(8, 8) << int(Qt::Edges{}) << Qt::ArrowCursor;
+    QTest::newRow("last-client-pixel") << QPoint(791, 591) << int(Qt::Edges{}) << Qt::ArrowCursor;
+}
+
+void tst_HitTestEngine::zones()
+{
+    QFETCH(QPoint, pos);
+    QFETCH(int, edges);
+    QFETCH(Qt::CursorShape, cursor);
+
+    HitTestEngine engine = {};
+    QVERIFY(engine.setGeometry(defaultGeometry()));
+    QCOMPARE(int(engine.edgesAt(pos)), edges);
+    QCOMPARE(engine.cursorShapeAt(pos), cursor);
+}
+
+void tst_HitTestEngine::notResizable()
+{
+    HitTestEngine::Geometry geometry = defaultGeometry();
+    geometry.resizable = false;
+    HitTestEngine engine = {};
+    QVERIFY(engine.setGeometry(geometry));
+    QCOMPARE(engine.edgesAt(QPoint(0, 0)), Qt::Edges{});
+    QCOMPARE(engine.edgesAt(QPoint(799, 599)), Qt::Edges{});
+    QCOMPARE(engine.cursorShapeAt(QPoint(400, 0)), Qt::ArrowCursor);
+}
+
+void tst_HitTestEngine::smallWindow()
+{
+    // The window is smaller than two borders, the far edge wins.
+    HitTestEngine::Geometry geometry = defaultGeometry();
+    geometry.windowSize = QSize(10, 10);
+    geometry.cornerExtent = 0;
+    HitTestEngine engine = {};
+    QVERIFY(engine.setGeometry(geometry));
+    QCOMPARE(engine.edgesAt(QPoint(0, 0)), (Qt::TopEdge | Qt::LeftEdge));
+    QCOMPARE(engine.edgesAt(QPoint(9, 9)), (Qt::BottomEdge | Qt::RightEdge));
+}
+
+void tst_HitTestEngine::unchangedGeometry()
+{
+    HitTestEngine engine = {};
+    QVERIFY(engine.setGeometry(defaultGeometry()));
+    QVERIFY(!engine.setGeometry(defaultGeometry()));
+    QCOMPARE(engine.geometry(), defaultGeometry());
+}
+
+void tst_HitTestEngine::cursorShapeForEdges_data()
+{
+    QTest::addColumn<int>("edges");
+    QTest::addColumn<Qt::CursorShape>("cursor");
+
+    QTest::newRow("none") << int(Qt::Edges{}) << Qt::ArrowCursor;
+    QTest::newRow("top") << int(Qt::Edges(Qt::TopEdge)) << Qt::SizeVerCursor;
+    QTest::newRow("left") << int(Qt::Edges(Qt::LeftEdge)) << Qt::SizeHorCursor;
+    QTest::newRow("top-left") << int(Qt::TopEdge | Qt::LeftEdge) << Qt::SizeFDiagCursor;
+    QTest::newRow("top-right") << int(Qt::TopEdge | Qt::RightEdge) << Qt::SizeBDiagCursor;
+    QTest::newRow("bottom-left") << int(Qt::BottomEdge | Qt::LeftEdge) << Qt::SizeBDiagCursor;
+    QTest::newRow("bottom-right") << int(Qt::BottomEdge | Qt::RightEdge) << Qt::SizeFDiagCursor;
+}
+
+void tst_HitTestEngine::cursorShapeForEdges()
+{
+    QFETCH(int, edges);
+    QFETCH(Qt::CursorShape, cursor);
+
+    QCOMPARE(HitTestEngine::cursorShapeForEdges(Qt::Edges(edges)), cursor);
+}
+
+void tst_HitTestEngine::benchmarkEdgesAt()
+{
+    HitTestEngine engine = {};
+    engine.setGeometry(defaultGeometry());
+    int hits = 0;
+    QBENCHMARK {
+        for (int y = 0; y < 600; y += 7) {
+            for (int x = 0; x < 800; x += 7) {
+                if (engine.edgesAt(QPoint(x, y)) != Qt::Edges{}) {
+                    ++hits;
+                }
+            }
+        }
+    }
+    QVERIFY(hits > 0);
+}
+
+void tst_HitTestEngine::benchmarkSetGeometry()
+{
+    HitTestEngine engine = {};
+    HitTestEngine::Geometry geometry = defaultGeometry();
+    QBENCHMARK {
+        // Simulates an interactive resize, the zone table is rebuilt every time.
+        geometry.windowSize.rwidth() = ((geometry.windowSize.width() % 1000) + 1);
+        engine.setGeometry(geometry);
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_HitTestEngine)
+
+#include "tst_hittestengine.moc"
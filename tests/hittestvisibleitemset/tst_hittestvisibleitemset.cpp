@@ -0,0 +1,173 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtQuick/qquickitem.h>
+#include <FramelessHelper/Quick/private/hittestvisibleitemset_p.h>
+#include <memory>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_HitTestVisibleItemSet : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void followsTheAncestors();
+    void hiddenWhenInserted();
+    void doubleInsert();
+    void removed();
+    void destroyed();
+
+private:
+    // root -> container -> item, the effective state doesn't need a window.
+    std::unique_ptr<QQuickItem> m_root = nullptr;
+    QQuickItem *m_container = nullptr;
+    QQuickItem *m_item = nullptr;
+    std::unique_ptr<HitTestVisibleItemSet> m_set = nullptr;
+};
+
+void tst_HitTestVisibleItemSet::init()
+{
+    m_root = std::make_unique<QQuickItem>();
+    m_container = new QQuickItem(m_root.get());
+    m_item = new QQuickItem(m_container);
+    m_set = std::make_unique<HitTestVisibleItemSet>();
+}
+
+void tst_HitTestVisibleItemSet::cleanup()
+{
+    m_set.reset();
+    m_root.reset();
+    m_container = nullptr;
+    m_item = nullptr;
+}
+
+void tst_HitTestVisibleItemSet::followsTheAncestors()
+{
+    m_set->insert(m_item);
+    QVERIFY(m_set->activeItems().contains(m_item));
+
+    // The item itself doesn't change, only its effective state does.
+    m_container->setVisible(false);
+    QVERIFY(!m_set->activeItems().contains(m_item));
+    m_container->setVisible(true);
+    QVERIFY(m_set->activeItems().contains(m_item));
+
+    m_root->setEnabled(false);
+    QVERIFY(!m_set->activeItems().contains(m_item));
+    m_root->setEnabled(true);
+    QVERIFY(m_set->activeItems().contains(m_item));
+
+    // Still disabled by the container while the root gets enabled again.
+    m_container->setEnabled(false);
+    m_root->setEnabled(false);
+    m_root->setEnabled(true);
+    QVERIFY(!m_set->activeItems().contains(m_item));
+    m_container->setEnabled(true);
+    QVERIFY(m_set->activeItems().contains(m_item));
+
+    // Disabled while hidden, it must not come back when shown again.
+    m_container->setVisible(false);
+    m_item->setEnabled(false);
+    m_container->setVisible(true);
+    QVERIFY(!m_set->activeItems().contains(m_item));
+}
+
+void tst_HitTestVisibleItemSet::hiddenWhenInserted()
+{
+    m_container->setVisible(false);
+    m_set->insert(m_item);
+    QVERIFY(m_set->activeItems().isEmpty());
+    m_container->setVisible(true);
+    QVERIFY(m_set->activeItems().contains(m_item));
+}
+
+void tst_HitTestVisibleItemSet::doubleInsert()
+{
+    m_set->insert(m_item);
+    m_set->insert(m_item);
+    QCOMPARE(m_set->activeItems().size(), 1);
+    // Registered once, so a single removal is enough.
+    m_set->remove(m_item);
+    QVERIFY(m_set->activeItems().isEmpty());
+    m_container->setVisible(false);
+    m_container->setVisible(true);
+    QVERIFY(m_set->activeItems().isEmpty());
+}
+
+void tst_HitTestVisibleItemSet::removed()
+{
+    QQuickItem * const other = new QQuickItem(m_container);
+    m_set->insert(m_item);
+    m_set->insert(other);
+    QCOMPARE(m_set->activeItems().size(), 2);
+
+    m_set->remove(m_item);
+    QCOMPARE(m_set->activeItems().size(), 1);
+    QVERIFY(m_set->activeItems().contains(other));
+    // Its change notifications are not watched anymore.
+    m_container->setVisible(false);
+    m_container->setVisible(true);
+    QCOMPARE(m_set->activeItems().size(), 1);
+    QVERIFY(!m_set->activeItems().contains(m_item));
+
+    // Removing an item which is not in the set does nothing.
+    m_set->remove(m_item);
+    QCOMPARE(m_set->activeItems().size(), 1);
+
+    // And it can be added back.
+    m_set->insert(m_item);
+    QCOMPARE(m_set->activeItems().size(), 2);
+}
+
+void tst_HitTestVisibleItemSet::destroyed()
+{
+    QQuickItem * const other = new QQuickItem(m_container);
+    m_set->insert(m_item);
+    m_set->insert(other);
+    QCOMPARE(m_set->activeItems().size(), 2);
+
+    delete m_item;
+    m_item = nullptr;
+    QCOMPARE(m_set->activeItems().size(), 1);
+    QVERIFY(m_set->activeItems().contains(other));
+
+    // Children are destroyed together with their ancestors.
+    delete m_container;
+    m_container = nullptr;
+    QVERIFY(m_set->activeItems().isEmpty());
+
+    // New ones are not tracked until they are inserted.
+    QQuickItem * const item = new QQuickItem(m_root.get());
+    QVERIFY(m_set->activeItems().isEmpty());
+    m_set->insert(item);
+    QCOMPARE(m_set->activeItems().size(), 1);
+}
+
+QTEST_MAIN(tst_HitTestVisibleItemSet)
+
+#include "tst_hittestvisibleitemset.moc"
@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtWidgets/qwidget.h>
+#include <FramelessHelper/Widgets/private/hittestvisiblewidgetset_p.h>
+#include <memory>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_HitTestVisibleWidgetSet : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void followsTheAncestors();
+    void hiddenWhenInserted();
+    void doubleInsert();
+    void removed();
+    void destroyed();
+
+private:
+    // window -> container -> widget
+    std::unique_ptr<QWidget> m_window = nullptr;
+    QWidget *m_container = nullptr;
+    QWidget *m_widget = nullptr;
+    std::unique_ptr<HitTestVisibleWidgetSet> m_set = nullptr;
+};
+
+void tst_HitTestVisibleWidgetSet::init()
+{
+    m_window = std::make_unique<QWidget>();
+    m_container = new QWidget(m_window.get());
+    m_widget = new QWidget(m_container);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window.get()));
+    m_set = std::make_unique<HitTestVisibleWidgetSet>();
+}
+
+void tst_HitTestVisibleWidgetSet::cleanup()
+{
+    m_set.reset();
+    m_window.reset();
+    m_container = nullptr;
+    m_widget = nullptr;
+}
+
+void tst_HitTestVisibleWidgetSet::followsTheAncestors()
+{
+    m_set->insert(m_widget);
+    QVERIFY(m_set->activeWidgets().contains(m_widget));
+
+    // The widget itself doesn't change, only its effective state does.
+    m_container->hide();
+    QVERIFY(!m_set->activeWidgets().contains(m_widget));
+    m_container->show();
+    QVERIFY(m_set->activeWidgets().contains(m_widget));
+
+    m_window->setEnabled(false);
+    QVERIFY(!m_set->activeWidgets().contains(m_widget));
+    m_window->setEnabled(true);
+    QVERIFY(m_set->activeWidgets().contains(m_widget));
+
+    // Still disabled by the container while the window gets enabled again.
+    m_container->setEnabled(false);
+    m_window->setEnabled(false);
+    m_window->setEnabled(true);
+    QVERIFY(!m_set->activeWidgets().contains(m_widget));
+    m_container->setEnabled(true);
+    QVERIFY(m_set->activeWidgets().contains(m_widget));
+
+    // Disabled while hidden, it must not come back when shown again.
+    m_container->hide();
+    m_widget->setEnabled(false);
+    m_container->show();
+    QVERIFY(!m_set->activeWidgets().contains(m_widget));
+}
+
+void tst_HitTestVisibleWidgetSet::hiddenWhenInserted()
+{
+    m_container->hide();
+    m_set->insert(m_widget);
+    QVERIFY(m_set->activeWidgets().isEmpty());
+    m_container->show();
+    QVERIFY(m_set->activeWidgets().contains(m_widget));
+}
+
+void tst_HitTestVisibleWidgetSet::doubleInsert()
+{
+    m_set->insert(m_widget);
+    m_set->insert(m_widget);
+    QCOMPARE(m_set->activeWidgets().size(), 1);
+    // Registered once, so a single removal is enough.
+    m_set->remove(m_widget);
+    QVERIFY(m_set->activeWidgets().isEmpty());
+    m_container->hide();
+    m_container->show();
+    QVERIFY(m_set->activeWidgets().isEmpty());
+}
+
+void tst_HitTestVisibleWidgetSet::removed()
+{
+    const auto other = new QWidget(m_container);
+    other->show();
+    m_set->insert(m_widget);
+    m_set->insert(other);
+    QCOMPARE(m_set->activeWidgets().size(), 2);
+
+    m_set->remove(m_widget);
+    QCOMPARE(m_set->activeWidgets().size(), 1);
+    QVERIFY(m_set->activeWidgets().contains(other));
+    // Its events are not watched anymore.
+    m_container->hide();
+    m_container->show();
+    QCOMPARE(m_set->activeWidgets().size(), 1);
+    QVERIFY(!m_set->activeWidgets().contains(m_widget));
+
+    // Removing a widget which is not in the set does nothing.
+    m_set->remove(m_widget);
+    QCOMPARE(m_set->activeWidgets().size(), 1);
+
+    // And it can be added back.
+    m_set->insert(m_widget);
+    QCOMPARE(m_set->activeWidgets().size(), 2);
+}
+
+void tst_HitTestVisibleWidgetSet::destroyed()
+{
+    const auto other = new QWidget(m_container);
+    other->show();
+    m_set->insert(m_widget);
+    m_set->insert(other);
+    QCOMPARE(m_set->activeWidgets().size(), 2);
+
+    delete m_widget;
+    m_widget = nullptr;
+    QCOMPARE(m_set->activeWidgets().size(), 1);
+    QVERIFY(m_set->activeWidgets().contains(other));
+
+    // Children are destroyed together with their ancestors.
+    delete m_container;
+    m_container = nullptr;
+    QVERIFY(m_set->activeWidgets().isEmpty());
+
+    // New ones are not tracked until they are inserted.
+    const auto widget = new QWidget(m_window.get());
+    widget->show();
+    QVERIFY(m_set->activeWidgets().isEmpty());
+    m_set->insert(widget);
+    QCOMPARE(m_set->activeWidgets().size(), 1);
+}
+
+QTEST_MAIN(tst_HitTestVisibleWidgetSet)
+
+#include "tst_hittestvisiblewidgetset.moc"
@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtGui/qwindow.h>
+#include <FramelessHelper/Core/private/framelessconfig_p.h>
+#include <FramelessHelper/Widgets/framelesswidget.h>
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <memory>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using namespace Global;
+
+// A 1000Hz mouse delivers about 16 moves per frame of a 60Hz display.
+static constexpr const int kMovesPerFrame = 16;
+
+class tst_MouseMoveCompression : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void finalPositionWins();
+    void benchmarkHover_data();
+    void benchmarkHover();
+
+private:
+    // Sweeps from the center of the window to the given position, one frame worth of moves.
+    void replayFrame(const QPoint &target);
+
+private:
+    std::unique_ptr<FramelessWidget> m_widget = nullptr;
+};
+
+void tst_MouseMoveCompression::init()
+{
+    m_widget = std::make_unique<FramelessWidget>();
+    m_widget->resize(800, 600);
+    FramelessWidgetsHelper::get(m_widget.get())->waitForReady();
+    m_widget->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_widget.get()));
+}
+
+void tst_MouseMoveCompression::cleanup()
+{
+    m_widget.reset();
+    FramelessConfig::instance()->set(Option::EnableMouseMoveCompression, false);
+}
+
+void tst_MouseMoveCompression::replayFrame(const QPoint &target)
+{
+    QWindow * const window = m_widget->windowHandle();
+    const QPoint center = QRect(QPoint(0, 0), window->size()).center();
+    for (int i = 1; i <= kMovesPerFrame; ++i) {
+        QTest::mouseMove(window, (center + ((target - center) * i / kMovesPerFrame)));
+    }
+}
+
+void tst_MouseMoveCompression::finalPositionWins()
+{
+    const QPoint edge = { (m_widget->width() - 1), (m_widget->height() / 2) };
+
+    // What the uncompressed event filter ends up with.
+    replayFrame(edge);
+    QCoreApplication::processEvents();
+    const Qt::CursorShape expected = m_widget->cursor().shape();
+    replayFrame(QRect(QPoint(0, 0), m_widget->size()).center());
+    QCoreApplication::processEvents();
+
+    // The compressed one may skip the intermediate positions, but never the last one.
+    FramelessConfig::instance()->set(Option::EnableMouseMoveCompression);
+    replayFrame(edge);
+    QTRY_COMPARE(m_widget->cursor().shape(), expected);
+}
+
+void tst_MouseMoveCompression::benchmarkHover_data()
+{
+    QTest::addColumn<bool>("compression");
+
+    QTest::newRow("uncompressed") << false;
+    QTest::newRow("compressed") << true;
+}
+
+void tst_MouseMoveCompression::benchmarkHover()
+{
+    QFETCH(bool, compression);
+
+    FramelessConfig::instance()->set(Option::EnableMouseMoveCompression, compression);
+    const QPoint edge = { (m_widget->width() - 1), (m_widget->height() / 2) };
+    const QPoint corner = { (m_widget->width() - 1), (m_widget->height() - 1) };
+    bool toEdge = true;
+    QBENCHMARK {
+        replayFrame(toEdge ? edge : corner);
+        // The event loop gets to run once per frame, like it would while painting.
+        QCoreApplication::processEvents();
+        toEdge = !toEdge;
+    }
+}
+
+QTEST_MAIN(tst_MouseMoveCompression)
+
+#include "tst_mousemovecompression.moc"
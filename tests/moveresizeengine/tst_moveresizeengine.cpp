@@ -0,0 +1,213 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <QtGui/qwindow.h>
+#include <QtGui/qevent.h>
+#include <FramelessHelper/Core/private/moveresizeengine_p.h>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+// Drives the engine from the mouse events it receives, the same way the library
+// does when the system can't move or resize the window for us.
+class DragWindow : public QWindow
+{
+public:
+    explicit DragWindow(const Qt::Edges edges) : QWindow(), m_edges(edges) {}
+    ~DragWindow() override = default;
+
+    [[nodiscard]] MoveResizeEngine *engine() { return &m_engine; }
+
+protected:
+    void mousePressEvent(QMouseEvent *event) override
+    {
+        m_engine.start(this, m_edges, globalPos(event));
+    }
+
+    void mouseMoveEvent(QMouseEvent *event) override
+    {
+        m_engine.update(globalPos(event));
+    }
+
+    void mouseReleaseEvent(QMouseEvent *event) override
+    {
+        m_engine.finish(globalPos(event));
+    }
+
+private:
+    [[nodiscard]] static QPoint globalPos(const QMouseEvent *event)
+    {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+        return event->globalPosition().toPoint();
+#else
+        return event->globalPos();
+#endif
+    }
+
+private:
+    Qt::Edges m_edges = {};
+    MoveResizeEngine m_engine;
+};
+
+class tst_MoveResizeEngine : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void calculateGeometry_data();
+    void calculateGeometry();
+    void syntheticMove();
+    void syntheticResize();
+    void cancel();
+
+private:
+    static void drag(QWindow *window, const QPoint &globalFrom, const QPoint &globalTo, const int steps);
+};
+
+void tst_MoveResizeEngine::calculateGeometry_data()
+{
+    QTest::addColumn<int>("edges");
+    QTest::addColumn<QPoint>("delta");
+    QTest::addColumn<QSize>("minimumSize");
+    QTest::addColumn<QSize>("maximumSize");
+    QTest::addColumn<bool>("snap");
+    QTest::addColumn<QRect>("expected");
+
+    const QSize noLimit = {};
+    const int move = 0;
+    const int left = int(Qt::LeftEdge);
+    const int right = int(Qt::RightEdge);
+    const int top = int(Qt::TopEdge);
+    const int bottomRight = int(Qt::BottomEdge | Qt::RightEdge);
+
+    // The start geometry is always QRect(100, 100, 300, 200) on a 1920x1080 screen.
+    QTest::newRow("move") << move << QPoint(50, 30) << noLimit << noLimit << true << QRect(150, 130, 300, 200);
+    QTest::newRow("move-snap-left") << move << QPoint(-95, 0) << noLimit << noLimit << true << QRect(0, 100, 300, 200);
+    QTest::newRow("move-snap-right") << move << QPoint(1515, 0) << noLimit << noLimit << true << QRect(1620, 100, 300, 200);
+    QTest::newRow("move-no-snap") << move << QPoint(-95, 0) << noLimit << noLimit << false << QRect(5, 100, 300, 200);
+    QTest::newRow("resize-right") << right << QPoint(100, 50) << noLimit << noLimit << true << QRect(100, 100, 400, 200);
+    QTest::newRow("resize-left") << left << QPoint(-20, 50) << noLimit << noLimit << true << QRect(80, 100, 320, 200);
+    QTest::newRow("resize-top-snap") << top << QPoint(0, -95) << noLimit << noLimit << true << QRect(100, 0, 300, 300);
+    // The edge opposite to the dragged one must stay where it was.
+    QTest::newRow("resize-left-minimum") << left << QPoint(250, 0) << QSize(200, 150) << noLimit << true << QRect(200, 100, 200, 200);
+    QTest::newRow("resize-bottom-right-maximum") << bottomRight << QPoint(200, 200) << noLimit << QSize(350, 250) << true << QRect(100, 100, 350, 250);
+    QTest::newRow("resize-collapse") << right << QPoint(-1000, 0) << noLimit << noLimit << false << QRect(100, 100, 1, 200);
+}
+
+void tst_MoveResizeEngine::calculateGeometry()
+{
+    QFETCH(int, edges);
+    QFETCH(QPoint, delta);
+    QFETCH(QSize, minimumSize);
+    QFETCH(QSize, maximumSize);
+    QFETCH(bool, snap);
+    QFETCH(QRect, expected);
+
+    MoveResizeEngine::Constraints constraints = {};
+    constraints.minimumSize = minimumSize;
+    constraints.maximumSize = maximumSize;
+    if (snap) {
+        constraints.availableGeometry = QRect(0, 0, 1920, 1080);
+        constraints.snapDistance = 10;
+    }
+    const QRect result = MoveResizeEngine::calculateGeometry(QRect(100, 100, 300, 200), Qt::Edges(edges), delta, constraints);
+    QCOMPARE(result, expected);
+}
+
+void tst_MoveResizeEngine::drag(QWindow *window, const QPoint &globalFrom, const QPoint &globalTo, const int steps)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(steps > 0);
+    // The window may move while we are dragging, always map from the current position.
+    QTest::mousePress(window, Qt::LeftButton, {}, window->mapFromGlobal(globalFrom));
+    for (int step = 1; step <= steps; ++step) {
+        const QPoint pos = (globalFrom + ((globalTo - globalFrom) * step / steps));
+        QTest::mouseMove(window, window->mapFromGlobal(pos));
+    }
+    QTest::mouseRelease(window, Qt::LeftButton, {}, window->mapFromGlobal(globalTo));
+}
+
+void tst_MoveResizeEngine::syntheticMove()
+{
+    DragWindow window({});
+    window.setGeometry(QRect(100, 100, 300, 200));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const QRect startGeometry = window.geometry();
+    QSignalSpy xSpy(&window, &QWindow::xChanged);
+
+    constexpr const int kSteps = 20;
+    const QPoint from = startGeometry.center();
+    drag(&window, from, (from + QPoint(50, 30)), kSteps);
+
+    QVERIFY(!window.engine()->isActive());
+    QTRY_COMPARE(window.position(), (startGeometry.topLeft() + QPoint(50, 30)));
+    QCOMPARE(window.size(), startGeometry.size());
+    // The moves are coalesced, one geometry change per display frame at most.
+    QVERIFY(xSpy.count() >= 1);
+    QVERIFY(xSpy.count() < kSteps);
+}
+
+void tst_MoveResizeEngine::syntheticResize()
+{
+    DragWindow window(Qt::BottomEdge | Qt::RightEdge);
+    window.setMinimumSize(QSize(250, 150));
+    window.setGeometry(QRect(100, 100, 300, 200));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const QRect startGeometry = window.geometry();
+
+    const QPoint from = (startGeometry.topLeft() + QPoint(startGeometry.width() - 1, startGeometry.height() - 1));
+    drag(&window, from, (from - QPoint(100, 100)), 10);
+
+    QVERIFY(!window.engine()->isActive());
+    // The anchor is the top left corner, and the minimum size is honoured.
+    QTRY_COMPARE(window.size(), QSize(250, 150));
+    QCOMPARE(window.position(), startGeometry.topLeft());
+}
+
+void tst_MoveResizeEngine::cancel()
+{
+    DragWindow window({});
+    window.setGeometry(QRect(100, 100, 300, 200));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    const QRect startGeometry = window.geometry();
+
+    const QPoint from = startGeometry.center();
+    QTest::mousePress(&window, Qt::LeftButton, {}, window.mapFromGlobal(from));
+    QVERIFY(window.engine()->isActive());
+    QTest::mouseMove(&window, window.mapFromGlobal(from + QPoint(40, 40)));
+    window.engine()->cancel();
+    QVERIFY(!window.engine()->isActive());
+    QTRY_COMPARE(window.geometry(), startGeometry);
+    // The engine is no longer active, the release must be ignored.
+    QTest::mouseRelease(&window, Qt::LeftButton, {}, window.mapFromGlobal(from + QPoint(40, 40)));
+    QCOMPARE(window.geometry(), startGeometry);
+}
+
+QTEST_MAIN(tst_MoveResizeEngine)
+
+#include "tst_moveresizeengine.moc"
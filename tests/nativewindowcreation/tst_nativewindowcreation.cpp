@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qwindow.h>
+#include <QtWidgets/qwidget.h>
+#include <FramelessHelper/Core/utils.h>
+#include <FramelessHelper/Widgets/framelesswidget.h>
+#include <FramelessHelper/Widgets/framelessmainwindow.h>
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <memory>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+// Counts the platform windows created and destroyed in the whole application.
+class SurfaceCounter : public QObject
+{
+public:
+    explicit SurfaceCounter(QObject *parent = nullptr) : QObject(parent) {}
+    ~SurfaceCounter() override = default;
+
+    [[nodiscard]] int created() const { return m_created; }
+    [[nodiscard]] int destroyed() const { return m_destroyed; }
+
+protected:
+    bool eventFilter(QObject *object, QEvent *event) override
+    {
+        if (object->isWindowType() && (event->type() == QEvent::PlatformSurface)) {
+            switch (static_cast<QPlatformSurfaceEvent *>(event)->surfaceEventType()) {
+            case QPlatformSurfaceEvent::SurfaceCreated:
+                ++m_created;
+                break;
+            case QPlatformSurfaceEvent::SurfaceAboutToBeDestroyed:
+                ++m_destroyed;
+                break;
+            }
+        }
+        return QObject::eventFilter(object, event);
+    }
+
+private:
+    int m_created = 0;
+    int m_destroyed = 0;
+};
+
+class tst_NativeWindowCreation : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void createdOnce_data();
+    void createdOnce();
+
+private:
+    std::unique_ptr<SurfaceCounter> m_counter = nullptr;
+};
+
+void tst_NativeWindowCreation::init()
+{
+    m_counter = std::make_unique<SurfaceCounter>();
+    qApp->installEventFilter(m_counter.get());
+}
+
+void tst_NativeWindowCreation::cleanup()
+{
+    qApp->removeEventFilter(m_counter.get());
+    m_counter.reset();
+}
+
+void tst_NativeWindowCreation::createdOnce_data()
+{
+    QTest::addColumn<int>("kind");
+
+    QTest::newRow("FramelessWidget") << 0;
+    QTest::newRow("FramelessMainWindow") << 1;
+    QTest::newRow("FramelessWidgetsHelper") << 2;
+}
+
+void tst_NativeWindowCreation::createdOnce()
+{
+    QFETCH(int, kind);
+
+    std::unique_ptr<QWidget> widget = nullptr;
+    switch (kind) {
+    case 0:
+        widget = std::make_unique<FramelessWidget>();
+        break;
+    case 1:
+        widget = std::make_unique<FramelessMainWindow>();
+        break;
+    default:
+        widget = std::make_unique<QWidget>();
+        FramelessWidgetsHelper::get(widget.get())->extendsContentIntoTitleBar();
+        break;
+    }
+    widget->resize(400, 300);
+    FramelessWidgetsHelper::get(widget.get())->waitForReady();
+    widget->show();
+    QVERIFY(QTest::qWaitForWindowExposed(widget.get()));
+    QCoreApplication::processEvents();
+
+    // Setting the frameless flag on a live window would destroy and re-create it.
+    QCOMPARE(m_counter->created(), 1);
+    QCOMPARE(m_counter->destroyed(), 0);
+    if (Utils::shouldApplyFramelessWindowHint()) {
+        QVERIFY(widget->windowFlags().testFlag(Qt::FramelessWindowHint));
+    }
+}
+
+QTEST_MAIN(tst_NativeWindowCreation)
+
+#include "tst_nativewindowcreation.moc"
@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgrendererinterface.h>
+#include <FramelessHelper/Core/micamaterial.h>
+#include <FramelessHelper/Quick/quickmicamaterial.h>
+#include <FramelessHelper/Quick/private/quickmicamaterial_p.h>
+#include <FramelessHelper/Quick/private/quickdecorationtexturecache_p.h>
+#include <memory>
+#include <vector>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const int kWindowCount = 5;
+// The blurred wallpaper and the material tile. The wallpaper may or may not be
+// available on the test machine, and it may show up while the test is running.
+static constexpr const quint64 kMaximumContents = 2;
+
+class tst_QuickDecorationTextureCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void uploadsDontScaleWithWindows();
+    void moveDoesNotUpload();
+    void releasedWithTheLastWindow();
+
+private:
+    [[nodiscard]] QQuickWindow *createWindow();
+    [[nodiscard]] static bool waitForFrame(QQuickWindow *window);
+
+private:
+    std::vector<std::unique_ptr<QQuickWindow>> m_windows = {};
+};
+
+void tst_QuickDecorationTextureCache::initTestCase()
+{
+    // Same as QT_QUICK_BACKEND=software, must happen before any window is created.
+    QQuickWindow::setSceneGraphBackend(FRAMELESSHELPER_STRING_LITERAL("software"));
+}
+
+void tst_QuickDecorationTextureCache::init()
+{
+    QuickDecorationTextureCache::resetStatistics();
+}
+
+void tst_QuickDecorationTextureCache::cleanup()
+{
+    m_windows.clear();
+}
+
+QQuickWindow *tst_QuickDecorationTextureCache::createWindow()
+{
+    auto window = std::make_unique<QQuickWindow>();
+    window->resize(400, 300);
+    const auto material = new QuickMicaMaterial(window->contentItem());
+    material->setSize(QSizeF(window->size()));
+    // Always use the material tile, no matter whether the window is active or not.
+    material->setFallbackEnabled(false);
+    // Don't let a slow test machine switch to another tier half way.
+    QuickMicaMaterialPrivate::get(material)->micaMaterial->setAdaptiveQualityEnabled(false);
+    m_windows.push_back(std::move(window));
+    return m_windows.back().get();
+}
+
+bool tst_QuickDecorationTextureCache::waitForFrame(QQuickWindow *window)
+{
+    QSignalSpy spy(window, &QQuickWindow::frameSwapped);
+    if (window->isVisible()) {
+        window->update();
+    } else {
+        window->show();
+        if (!QTest::qWaitForWindowExposed(window)) {
+            return false;
+        }
+    }
+    return (spy.count() > 0) || spy.wait();
+}
+
+void tst_QuickDecorationTextureCache::uploadsDontScaleWithWindows()
+{
+    QQuickWindow * const first = createWindow();
+    QVERIFY(waitForFrame(first));
+    QCOMPARE(first->rendererInterface()->graphicsApi(), QSGRendererInterface::Software);
+    const QuickDecorationTextureCache::Statistics single = QuickDecorationTextureCache::statistics();
+    QVERIFY(single.uploads >= 1);
+    QVERIFY(single.uploads <= kMaximumContents);
+
+    for (int index = 1; index != kWindowCount; ++index) {
+        QVERIFY(waitForFrame(createWindow()));
+    }
+    const QuickDecorationTextureCache::Statistics multiple = QuickDecorationTextureCache::statistics();
+    // All the software renderers share the same textures.
+    QVERIFY(multiple.uploads <= kMaximumContents);
+    QVERIFY(multiple.textures <= int(kMaximumContents));
+    QVERIFY(multiple.hits >= quint64(kWindowCount - 1));
+}
+
+void tst_QuickDecorationTextureCache::moveDoesNotUpload()
+{
+    QQuickWindow * const window = createWindow();
+    QVERIFY(waitForFrame(window));
+    // Let a wallpaper which is still being generated settle first.
+    QTest::qWait(200);
+    QVERIFY(waitForFrame(window));
+    const QuickDecorationTextureCache::Statistics before = QuickDecorationTextureCache::statistics();
+    for (int index = 0; index != 10; ++index) {
+        window->setPosition(window->position() + QPoint{ 10, 10 });
+        QVERIFY(waitForFrame(window));
+    }
+    const QuickDecorationTextureCache::Statistics after = QuickDecorationTextureCache::statistics();
+    QCOMPARE(after.uploads, before.uploads);
+    QCOMPARE(after.textures, before.textures);
+}
+
+void tst_QuickDecorationTextureCache::releasedWithTheLastWindow()
+{
+    for (int index = 0; index != kWindowCount; ++index) {
+        QVERIFY(waitForFrame(createWindow()));
+    }
+    QVERIFY(QuickDecorationTextureCache::statistics().textures > 0);
+    m_windows.pop_back();
+    QVERIFY(QuickDecorationTextureCache::statistics().textures > 0);
+    m_windows.clear();
+    QTRY_COMPARE(QuickDecorationTextureCache::statistics().textures, 0);
+}
+
+QTEST_MAIN(tst_QuickDecorationTextureCache)
+
+#include "tst_quickdecorationtexturecache.moc"
@@ -0,0 +1,159 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <QtWidgets/qwidget.h>
+#include <FramelessHelper/Core/framelessmanager.h>
+#include <FramelessHelper/Core/micamaterial.h>
+#include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using namespace Global;
+
+static constexpr const int kWindowCount = 5;
+
+class MicaWidget : public QWidget
+{
+public:
+    explicit MicaWidget(QWidget *parent = nullptr) : QWidget(parent)
+    {
+        connect(&m_material, &MicaMaterial::shouldRedraw, this, qOverload<>(&MicaWidget::update));
+    }
+    ~MicaWidget() override = default;
+
+    [[nodiscard]] int paintCount() const { return m_paintCount; }
+    void resetPaintCount() { m_paintCount = 0; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override
+    {
+        Q_UNUSED(event);
+        ++m_paintCount;
+    }
+
+private:
+    MicaMaterial m_material;
+    int m_paintCount = 0;
+};
+
+class tst_ThemeChange : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanupTestCase();
+    void brushSharedBetweenMaterials();
+    void brushCacheKeyedByParameters();
+    void repaintOncePerWindow();
+};
+
+void tst_ThemeChange::init()
+{
+    FramelessManager::instance()->setOverrideTheme(SystemTheme::Light);
+}
+
+void tst_ThemeChange::cleanupTestCase()
+{
+    FramelessManager::instance()->setOverrideTheme(SystemTheme::Unknown);
+}
+
+void tst_ThemeChange::brushSharedBetweenMaterials()
+{
+    std::vector<std::unique_ptr<MicaMaterial>> materials = {};
+    std::vector<std::unique_ptr<QSignalSpy>> spies = {};
+    for (int i = 0; i != kWindowCount; ++i) {
+        materials.push_back(std::make_unique<MicaMaterial>());
+        spies.push_back(std::make_unique<QSignalSpy>(materials.back().get(), &MicaMaterial::shouldRedraw));
+    }
+    const MicaMaterialPrivate::BrushCacheStatistics before = MicaMaterialPrivate::brushCacheStatistics();
+
+    FramelessManager::instance()->setOverrideTheme(SystemTheme::Dark);
+
+    const MicaMaterialPrivate::BrushCacheStatistics after = MicaMaterialPrivate::brushCacheStatistics();
+    // The texture is generated at most once, all the other materials reuse it.
+    QVERIFY((after.builds - before.builds) <= 1);
+    QCOMPARE(((after.builds - before.builds) + (after.hits - before.hits)), quint64(kWindowCount));
+    // And every material asks for exactly one redraw.
+    for (auto &&spy : std::as_const(spies)) {
+        QCOMPARE(spy->count(), 1);
+    }
+}
+
+void tst_ThemeChange::brushCacheKeyedByParameters()
+{
+    MicaMaterial plain;
+    MicaMaterial tinted;
+    tinted.setTintColor(Qt::red);
+    // Visit both themes once so that all the textures exist.
+    FramelessManager::instance()->setOverrideTheme(SystemTheme::Dark);
+    FramelessManager::instance()->setOverrideTheme(SystemTheme::Light);
+    const MicaMaterialPrivate::BrushCacheStatistics before = MicaMaterialPrivate::brushCacheStatistics();
+    QVERIFY(before.textures >= 4);
+
+    // Materials with different parameters must not evict each other's texture.
+    for (int i = 0; i != 3; ++i) {
+        FramelessManager::instance()->setOverrideTheme(SystemTheme::Dark);
+        FramelessManager::instance()->setOverrideTheme(SystemTheme::Light);
+    }
+
+    const MicaMaterialPrivate::BrushCacheStatistics after = MicaMaterialPrivate::brushCacheStatistics();
+    QCOMPARE(after.builds, before.builds);
+    QCOMPARE((after.hits - before.hits), quint64(12));
+}
+
+void tst_ThemeChange::repaintOncePerWindow()
+{
+    std::vector<std::unique_ptr<MicaWidget>> widgets = {};
+    for (int i = 0; i != kWindowCount; ++i) {
+        auto widget = std::make_unique<MicaWidget>();
+        widget->resize(200, 100);
+        widget->show();
+        QVERIFY(QTest::qWaitForWindowExposed(widget.get()));
+        widgets.push_back(std::move(widget));
+    }
+    QTRY_VERIFY(std::all_of(widgets.cbegin(), widgets.cend(), [](const auto &widget){ return (widget->paintCount() > 0); }));
+    QTest::qWait(50);
+    for (auto &&widget : std::as_const(widgets)) {
+        widget->resetPaintCount();
+    }
+
+    FramelessManager::instance()->setOverrideTheme(SystemTheme::Dark);
+
+    QTRY_VERIFY(std::all_of(widgets.cbegin(), widgets.cend(), [](const auto &widget){ return (widget->paintCount() > 0); }));
+    // Give the event loop a chance to deliver any redundant repaint.
+    QTest::qWait(50);
+    for (auto &&widget : std::as_const(widgets)) {
+        QCOMPARE(widget->paintCount(), 1);
+    }
+}
+
+QTEST_MAIN(tst_ThemeChange)
+
+#include "tst_themechange.moc"
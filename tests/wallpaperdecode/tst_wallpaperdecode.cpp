@@ -0,0 +1,196 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtCore/qtemporarydir.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qimagereader.h>
+#include <QtGui/qimagewriter.h>
+#include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <utility>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using namespace Global;
+
+class tst_WallpaperDecode : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void plan_data();
+    void plan();
+    void roundTrip_data();
+    void roundTrip();
+
+private:
+    // Smooth enough to survive the JPEG compression, like a real wallpaper after the blur.
+    [[nodiscard]] static QImage createPicture(const QSize &size);
+    // The average and the largest difference of all the color channels.
+    [[nodiscard]] static std::pair<qreal, int> compare(const QImage &lhs, const QImage &rhs);
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+QImage tst_WallpaperDecode::createPicture(const QSize &size)
+{
+    QImage image(size, QImage::Format_RGB32);
+    const int width = size.width();
+    const int height = size.height();
+    for (int y = 0; y != height; ++y) {
+        auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x != width; ++x) {
+            line[x] = qRgb((x * 255 / width), (y * 255 / height), ((x + y) * 255 / (width + height)));
+        }
+    }
+    return image;
+}
+
+std::pair<qreal, int> tst_WallpaperDecode::compare(const QImage &lhs, const QImage &rhs)
+{
+    Q_ASSERT(lhs.size() == rhs.size());
+    const QImage left = lhs.convertToFormat(QImage::Format_RGB32);
+    const QImage right = rhs.convertToFormat(QImage::Format_RGB32);
+    quint64 sum = 0;
+    int maximum = 0;
+    for (int y = 0; y != left.height(); ++y) {
+        const auto leftLine = reinterpret_cast<const QRgb *>(left.constScanLine(y));
+        const auto rightLine = reinterpret_cast<const QRgb *>(right.constScanLine(y));
+        for (int x = 0; x != left.width(); ++x) {
+            const std::array<int, 3> diff = {
+                std::abs(qRed(leftLine[x]) - qRed(rightLine[x])),
+                std::abs(qGreen(leftLine[x]) - qGreen(rightLine[x])),
+                std::abs(qBlue(leftLine[x]) - qBlue(rightLine[x]))
+            };
+            sum += quint64(diff[0] + diff[1] + diff[2]);
+            maximum = std::max({ maximum, diff[0], diff[1], diff[2] });
+        }
+    }
+    const qreal count = (qreal(left.width()) * qreal(left.height()) * qreal(3));
+    return std::make_pair(qreal(sum) / count, maximum);
+}
+
+void tst_WallpaperDecode::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+void tst_WallpaperDecode::plan_data()
+{
+    QTest::addColumn<QSize>("pictureSize");
+    QTest::addColumn<QByteArray>("format");
+    QTest::addColumn<int>("aspectStyle");
+    QTest::addColumn<QSize>("screenSize");
+    QTest::addColumn<QSize>("displaySize");
+    QTest::addColumn<QSize>("decodeSize");
+
+    const int fill = int(WallpaperAspectStyle::Fill);
+    const int fit = int(WallpaperAspectStyle::Fit);
+    const int stretch = int(WallpaperAspectStyle::Stretch);
+    const int center = int(WallpaperAspectStyle::Center);
+    const QSize fullHD = { 1920, 1080 };
+
+    // One decoded pixel may cover 8 screen pixels.
+    QTest::newRow("png-fill") << QSize(3840, 2160) << QByteArray("png") << fill << fullHD << fullHD << QSize(240, 135);
+    QTest::newRow("png-stretch") << QSize(3840, 2160) << QByteArray("png") << stretch << fullHD << fullHD << QSize(240, 135);
+    QTest::newRow("png-fit") << QSize(4096, 2048) << QByteArray("png") << fit << fullHD << QSize(1920, 960) << QSize(240, 120);
+    QTest::newRow("png-center-small") << QSize(16, 16) << QByteArray("png") << center << fullHD << QSize(16, 16) << QSize(2, 2);
+    // JPEG pictures are snapped to the scales libjpeg produces natively.
+    QTest::newRow("jpeg-fill") << QSize(3840, 2160) << QByteArray("jpeg") << fill << fullHD << fullHD << QSize(480, 270);
+    QTest::newRow("jpg-fill") << QSize(3840, 2160) << QByteArray("jpg") << fill << fullHD << fullHD << QSize(480, 270);
+    QTest::newRow("jpeg-fill-upscaled") << QSize(1000, 600) << QByteArray("jpeg") << fill << fullHD << QSize(1920, 1152) << QSize(250, 150);
+    QTest::newRow("jpeg-rounded-up") << QSize(3841, 2161) << QByteArray("jpeg") << stretch << fullHD << fullHD << QSize(481, 271);
+}
+
+void tst_WallpaperDecode::plan()
+{
+    QFETCH(QSize, pictureSize);
+    QFETCH(QByteArray, format);
+    QFETCH(int, aspectStyle);
+    QFETCH(QSize, screenSize);
+    QFETCH(QSize, displaySize);
+    QFETCH(QSize, decodeSize);
+
+    const MicaMaterialPrivate::WallpaperDecodePlan plan = MicaMaterialPrivate::planWallpaperDecode(
+        pictureSize, format, WallpaperAspectStyle(aspectStyle), screenSize);
+    QCOMPARE(plan.displaySize, displaySize);
+    QCOMPARE(plan.decodeSize, decodeSize);
+}
+
+void tst_WallpaperDecode::roundTrip_data()
+{
+    QTest::addColumn<QByteArray>("format");
+    QTest::addColumn<int>("aspectStyle");
+
+    QTest::newRow("png-fill") << QByteArray("png") << int(WallpaperAspectStyle::Fill);
+    QTest::newRow("png-fit") << QByteArray("png") << int(WallpaperAspectStyle::Fit);
+    QTest::newRow("jpeg-fill") << QByteArray("jpeg") << int(WallpaperAspectStyle::Fill);
+    QTest::newRow("jpeg-stretch") << QByteArray("jpeg") << int(WallpaperAspectStyle::Stretch);
+}
+
+void tst_WallpaperDecode::roundTrip()
+{
+    QFETCH(QByteArray, format);
+    QFETCH(int, aspectStyle);
+
+    if (!QImageWriter::supportedImageFormats().contains(format)) {
+        QSKIP("The image format plugin is not available.");
+    }
+    const QSize pictureSize = { 2400, 1600 };
+    const QSize screenSize = { 1200, 800 };
+    const QString filePath = m_tempDir.filePath(FRAMELESSHELPER_STRING_LITERAL("wallpaper.") + QString::fromLatin1(format));
+    {
+        QImageWriter writer(filePath, format);
+        writer.setQuality(90);
+        QVERIFY2(writer.write(createPicture(pictureSize)), qPrintable(writer.errorString()));
+    }
+
+    // The reader must really decode at the planned resolution.
+    QImageReader reader(filePath);
+    const MicaMaterialPrivate::WallpaperDecodePlan plan = MicaMaterialPrivate::planWallpaperDecode(
+        reader.size(), reader.format(), WallpaperAspectStyle(aspectStyle), screenSize);
+    QVERIFY(plan.decodeSize.width() < pictureSize.width());
+    reader.setScaledSize(plan.decodeSize);
+    QCOMPARE(reader.read().size(), plan.decodeSize);
+
+    const QImage decoded = MicaMaterialPrivate::decodeWallpaper(filePath, WallpaperAspectStyle(aspectStyle), screenSize);
+    QVERIFY(!decoded.isNull());
+    QCOMPARE(decoded.size(), plan.displaySize);
+
+    // Compare with what the full size decode would have given us.
+    const QImage reference = QImage(filePath).scaled(plan.displaySize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    const auto [average, maximum] = compare(decoded, reference);
+    qDebug() << format << "average difference:" << average << "largest difference:" << maximum;
+    QVERIFY(average < qreal(2));
+    QVERIFY(maximum < 24);
+}
+
+QTEST_MAIN(tst_WallpaperDecode)
+
+#include "tst_wallpaperdecode.moc"
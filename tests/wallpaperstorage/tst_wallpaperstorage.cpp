@@ -0,0 +1,244 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpainter.h>
+#include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <utility>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using namespace Global;
+
+class tst_WallpaperStorage : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void memory_data();
+    void memory();
+    void quality_data();
+    void quality();
+    void draw_data();
+    void draw();
+    void benchmarkDraw_data();
+    void benchmarkDraw();
+
+private:
+    struct Difference
+    {
+        // Signed average of each color channel, the dither must not shift the colors.
+        std::array<qreal, 3> bias = {};
+        qreal average = 0.0;
+        int maximum = 0;
+    };
+
+    // A blurred wallpaper is nothing but slow gradients, the worst case for banding.
+    [[nodiscard]] static QImage createPicture(const QSize &size);
+    [[nodiscard]] static Difference compare(const QImage &actual, const QImage &expected);
+    [[nodiscard]] static QImage paint(const WallpaperStorage &storage, const QSize &size, const QPoint &target, const QRect &source);
+
+private:
+    QImage m_picture = {};
+};
+
+QImage tst_WallpaperStorage::createPicture(const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    const int width = size.width();
+    const int height = size.height();
+    for (int y = 0; y != height; ++y) {
+        auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x != width; ++x) {
+            line[x] = qRgb((x * 255 / width), (y * 255 / height), (((x + y) * 255) / (width + height)));
+        }
+    }
+    return image;
+}
+
+tst_WallpaperStorage::Difference tst_WallpaperStorage::compare(const QImage &actual, const QImage &expected)
+{
+    Q_ASSERT(actual.size() == expected.size());
+    const QImage left = actual.convertToFormat(QImage::Format_RGB32);
+    const QImage right = expected.convertToFormat(QImage::Format_RGB32);
+    std::array<qint64, 3> signedSum = {};
+    quint64 sum = 0;
+    Difference result = {};
+    for (int y = 0; y != left.height(); ++y) {
+        const auto leftLine = reinterpret_cast<const QRgb *>(left.constScanLine(y));
+        const auto rightLine = reinterpret_cast<const QRgb *>(right.constScanLine(y));
+        for (int x = 0; x != left.width(); ++x) {
+            const std::array<int, 3> diff = {
+                (qRed(leftLine[x]) - qRed(rightLine[x])),
+                (qGreen(leftLine[x]) - qGreen(rightLine[x])),
+                (qBlue(leftLine[x]) - qBlue(rightLine[x]))
+            };
+            for (std::size_t channel = 0; channel != diff.size(); ++channel) {
+                signedSum.at(channel) += diff.at(channel);
+                sum += quint64(std::abs(diff.at(channel)));
+                result.maximum = std::max(result.maximum, std::abs(diff.at(channel)));
+            }
+        }
+    }
+    const qreal count = (qreal(left.width()) * qreal(left.height()));
+    for (std::size_t channel = 0; channel != signedSum.size(); ++channel) {
+        result.bias.at(channel) = (qreal(signedSum.at(channel)) / count);
+    }
+    result.average = (qreal(sum) / (count * qreal(3)));
+    return result;
+}
+
+QImage tst_WallpaperStorage::paint(const WallpaperStorage &storage, const QSize &size, const QPoint &target, const QRect &source)
+{
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(Qt::black);
+    QPainter painter(&image);
+    storage.draw(&painter, target, source);
+    painter.end();
+    return image;
+}
+
+void tst_WallpaperStorage::initTestCase()
+{
+    // The size the wallpaper ends up with on a 1080p screen, the scan lines need no padding.
+    m_picture = createPicture(QSize(480, 270));
+}
+
+void tst_WallpaperStorage::memory_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<qreal>("ratio");
+
+    QTest::newRow("argb32") << int(WallpaperStorageFormat::Argb32) << qreal(1);
+    QTest::newRow("rgb888") << int(WallpaperStorageFormat::Rgb888) << qreal(0.75);
+    QTest::newRow("rgb16") << int(WallpaperStorageFormat::Rgb16) << qreal(0.5);
+    QTest::newRow("ycbcr420") << int(WallpaperStorageFormat::YCbCr420) << qreal(0.375);
+}
+
+void tst_WallpaperStorage::memory()
+{
+    QFETCH(int, format);
+    QFETCH(qreal, ratio);
+
+    const WallpaperStorage storage = WallpaperStorage::pack(m_picture, WallpaperStorageFormat(format));
+    QVERIFY(!storage.isNull());
+    QCOMPARE(storage.size(), m_picture.size());
+    QCOMPARE(storage.format(), WallpaperStorageFormat(format));
+    const qsizetype reference = qsizetype(m_picture.sizeInBytes());
+    qDebug() << WallpaperStorageFormat(format) << "uses" << storage.byteCount() << "bytes, ARGB32 uses" << reference;
+    QCOMPARE(storage.byteCount(), qsizetype(qreal(reference) * ratio));
+}
+
+void tst_WallpaperStorage::quality_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<qreal>("maximumAverage");
+    QTest::addColumn<int>("maximumDifference");
+
+    QTest::newRow("argb32") << int(WallpaperStorageFormat::Argb32) << qreal(0) << 0;
+    QTest::newRow("rgb888") << int(WallpaperStorageFormat::Rgb888) << qreal(0) << 0;
+    // Half a 5-bit step of dither plus half a step of quantization.
+    QTest::newRow("rgb16") << int(WallpaperStorageFormat::Rgb16) << qreal(3) << 10;
+    QTest::newRow("ycbcr420") << int(WallpaperStorageFormat::YCbCr420) << qreal(1) << 4;
+}
+
+void tst_WallpaperStorage::quality()
+{
+    QFETCH(int, format);
+    QFETCH(qreal, maximumAverage);
+    QFETCH(int, maximumDifference);
+
+    const WallpaperStorage storage = WallpaperStorage::pack(m_picture, WallpaperStorageFormat(format));
+    const QImage unpacked = storage.toImage();
+    QCOMPARE(unpacked.size(), m_picture.size());
+    const Difference difference = compare(unpacked, m_picture);
+    qDebug() << WallpaperStorageFormat(format) << "average difference:" << difference.average
+             << "largest difference:" << difference.maximum << "bias:" << difference.bias[0]
+             << difference.bias[1] << difference.bias[2];
+    QVERIFY(difference.average <= maximumAverage);
+    QVERIFY(difference.maximum <= maximumDifference);
+    for (const qreal bias : std::as_const(difference.bias)) {
+        QVERIFY(std::abs(bias) < qreal(0.5));
+    }
+}
+
+void tst_WallpaperStorage::draw_data()
+{
+    QTest::addColumn<int>("format");
+
+    QTest::newRow("argb32") << int(WallpaperStorageFormat::Argb32);
+    QTest::newRow("rgb888") << int(WallpaperStorageFormat::Rgb888);
+    QTest::newRow("rgb16") << int(WallpaperStorageFormat::Rgb16);
+    QTest::newRow("ycbcr420") << int(WallpaperStorageFormat::YCbCr420);
+}
+
+void tst_WallpaperStorage::draw()
+{
+    QFETCH(int, format);
+
+    const WallpaperStorage storage = WallpaperStorage::pack(m_picture, WallpaperStorageFormat(format));
+    const QImage unpacked = storage.toImage().convertToFormat(QImage::Format_RGB32);
+
+    // The whole wallpaper first, so that the scratch buffer is as large as it gets.
+    QCOMPARE(paint(storage, m_picture.size(), QPoint(0, 0), QRect(QPoint(0, 0), m_picture.size())), unpacked);
+
+    // Then a smaller window somewhere in the middle, it must not see stale scratch pixels.
+    const QRect source = { 101, 37, 200, 150 };
+    const QImage partial = paint(storage, source.size(), QPoint(0, 0), source);
+    QCOMPARE(partial, unpacked.copy(source));
+
+    // A window hanging over the bottom right corner only gets the part that exists.
+    const QRect overhang = { 400, 200, 160, 120 };
+    const QImage clipped = paint(storage, overhang.size(), QPoint(0, 0), overhang);
+    const QRect inside = overhang.intersected(QRect(QPoint(0, 0), m_picture.size()));
+    QCOMPARE(clipped.copy(QRect(QPoint(0, 0), inside.size())), unpacked.copy(inside));
+    QCOMPARE(clipped.pixel(overhang.width() - 1, overhang.height() - 1), qRgb(0, 0, 0));
+}
+
+void tst_WallpaperStorage::benchmarkDraw_data()
+{
+    draw_data();
+}
+
+void tst_WallpaperStorage::benchmarkDraw()
+{
+    QFETCH(int, format);
+
+    const WallpaperStorage storage = WallpaperStorage::pack(m_picture, WallpaperStorageFormat(format));
+    QImage image(m_picture.size(), QImage::Format_RGB32);
+    QPainter painter(&image);
+    const QRect source = { QPoint(0, 0), m_picture.size() };
+    QBENCHMARK {
+        storage.draw(&painter, QPoint(0, 0), source);
+    }
+}
+
+QTEST_MAIN(tst_WallpaperStorage)
+
+#include "tst_wallpaperstorage.moc"
@@ -0,0 +1,119 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtGui/qimage.h>
+#include <FramelessHelper/Core/private/windowshadow_p.h>
+#include <array>
+#include <thread>
+#include <utility>
+#include <vector>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_WindowShadow : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void textureIsShared();
+    void cacheIsBounded();
+    void concurrentLookups();
+
+private:
+    // Every alpha value gives a distinct cache entry.
+    [[nodiscard]] static WindowShadow::Parameters parameters(const int alpha);
+};
+
+WindowShadow::Parameters tst_WindowShadow::parameters(const int alpha)
+{
+    WindowShadow::Parameters params = {};
+    params.blurRadius = 16;
+    params.offset = QPoint(0, 2);
+    params.color = QColor(0, 0, 0, alpha);
+    params.cornerRadius = 8;
+    params.devicePixelRatio = 1;
+    return params;
+}
+
+void tst_WindowShadow::textureIsShared()
+{
+    const QImage first = WindowShadow::texture(parameters(90));
+    QVERIFY(!first.isNull());
+    const QImage second = WindowShadow::texture(parameters(90));
+    // The very same image, not just an equal one.
+    QCOMPARE(second.cacheKey(), first.cacheKey());
+    QVERIFY(WindowShadow::texture(parameters(45)).cacheKey() != first.cacheKey());
+}
+
+void tst_WindowShadow::cacheIsBounded()
+{
+    const QImage first = WindowShadow::texture(parameters(1));
+    QVERIFY(!first.isNull());
+    // Far more parameter sets than any application would use at the same time.
+    for (int alpha = 2; alpha != 64; ++alpha) {
+        QVERIFY(!WindowShadow::texture(parameters(alpha)).isNull());
+    }
+    // Evicted and rendered again, we still hold the old image so the keys differ.
+    const QImage again = WindowShadow::texture(parameters(1));
+    QVERIFY(again.cacheKey() != first.cacheKey());
+    QCOMPARE(again, first);
+    // The recently used ones survive.
+    const QImage recent = WindowShadow::texture(parameters(63));
+    QCOMPARE(WindowShadow::texture(parameters(63)).cacheKey(), recent.cacheKey());
+}
+
+void tst_WindowShadow::concurrentLookups()
+{
+    static constexpr const int kThreadCount = 4;
+    static constexpr const int kIterationCount = 200;
+    // More parameter sets than the cache can hold, so the threads evict each other.
+    static constexpr const int kParameterCount = 12;
+    std::array<QImage, kParameterCount> expected = {};
+    for (int i = 0; i != kParameterCount; ++i) {
+        expected.at(i) = WindowShadow::texture(parameters(100 + i)).copy();
+    }
+    std::array<int, kThreadCount> mismatches = {};
+    std::vector<std::thread> threads = {};
+    for (int t = 0; t != kThreadCount; ++t) {
+        threads.emplace_back([t, &expected, &mismatches](){
+            for (int i = 0; i != kIterationCount; ++i) {
+                const int index = ((i + (t * 3)) % kParameterCount);
+                if (WindowShadow::texture(parameters(100 + index)) != expected.at(index)) {
+                    ++mismatches.at(t);
+                }
+            }
+        });
+    }
+    for (auto &&thread : threads) {
+        thread.join();
+    }
+    for (auto &&count : std::as_const(mismatches)) {
+        QCOMPARE(count, 0);
+    }
+}
+
+QTEST_MAIN(tst_WindowShadow)
+
+#include "tst_windowshadow.moc"
@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <FramelessHelper/Widgets/framelesswidget.h>
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <memory>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_WindowStateSignals : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void transitions_data();
+    void transitions();
+    void showAndHide();
+
+private:
+    std::unique_ptr<FramelessWidget> m_widget = nullptr;
+};
+
+void tst_WindowStateSignals::init()
+{
+    m_widget = std::make_unique<FramelessWidget>();
+    m_widget->resize(400, 300);
+    FramelessWidgetsHelper::get(m_widget.get())->waitForReady();
+}
+
+void tst_WindowStateSignals::cleanup()
+{
+    m_widget.reset();
+}
+
+void tst_WindowStateSignals::transitions_data()
+{
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("to");
+    QTest::addColumn<int>("hiddenChanged");
+    QTest::addColumn<int>("normalChanged");
+    QTest::addColumn<int>("zoomedChanged");
+
+    const int normal = int(Qt::WindowNoState);
+    const int maximized = int(Qt::WindowMaximized);
+    const int fullScreen = int(Qt::WindowFullScreen);
+    const int minimized = int(Qt::WindowMinimized);
+
+    // Every notification re-evaluates the bindings depending on it, so a property
+    // which didn't change must not be announced, and one that did exactly once.
+    QTest::newRow("normal-maximized") << normal << maximized << 0 << 1 << 1;
+    QTest::newRow("maximized-normal") << maximized << normal << 0 << 1 << 1;
+    QTest::newRow("normal-fullscreen") << normal << fullScreen << 0 << 1 << 1;
+    QTest::newRow("maximized-fullscreen") << maximized << fullScreen << 0 << 0 << 0;
+    QTest::newRow("fullscreen-maximized") << fullScreen << maximized << 0 << 0 << 0;
+    QTest::newRow("normal-minimized") << normal << minimized << 0 << 1 << 0;
+    QTest::newRow("minimized-normal") << minimized << normal << 0 << 1 << 0;
+    QTest::newRow("normal-normal") << normal << normal << 0 << 0 << 0;
+}
+
+void tst_WindowStateSignals::transitions()
+{
+    QFETCH(int, from);
+    QFETCH(int, to);
+    QFETCH(int, hiddenChanged);
+    QFETCH(int, normalChanged);
+    QFETCH(int, zoomedChanged);
+
+    m_widget->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_widget.get()));
+    m_widget->setWindowState(Qt::WindowState(from));
+    QCoreApplication::processEvents();
+
+    QSignalSpy hiddenSpy(m_widget.get(), &FramelessWidget::hiddenChanged);
+    QSignalSpy normalSpy(m_widget.get(), &FramelessWidget::normalChanged);
+    QSignalSpy zoomedSpy(m_widget.get(), &FramelessWidget::zoomedChanged);
+    m_widget->setWindowState(Qt::WindowState(to));
+    QCoreApplication::processEvents();
+    QCOMPARE(hiddenSpy.count(), hiddenChanged);
+    QCOMPARE(normalSpy.count(), normalChanged);
+    QCOMPARE(zoomedSpy.count(), zoomedChanged);
+}
+
+void tst_WindowStateSignals::showAndHide()
+{
+    QSignalSpy hiddenSpy(m_widget.get(), &FramelessWidget::hiddenChanged);
+    QSignalSpy normalSpy(m_widget.get(), &FramelessWidget::normalChanged);
+    QSignalSpy zoomedSpy(m_widget.get(), &FramelessWidget::zoomedChanged);
+
+    m_widget->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_widget.get()));
+    QCOMPARE(hiddenSpy.count(), 1);
+    m_widget->hide();
+    QCoreApplication::processEvents();
+    QCOMPARE(hiddenSpy.count(), 2);
+    // Showing and hiding leaves the window state alone.
+    QCOMPARE(normalSpy.count(), 0);
+    QCOMPARE(zoomedSpy.count(), 0);
+
+    // Toggling back and forth announces each change once per direction.
+    m_widget->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_widget.get()));
+    hiddenSpy.clear();
+    for (int i = 0; i != 3; ++i) {
+        m_widget->toggleMaximized();
+        QCoreApplication::processEvents();
+    }
+    QCOMPARE(hiddenSpy.count(), 0);
+    QCOMPARE(normalSpy.count(), 3);
+    QCOMPARE(zoomedSpy.count(), 3);
+}
+
+QTEST_MAIN(tst_WindowStateSignals)
+
+#include "tst_windowstatesignals.moc"
@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <QtTest/qtest.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
+#include <FramelessHelper/Core/windowstatestore.h>
+#include <FramelessHelper/Core/private/windowstatestore_p.h>
+#include <optional>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_WindowStateStore : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void serialization();
+    void corruptedData();
+    void roundTrip();
+    void flushWaitsForTheWrite();
+    void corruptedFile();
+
+private:
+    [[nodiscard]] static WindowStateRecord createRecord(const int seed);
+    [[nodiscard]] static bool isSameRecord(const WindowStateRecord &lhs, const WindowStateRecord &rhs);
+    [[nodiscard]] static std::optional<WindowStateRecords> readFile(const QString &filePath);
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+WindowStateRecord tst_WindowStateStore::createRecord(const int seed)
+{
+    WindowStateRecord record = {};
+    record.normalGeometry = { (100 + seed), (50 + seed), 800, 600 };
+    record.state = (((seed % 2) == 0) ? Qt::WindowNoState : Qt::WindowMaximized);
+    record.screenName = FRAMELESSHELPER_STRING_LITERAL("Screen %1").arg(seed % 3);
+    record.screenGeometry = { (1920 * (seed % 3)), 0, 1920, 1080 };
+    return record;
+}
+
+bool tst_WindowStateStore::isSameRecord(const WindowStateRecord &lhs, const WindowStateRecord &rhs)
+{
+    return ((lhs.normalGeometry == rhs.normalGeometry) && (lhs.state == rhs.state)
+        && (lhs.screenName == rhs.screenName) && (lhs.screenGeometry == rhs.screenGeometry));
+}
+
+std::optional<WindowStateRecords> tst_WindowStateStore::readFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly)) {
+        return std::nullopt;
+    }
+    return WindowStateStorePrivate::deserialize(file.readAll());
+}
+
+void tst_WindowStateStore::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+void tst_WindowStateStore::serialization()
+{
+    WindowStateRecords records = {};
+    for (int i = 0; i != 8; ++i) {
+        records.insert(FRAMELESSHELPER_STRING_LITERAL("window-%1").arg(i), createRecord(i));
+    }
+    const std::optional<WindowStateRecords> result = WindowStateStorePrivate::deserialize(
+        WindowStateStorePrivate::serialize(records));
+    QVERIFY(result.has_value());
+    QCOMPARE(result->size(), records.size());
+    for (auto it = records.cbegin(); it != records.cend(); ++it) {
+        QVERIFY(result->contains(it.key()));
+        QVERIFY(isSameRecord(result->value(it.key()), it.value()));
+    }
+}
+
+void tst_WindowStateStore::corruptedData()
+{
+    WindowStateRecords records = {};
+    records.insert(FRAMELESSHELPER_STRING_LITERAL("window"), createRecord(1));
+    const QByteArray data = WindowStateStorePrivate::serialize(records);
+    QVERIFY(!WindowStateStorePrivate::deserialize({}).has_value());
+    QVERIFY(!WindowStateStorePrivate::deserialize(data.left(data.size() - 1)).has_value());
+    QByteArray badMagic = data;
+    badMagic[0] = char(~badMagic.at(0));
+    QVERIFY(!WindowStateStorePrivate::deserialize(badMagic).has_value());
+}
+
+void tst_WindowStateStore::roundTrip()
+{
+    const QString filePath = m_tempDir.filePath(FRAMELESSHELPER_STRING_LITERAL("nested/roundtrip.windowstate"));
+    const QString id = FRAMELESSHELPER_STRING_LITERAL("main");
+    const WindowStateRecord record = createRecord(3);
+    {
+        WindowStateStore store;
+        store.setFilePath(filePath);
+        QVERIFY(!store.contains(id));
+        WindowStateStorePrivate * const d = WindowStateStorePrivate::get(&store);
+        d->records.insert(id, record);
+        d->dirty = true;
+        // Destroying the store writes everything out.
+    }
+    QVERIFY(QFile::exists(filePath));
+
+    WindowStateStore store;
+    store.setFilePath(filePath);
+    QVERIFY(store.contains(id));
+    QVERIFY(isSameRecord(WindowStateStorePrivate::get(&store)->records.value(id), record));
+
+    // Removing it is persisted as well.
+    store.remove(id);
+    store.flush();
+    const std::optional<WindowStateRecords> records = readFile(filePath);
+    QVERIFY(records.has_value());
+    QVERIFY(!records->contains(id));
+}
+
+void tst_WindowStateStore::flushWaitsForTheWrite()
+{
+    const QString filePath = m_tempDir.filePath(FRAMELESSHELPER_STRING_LITERAL("flush.windowstate"));
+    const QString id = FRAMELESSHELPER_STRING_LITERAL("main");
+    WindowStateStore store;
+    store.setFilePath(filePath);
+    WindowStateStorePrivate * const d = WindowStateStorePrivate::get(&store);
+    // Each save() hands a snapshot to the background task, the flush right after it
+    // must never return before that very snapshot is on the disk.
+    for (int i = 0; i != 200; ++i) {
+        const WindowStateRecord record = createRecord(i);
+        d->records.insert(id, record);
+        d->dirty = true;
+        d->save();
+        store.flush();
+        const std::optional<WindowStateRecords> records = readFile(filePath);
+        QVERIFY2(records.has_value(), qPrintable(FRAMELESSHELPER_STRING_LITERAL("Iteration %1").arg(i)));
+        QVERIFY2(isSameRecord(records->value(id), record), qPrintable(FRAMELESSHELPER_STRING_LITERAL("Iteration %1").arg(i)));
+    }
+}
+
+void tst_WindowStateStore::corruptedFile()
+{
+    const QString filePath = m_tempDir.filePath(FRAMELESSHELPER_STRING_LITERAL("corrupted.windowstate"));
+    {
+        QFile file(filePath);
+        QVERIFY(file.open(QFile::WriteOnly));
+        QVERIFY(file.write("definitely not a window state file") > 0);
+    }
+    WindowStateStore store;
+    store.setFilePath(filePath);
+    QVERIFY(!store.contains(FRAMELESSHELPER_STRING_LITERAL("main")));
+}
+
+QTEST_MAIN(tst_WindowStateStore)
+
+#include "tst_windowstatestore.moc"